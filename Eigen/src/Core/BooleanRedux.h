@@ -66,6 +66,120 @@ struct any_unroller<Derived, Dynamic, Rows>
   static inline bool run(const Derived &) { return false; }
 };
 
+template<typename Derived, bool Vectorize = mask_evaluator<Derived>::Vectorizable
+                                          && (int(mask_evaluator<Derived>::Flags) & LinearAccessBit)>
+struct boolean_redux_impl
+{
+  typedef evaluator<Derived> Evaluator;
+
+  static EIGEN_DEVICE_FUNC inline bool all(const Derived& mat)
+  {
+    Evaluator evaluator(mat);
+    for(Index j = 0; j < mat.cols(); ++j)
+      for(Index i = 0; i < mat.rows(); ++i)
+        if (!evaluator.coeff(i, j)) return false;
+    return true;
+  }
+
+  static EIGEN_DEVICE_FUNC inline bool any(const Derived& mat)
+  {
+    Evaluator evaluator(mat);
+    for(Index j = 0; j < mat.cols(); ++j)
+      for(Index i = 0; i < mat.rows(); ++i)
+        if (evaluator.coeff(i, j)) return true;
+    return false;
+  }
+
+  static EIGEN_DEVICE_FUNC inline Index count(const Derived& mat)
+  {
+    return mat.template cast<bool>().template cast<Index>().sum();
+  }
+};
+
+// Comparisons of vectorizable expressions are reduced from their lane masks, four packets at a time.
+template<typename Derived>
+struct boolean_redux_impl<Derived, true>
+{
+  typedef mask_evaluator<Derived> Evaluator;
+  typedef typename packet_traits<typename Evaluator::Scalar>::type Packet;
+  enum {
+    PacketSize = unpacket_traits<Packet>::size,
+    BlockSize = 1 << 14
+  };
+
+  static EIGEN_DEVICE_FUNC inline bool all(const Derived& mat)
+  {
+    Evaluator evaluator(mat);
+    const Index size = mat.size();
+    Index i = 0;
+    for(; i + 4*PacketSize <= size; i += 4*PacketSize)
+    {
+      Packet m = pand(pand(evaluator.template packet<Unaligned,Packet>(i),
+                           evaluator.template packet<Unaligned,Packet>(i + PacketSize)),
+                      pand(evaluator.template packet<Unaligned,Packet>(i + 2*PacketSize),
+                           evaluator.template packet<Unaligned,Packet>(i + 3*PacketSize)));
+      if(!pmask_all(m)) return false;
+    }
+    for(; i + PacketSize <= size; i += PacketSize)
+      if(!pmask_all(evaluator.template packet<Unaligned,Packet>(i))) return false;
+    for(; i < size; ++i)
+      if(!evaluator.coeff(i)) return false;
+    return true;
+  }
+
+  static EIGEN_DEVICE_FUNC inline bool any(const Derived& mat)
+  {
+    Evaluator evaluator(mat);
+    const Index size = mat.size();
+    Index i = 0;
+    for(; i + 4*PacketSize <= size; i += 4*PacketSize)
+    {
+      Packet m = por(por(evaluator.template packet<Unaligned,Packet>(i),
+                         evaluator.template packet<Unaligned,Packet>(i + PacketSize)),
+                     por(evaluator.template packet<Unaligned,Packet>(i + 2*PacketSize),
+                         evaluator.template packet<Unaligned,Packet>(i + 3*PacketSize)));
+      if(pmask_any(m)) return true;
+    }
+    for(; i + PacketSize <= size; i += PacketSize)
+      if(pmask_any(evaluator.template packet<Unaligned,Packet>(i))) return true;
+    for(; i < size; ++i)
+      if(evaluator.coeff(i)) return true;
+    return false;
+  }
+
+  static EIGEN_DEVICE_FUNC inline Index count(const Derived& mat)
+  {
+    typedef typename Evaluator::Scalar Scalar;
+    Evaluator evaluator(mat);
+    const Index size = mat.size();
+    const Index packetEnd = (size/PacketSize)*PacketSize;
+    const Packet ones = pset1<Packet>(Scalar(1));
+    Index res = 0;
+    Index i = 0;
+    // The masks are summed as packets of ones, which are reduced every BlockSize coefficients while their lanes
+    // are still exact integers.
+    while(i < packetEnd)
+    {
+      const Index blockEnd = numext::mini<Index>(packetEnd, i + BlockSize);
+      Packet acc0 = pzero(ones), acc1 = pzero(ones);
+      for(; i + 2*PacketSize <= blockEnd; i += 2*PacketSize)
+      {
+        acc0 = padd(acc0, pand(evaluator.template packet<Unaligned,Packet>(i), ones));
+        acc1 = padd(acc1, pand(evaluator.template packet<Unaligned,Packet>(i + PacketSize), ones));
+      }
+      if(i < blockEnd)
+      {
+        acc0 = padd(acc0, pand(evaluator.template packet<Unaligned,Packet>(i), ones));
+        i += PacketSize;
+      }
+      res += Index(predux(padd(acc0, acc1)));
+    }
+    for(; i < size; ++i)
+      res += evaluator.coeff(i) ? 1 : 0;
+    return res;
+  }
+};
+
 } // end namespace internal
 
 /** \returns true if all coefficients are true
@@ -82,17 +196,15 @@ EIGEN_DEVICE_FUNC inline bool DenseBase<Derived>::all() const
   enum {
     unroll = SizeAtCompileTime != Dynamic
           && SizeAtCompileTime * (Evaluator::CoeffReadCost + NumTraits<Scalar>::AddCost) <= EIGEN_UNROLLING_LIMIT
+          && !internal::mask_evaluator<Derived>::Vectorizable
   };
-  Evaluator evaluator(derived());
   if(unroll)
-    return internal::all_unroller<Evaluator, unroll ? int(SizeAtCompileTime) : Dynamic, internal::traits<Derived>::RowsAtCompileTime>::run(evaluator);
-  else
   {
-    for(Index j = 0; j < cols(); ++j)
-      for(Index i = 0; i < rows(); ++i)
-        if (!evaluator.coeff(i, j)) return false;
-    return true;
+    Evaluator evaluator(derived());
+    return internal::all_unroller<Evaluator, unroll ? int(SizeAtCompileTime) : Dynamic, internal::traits<Derived>::RowsAtCompileTime>::run(evaluator);
   }
+  else
+    return internal::boolean_redux_impl<Derived>::all(derived());
 }
 
 /** \returns true if at least one coefficient is true
@@ -106,17 +218,15 @@ EIGEN_DEVICE_FUNC inline bool DenseBase<Derived>::any() const
   enum {
     unroll = SizeAtCompileTime != Dynamic
           && SizeAtCompileTime * (Evaluator::CoeffReadCost + NumTraits<Scalar>::AddCost) <= EIGEN_UNROLLING_LIMIT
+          && !internal::mask_evaluator<Derived>::Vectorizable
   };
-  Evaluator evaluator(derived());
   if(unroll)
-    return internal::any_unroller<Evaluator, unroll ? int(SizeAtCompileTime) : Dynamic, internal::traits<Derived>::RowsAtCompileTime>::run(evaluator);
-  else
   {
-    for(Index j = 0; j < cols(); ++j)
-      for(Index i = 0; i < rows(); ++i)
-        if (evaluator.coeff(i, j)) return true;
-    return false;
+    Evaluator evaluator(derived());
+    return internal::any_unroller<Evaluator, unroll ? int(SizeAtCompileTime) : Dynamic, internal::traits<Derived>::RowsAtCompileTime>::run(evaluator);
   }
+  else
+    return internal::boolean_redux_impl<Derived>::any(derived());
 }
 
 /** \returns the number of coefficients which evaluate to true
@@ -126,7 +236,7 @@ EIGEN_DEVICE_FUNC inline bool DenseBase<Derived>::any() const
 template<typename Derived>
 EIGEN_DEVICE_FUNC inline Eigen::Index DenseBase<Derived>::count() const
 {
-  return derived().template cast<bool>().template cast<Index>().sum();
+  return internal::boolean_redux_impl<Derived>::count(derived());
 }
 
 /** \returns true is \c *this contains at least one Not A Number (NaN).
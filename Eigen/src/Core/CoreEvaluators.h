@@ -607,6 +607,223 @@ protected:
   Data m_d;
 };
 
+// -------------------- Casts --------------------
+
+template<int Mode> struct cast_evaluator_mode {};
+
+// holds the storage of the nested expression when the cast reads it with ploadu_cast
+template<typename ArgType, bool HasData> struct cast_evaluator_data
+{
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE explicit cast_evaluator_data(const ArgType&) {}
+};
+
+template<typename ArgType> struct cast_evaluator_data<ArgType, true>
+{
+  typedef typename ArgType::Scalar Scalar;
+  enum { IsRowMajor = ArgType::IsRowMajor };
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE
+  explicit cast_evaluator_data(const ArgType& arg) : m_data(arg.data()), m_outerStride(arg.outerStride()) {}
+
+  EIGEN_STRONG_INLINE const Scalar* data(Index row, Index col) const
+  {
+    return m_data + (IsRowMajor ? row * m_outerStride + col : col * m_outerStride + row);
+  }
+
+  EIGEN_STRONG_INLINE const Scalar* data(Index index) const { return m_data + index; }
+
+protected:
+  const Scalar* m_data;
+  const Index m_outerStride;
+};
+
+// The casts are vectorized with the packet conversions of type_casting_traits from the packets of the nested
+// expression. For the source scalar types having no packet type, such as the 8 and 16 bits integers, the casts
+// of expressions stored contiguously in memory are vectorized with the converting loads of load_casting_traits.
+template<typename SrcType, typename DstType, typename ArgType>
+struct unary_evaluator<CwiseUnaryOp<scalar_cast_op<SrcType,DstType>, ArgType>, IndexBased>
+  : evaluator_base<CwiseUnaryOp<scalar_cast_op<SrcType,DstType>, ArgType> >
+{
+  typedef CwiseUnaryOp<scalar_cast_op<SrcType,DstType>, ArgType> XprType;
+  typedef typename packet_traits<SrcType>::type SrcPacket;
+  typedef typename packet_traits<DstType>::type DstPacket;
+  typedef type_casting_traits<SrcType,DstType> CastingTraits;
+
+  enum {
+    // the ways a packet of the result is computed
+    CastByCoeffs    = 0,  // from the coefficients
+    CastByLoad      = 1,  // ploadu_cast from the storage of the nested expression
+    CastOnePacket   = 2,  // pcast of one packet of the same size
+    CastHalfPacket  = 3,  // pcast of the first half of a packet twice as large
+    CastTwoPackets  = 4,  // pcast of two packets
+    CastFourPackets = 5,  // pcast of four packets
+
+    SrcPacketSize = unpacket_traits<SrcPacket>::size,
+    DstPacketSize = unpacket_traits<DstPacket>::size,
+    ArgFlags = evaluator<ArgType>::Flags,
+    IsRowMajor = (int(ArgFlags) & RowMajorBit) != 0,
+    SrcRatio = CastingTraits::SrcCoeffRatio,
+    TgtRatio = CastingTraits::TgtCoeffRatio,
+    PacketCast = bool(CastingTraits::VectorizedCast) && bool(packet_traits<SrcType>::Vectorizable)
+              && bool(packet_traits<DstType>::Vectorizable) && (int(ArgFlags) & PacketAccessBit),
+    LoadCast = bool(load_casting_traits<SrcType,DstType>::VectorizedLoad) && bool(packet_traits<DstType>::Vectorizable)
+            && int(inner_stride_at_compile_time<ArgType>::ret) == 1,
+    Mode = PacketCast && SrcRatio==1 && TgtRatio==1 && int(SrcPacketSize)==int(DstPacketSize) ? int(CastOnePacket)
+         : PacketCast && SrcRatio==1 && TgtRatio==2 && int(SrcPacketSize)==2*int(DstPacketSize) ? int(CastHalfPacket)
+         : PacketCast && SrcRatio==2 && TgtRatio==1 && int(DstPacketSize)==2*int(SrcPacketSize) ? int(CastTwoPackets)
+         : PacketCast && SrcRatio==4 && TgtRatio==1 && int(DstPacketSize)==4*int(SrcPacketSize) ? int(CastFourPackets)
+         : LoadCast ? int(CastByLoad)
+         : int(CastByCoeffs),
+
+    CoeffReadCost = evaluator<ArgType>::CoeffReadCost + functor_traits<scalar_cast_op<SrcType,DstType> >::Cost,
+
+    Flags = (ArgFlags & (HereditaryBits | LinearAccessBit)) | (Mode != CastByCoeffs ? PacketAccessBit : 0),
+    Alignment = 0
+  };
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE
+  explicit unary_evaluator(const XprType& xpr)
+    : m_argImpl(xpr.nestedExpression()), m_data(xpr.nestedExpression()), m_rows(xpr.rows()), m_cols(xpr.cols())
+  {
+    EIGEN_INTERNAL_CHECK_COST_VALUE(CoeffReadCost);
+  }
+
+  typedef typename XprType::CoeffReturnType CoeffReturnType;
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE
+  CoeffReturnType coeff(Index row, Index col) const
+  {
+    return scalar_cast_op<SrcType,DstType>()(m_argImpl.coeff(row, col));
+  }
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE
+  CoeffReturnType coeff(Index index) const
+  {
+    return scalar_cast_op<SrcType,DstType>()(m_argImpl.coeff(index));
+  }
+
+  // the packets of another size than DstPacket, which the assignment of small fixed size objects may ask for,
+  // are only converted by ploadu_cast or from the coefficients
+  template<int LoadMode, typename PacketType>
+  EIGEN_STRONG_INLINE
+  PacketType packet(Index row, Index col) const
+  {
+    return castPacket<PacketType>(row, col, cast_evaluator_mode<PacketModeFor<PacketType>::value>());
+  }
+
+  template<int LoadMode, typename PacketType>
+  EIGEN_STRONG_INLINE
+  PacketType packet(Index index) const
+  {
+    return castPacket<PacketType>(index, cast_evaluator_mode<PacketModeFor<PacketType>::value>());
+  }
+
+protected:
+  template<typename PacketType> struct PacketModeFor {
+    enum { value = is_same<PacketType,DstPacket>::value ? int(Mode) : Mode==CastByLoad ? int(CastByLoad) : int(CastByCoeffs) };
+  };
+
+  EIGEN_STRONG_INLINE SrcPacket argPacket(Index row, Index col, Index offset) const
+  {
+    return m_argImpl.template packet<Unaligned,SrcPacket>(IsRowMajor ? row : row + offset, IsRowMajor ? col + offset : col);
+  }
+
+  EIGEN_STRONG_INLINE SrcPacket argPacket(Index index, Index offset) const
+  {
+    return m_argImpl.template packet<Unaligned,SrcPacket>(index + offset);
+  }
+
+  template<typename PacketType>
+  EIGEN_STRONG_INLINE PacketType castPacket(Index row, Index col, cast_evaluator_mode<CastByCoeffs>) const
+  {
+    EIGEN_ALIGN_MAX DstType values[unpacket_traits<PacketType>::size];
+    for (Index i = 0; i < unpacket_traits<PacketType>::size; ++i)
+      values[i] = coeff(IsRowMajor ? row : row + i, IsRowMajor ? col + i : col);
+    return pload<PacketType>(values);
+  }
+
+  template<typename PacketType>
+  EIGEN_STRONG_INLINE PacketType castPacket(Index index, cast_evaluator_mode<CastByCoeffs>) const
+  {
+    EIGEN_ALIGN_MAX DstType values[unpacket_traits<PacketType>::size];
+    for (Index i = 0; i < unpacket_traits<PacketType>::size; ++i)
+      values[i] = coeff(index + i);
+    return pload<PacketType>(values);
+  }
+
+  template<typename PacketType>
+  EIGEN_STRONG_INLINE PacketType castPacket(Index row, Index col, cast_evaluator_mode<CastByLoad>) const
+  {
+    return ploadu_cast<PacketType>(m_data.data(row, col));
+  }
+
+  template<typename PacketType>
+  EIGEN_STRONG_INLINE PacketType castPacket(Index index, cast_evaluator_mode<CastByLoad>) const
+  {
+    return ploadu_cast<PacketType>(m_data.data(index));
+  }
+
+  template<typename PacketType>
+  EIGEN_STRONG_INLINE PacketType castPacket(Index row, Index col, cast_evaluator_mode<CastOnePacket>) const
+  {
+    return pcast<SrcPacket,DstPacket>(argPacket(row, col, 0));
+  }
+
+  template<typename PacketType>
+  EIGEN_STRONG_INLINE PacketType castPacket(Index index, cast_evaluator_mode<CastOnePacket>) const
+  {
+    return pcast<SrcPacket,DstPacket>(argPacket(index, 0));
+  }
+
+  // the second half of the source packet must not be read past the end of the inner vector or of the expression
+  template<typename PacketType>
+  EIGEN_STRONG_INLINE PacketType castPacket(Index row, Index col, cast_evaluator_mode<CastHalfPacket>) const
+  {
+    if ((IsRowMajor ? col : row) + SrcPacketSize <= (IsRowMajor ? m_cols.value() : m_rows.value()))
+      return pcast<SrcPacket,DstPacket>(argPacket(row, col, 0));
+    return castPacket<PacketType>(row, col, cast_evaluator_mode<CastByCoeffs>());
+  }
+
+  template<typename PacketType>
+  EIGEN_STRONG_INLINE PacketType castPacket(Index index, cast_evaluator_mode<CastHalfPacket>) const
+  {
+    if (index + SrcPacketSize <= m_rows.value() * m_cols.value())
+      return pcast<SrcPacket,DstPacket>(argPacket(index, 0));
+    return castPacket<PacketType>(index, cast_evaluator_mode<CastByCoeffs>());
+  }
+
+  template<typename PacketType>
+  EIGEN_STRONG_INLINE PacketType castPacket(Index row, Index col, cast_evaluator_mode<CastTwoPackets>) const
+  {
+    return pcast<SrcPacket,DstPacket>(argPacket(row, col, 0), argPacket(row, col, SrcPacketSize));
+  }
+
+  template<typename PacketType>
+  EIGEN_STRONG_INLINE PacketType castPacket(Index index, cast_evaluator_mode<CastTwoPackets>) const
+  {
+    return pcast<SrcPacket,DstPacket>(argPacket(index, 0), argPacket(index, SrcPacketSize));
+  }
+
+  template<typename PacketType>
+  EIGEN_STRONG_INLINE PacketType castPacket(Index row, Index col, cast_evaluator_mode<CastFourPackets>) const
+  {
+    return pcast<SrcPacket,DstPacket>(argPacket(row, col, 0), argPacket(row, col, SrcPacketSize),
+                                      argPacket(row, col, 2*SrcPacketSize), argPacket(row, col, 3*SrcPacketSize));
+  }
+
+  template<typename PacketType>
+  EIGEN_STRONG_INLINE PacketType castPacket(Index index, cast_evaluator_mode<CastFourPackets>) const
+  {
+    return pcast<SrcPacket,DstPacket>(argPacket(index, 0), argPacket(index, SrcPacketSize),
+                                      argPacket(index, 2*SrcPacketSize), argPacket(index, 3*SrcPacketSize));
+  }
+
+  evaluator<ArgType> m_argImpl;
+  const cast_evaluator_data<typename remove_all<ArgType>::type, Mode==CastByLoad> m_data;
+  const variable_if_dynamic<Index, XprType::RowsAtCompileTime> m_rows;
+  const variable_if_dynamic<Index, XprType::ColsAtCompileTime> m_cols;
+};
+
 // -------------------- CwiseTernaryOp --------------------
 
 // this is a ternary expression
@@ -1185,23 +1402,150 @@ struct block_evaluator<ArgType, BlockRows, BlockCols, InnerPanel, /* HasDirectAc
 };
 
 
+// -------------------- Comparison masks --------------------
+
+// mask_evaluator evaluates a boolean expression as lane masks of packets of mask_evaluator::Scalar, as returned
+// by the pcmp_* functions. Only the comparisons of two expressions of a scalar type supporting the packet
+// comparisons, and their combinations with && and ||, are vectorizable: the other boolean expressions are
+// evaluated coefficient-wise.
+template<typename XprType>
+struct mask_evaluator : evaluator<XprType>
+{
+  typedef typename XprType::Scalar Scalar;
+  enum {
+    Flags = evaluator<XprType>::Flags & ~PacketAccessBit,
+    Vectorizable = 0
+  };
+
+  EIGEN_DEVICE_FUNC explicit mask_evaluator(const XprType& xpr) : evaluator<XprType>(xpr) {}
+};
+
+template<typename XprType, typename LhsEvaluator, typename RhsEvaluator, typename _Scalar, bool OperandsVectorizable>
+struct binary_mask_evaluator
+{
+  typedef typename XprType::Functor BinaryOp;
+  typedef _Scalar Scalar;
+  enum {
+    LhsFlags = LhsEvaluator::Flags,
+    RhsFlags = RhsEvaluator::Flags,
+    StorageOrdersAgree = (int(LhsFlags)&RowMajorBit)==(int(RhsFlags)&RowMajorBit),
+    Vectorizable = OperandsVectorizable && StorageOrdersAgree,
+    Flags = (int(LhsFlags) & RowMajorBit)
+          | (StorageOrdersAgree ? int(LhsFlags) & int(RhsFlags) & LinearAccessBit : 0)
+          | (Vectorizable ? PacketAccessBit : 0),
+    Alignment = EIGEN_PLAIN_ENUM_MIN(LhsEvaluator::Alignment,RhsEvaluator::Alignment)
+  };
+
+  EIGEN_DEVICE_FUNC explicit binary_mask_evaluator(const XprType& xpr)
+    : m_functor(xpr.functor()), m_lhsImpl(xpr.lhs()), m_rhsImpl(xpr.rhs())
+  {}
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE
+  bool coeff(Index row, Index col) const
+  {
+    return m_functor(m_lhsImpl.coeff(row, col), m_rhsImpl.coeff(row, col));
+  }
+
+  EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE
+  bool coeff(Index index) const
+  {
+    return m_functor(m_lhsImpl.coeff(index), m_rhsImpl.coeff(index));
+  }
+
+  template<int LoadMode, typename PacketType>
+  EIGEN_STRONG_INLINE
+  PacketType packet(Index row, Index col) const
+  {
+    return m_functor.packetOp(m_lhsImpl.template packet<LoadMode,PacketType>(row, col),
+                              m_rhsImpl.template packet<LoadMode,PacketType>(row, col));
+  }
+
+  template<int LoadMode, typename PacketType>
+  EIGEN_STRONG_INLINE
+  PacketType packet(Index index) const
+  {
+    return m_functor.packetOp(m_lhsImpl.template packet<LoadMode,PacketType>(index),
+                              m_rhsImpl.template packet<LoadMode,PacketType>(index));
+  }
+
+protected:
+  const BinaryOp m_functor;
+  LhsEvaluator m_lhsImpl;
+  RhsEvaluator m_rhsImpl;
+};
+
+template<typename Scalar, ComparisonName Cmp, typename Lhs, typename Rhs>
+struct mask_evaluator<CwiseBinaryOp<scalar_cmp_op<Scalar,Scalar,Cmp>, Lhs, Rhs> >
+  : binary_mask_evaluator<CwiseBinaryOp<scalar_cmp_op<Scalar,Scalar,Cmp>, Lhs, Rhs>, evaluator<Lhs>, evaluator<Rhs>, Scalar,
+                          packet_traits<Scalar>::HasCmp && (int(evaluator<Lhs>::Flags) & int(evaluator<Rhs>::Flags) & PacketAccessBit)>
+{
+  typedef CwiseBinaryOp<scalar_cmp_op<Scalar,Scalar,Cmp>, Lhs, Rhs> XprType;
+  typedef binary_mask_evaluator<XprType, evaluator<Lhs>, evaluator<Rhs>, Scalar,
+                                packet_traits<Scalar>::HasCmp && (int(evaluator<Lhs>::Flags) & int(evaluator<Rhs>::Flags) & PacketAccessBit)> Base;
+  EIGEN_DEVICE_FUNC explicit mask_evaluator(const XprType& xpr) : Base(xpr) {}
+};
+
+// && and || of two masks of the same scalar type
+template<typename BinaryOp, typename Lhs, typename Rhs>
+struct boolean_mask_evaluator
+  : binary_mask_evaluator<CwiseBinaryOp<BinaryOp, Lhs, Rhs>,
+                          mask_evaluator<typename remove_const<Lhs>::type>, mask_evaluator<typename remove_const<Rhs>::type>,
+                          typename mask_evaluator<typename remove_const<Lhs>::type>::Scalar,
+                          mask_evaluator<typename remove_const<Lhs>::type>::Vectorizable
+                          && mask_evaluator<typename remove_const<Rhs>::type>::Vectorizable
+                          && is_same<typename mask_evaluator<typename remove_const<Lhs>::type>::Scalar,
+                                     typename mask_evaluator<typename remove_const<Rhs>::type>::Scalar>::value>
+{
+  typedef mask_evaluator<typename remove_const<Lhs>::type> LhsEvaluator;
+  typedef mask_evaluator<typename remove_const<Rhs>::type> RhsEvaluator;
+  typedef binary_mask_evaluator<CwiseBinaryOp<BinaryOp, Lhs, Rhs>, LhsEvaluator, RhsEvaluator, typename LhsEvaluator::Scalar,
+                                LhsEvaluator::Vectorizable && RhsEvaluator::Vectorizable
+                                && is_same<typename LhsEvaluator::Scalar, typename RhsEvaluator::Scalar>::value> Base;
+  EIGEN_DEVICE_FUNC explicit boolean_mask_evaluator(const CwiseBinaryOp<BinaryOp, Lhs, Rhs>& xpr) : Base(xpr) {}
+};
+
+template<typename Lhs, typename Rhs>
+struct mask_evaluator<CwiseBinaryOp<scalar_boolean_and_op, Lhs, Rhs> >
+  : boolean_mask_evaluator<scalar_boolean_and_op, Lhs, Rhs>
+{
+  typedef CwiseBinaryOp<scalar_boolean_and_op, Lhs, Rhs> XprType;
+  EIGEN_DEVICE_FUNC explicit mask_evaluator(const XprType& xpr) : boolean_mask_evaluator<scalar_boolean_and_op, Lhs, Rhs>(xpr) {}
+};
+
+template<typename Lhs, typename Rhs>
+struct mask_evaluator<CwiseBinaryOp<scalar_boolean_or_op, Lhs, Rhs> >
+  : boolean_mask_evaluator<scalar_boolean_or_op, Lhs, Rhs>
+{
+  typedef CwiseBinaryOp<scalar_boolean_or_op, Lhs, Rhs> XprType;
+  EIGEN_DEVICE_FUNC explicit mask_evaluator(const XprType& xpr) : boolean_mask_evaluator<scalar_boolean_or_op, Lhs, Rhs>(xpr) {}
+};
+
 // -------------------- Select --------------------
-// NOTE shall we introduce a ternary_evaluator?
 
-// TODO enable vectorization for Select
+// The packets of a Select are blended from the lane masks of its condition, see mask_evaluator.
 template<typename ConditionMatrixType, typename ThenMatrixType, typename ElseMatrixType>
 struct evaluator<Select<ConditionMatrixType, ThenMatrixType, ElseMatrixType> >
   : evaluator_base<Select<ConditionMatrixType, ThenMatrixType, ElseMatrixType> >
 {
   typedef Select<ConditionMatrixType, ThenMatrixType, ElseMatrixType> XprType;
+  typedef mask_evaluator<ConditionMatrixType> ConditionEvaluator;
   enum {
     CoeffReadCost = evaluator<ConditionMatrixType>::CoeffReadCost
                   + EIGEN_PLAIN_ENUM_MAX(evaluator<ThenMatrixType>::CoeffReadCost,
                                          evaluator<ElseMatrixType>::CoeffReadCost),
 
-    Flags = (unsigned int)evaluator<ThenMatrixType>::Flags & evaluator<ElseMatrixType>::Flags & HereditaryBits,
-    
-    Alignment = EIGEN_PLAIN_ENUM_MIN(evaluator<ThenMatrixType>::Alignment, evaluator<ElseMatrixType>::Alignment)
+    ThenFlags = evaluator<ThenMatrixType>::Flags,
+    ElseFlags = evaluator<ElseMatrixType>::Flags,
+    ConditionFlags = ConditionEvaluator::Flags,
+    StorageOrdersAgree = (int(ThenFlags)&RowMajorBit)==(int(ElseFlags)&RowMajorBit)
+                      && (int(ThenFlags)&RowMajorBit)==(int(ConditionFlags)&RowMajorBit),
+    Vectorizable = ConditionEvaluator::Vectorizable && is_same<typename ConditionEvaluator::Scalar, typename XprType::Scalar>::value,
+
+    Flags = (unsigned int)ThenFlags & ElseFlags
+          & (HereditaryBits | (StorageOrdersAgree ? int(ConditionFlags) & (LinearAccessBit | (Vectorizable ? PacketAccessBit : 0)) : 0)),
+
+    ThenElseAlignment = EIGEN_PLAIN_ENUM_MIN(evaluator<ThenMatrixType>::Alignment, evaluator<ElseMatrixType>::Alignment),
+    Alignment = Vectorizable ? EIGEN_PLAIN_ENUM_MIN(ThenElseAlignment, ConditionEvaluator::Alignment) : ThenElseAlignment
   };
 
   EIGEN_DEVICE_FUNC explicit evaluator(const XprType& select)
@@ -1231,9 +1575,27 @@ struct evaluator<Select<ConditionMatrixType, ThenMatrixType, ElseMatrixType> >
     else
       return m_elseImpl.coeff(index);
   }
+
+  template<int LoadMode, typename PacketType>
+  EIGEN_STRONG_INLINE
+  PacketType packet(Index row, Index col) const
+  {
+    return internal::pselect(m_conditionImpl.template packet<LoadMode,PacketType>(row, col),
+                             m_thenImpl.template packet<LoadMode,PacketType>(row, col),
+                             m_elseImpl.template packet<LoadMode,PacketType>(row, col));
+  }
+
+  template<int LoadMode, typename PacketType>
+  EIGEN_STRONG_INLINE
+  PacketType packet(Index index) const
+  {
+    return internal::pselect(m_conditionImpl.template packet<LoadMode,PacketType>(index),
+                             m_thenImpl.template packet<LoadMode,PacketType>(index),
+                             m_elseImpl.template packet<LoadMode,PacketType>(index));
+  }
  
 protected:
-  evaluator<ConditionMatrixType> m_conditionImpl;
+  ConditionEvaluator m_conditionImpl;
   evaluator<ThenMatrixType> m_thenImpl;
   evaluator<ElseMatrixType> m_elseImpl;
 };
@@ -56,6 +56,8 @@ struct default_packet_traits
     HasConj   = 1,
     HasSetLinear = 1,
     HasBlend  = 0,
+    HasCmp    = 0,
+    HasIndexedGather = 0,
 
     HasDiv    = 0,
     HasSqrt   = 0,
@@ -132,6 +134,14 @@ template <typename Src, typename Tgt> struct type_casting_traits {
   };
 };
 
+/** \internal Tells whether ploadu_cast() converts the coefficients of type \a Src stored in memory into
+  * packets of \a Tgt with vector instructions. This is used for the scalar types having no packet type. */
+template <typename Src, typename Tgt> struct load_casting_traits {
+  enum {
+    VectorizedLoad = 0
+  };
+};
+
 
 /** \internal \returns static_cast<TgtType>(a) (coeff-wise) */
 template <typename SrcPacket, typename TgtPacket>
@@ -260,6 +270,17 @@ pload(const typename unpacket_traits<Packet>::type* from) { return *from; }
 template<typename Packet> EIGEN_DEVICE_FUNC inline Packet
 ploadu(const typename unpacket_traits<Packet>::type* from) { return *from; }
 
+/** \internal \returns a packet of the first unpacket_traits<Packet>::size coefficients of \a from converted to
+  * the scalar type of \a Packet as static_cast does (un-aligned load), see load_casting_traits */
+template<typename Packet, typename SrcScalar> EIGEN_DEVICE_FUNC inline Packet
+ploadu_cast(const SrcScalar* from) {
+  typedef typename unpacket_traits<Packet>::type Scalar;
+  EIGEN_ALIGN_MAX Scalar values[unpacket_traits<Packet>::size];
+  for (int i = 0; i < unpacket_traits<Packet>::size; ++i)
+    values[i] = static_cast<Scalar>(from[i]);
+  return pload<Packet>(values);
+}
+
 /** \internal \returns a packet with constant coefficients \a a, e.g.: (a,a,a,a) */
 template<typename Packet> EIGEN_DEVICE_FUNC inline Packet
 pset1(const typename unpacket_traits<Packet>::type& a) { return a; }
@@ -342,6 +363,28 @@ template<typename Scalar, typename Packet> EIGEN_DEVICE_FUNC inline void pstoreu
  template<typename Scalar, typename Packet> EIGEN_DEVICE_FUNC inline void pscatter(Scalar* to, const Packet& from, Index /*stride*/)
  { pstore(to, from); }
 
+/** \internal \returns the packet (from[indices[0]], from[indices[1]], ...) gathered through an array of
+  * unpacket_traits<Packet>::size indices. Backends with a hardware gather set packet_traits::HasIndexedGather. */
+template<typename Scalar, typename Packet> EIGEN_DEVICE_FUNC inline Packet
+pgather_indexed(const Scalar* from, const int* indices)
+{
+  EIGEN_ALIGN_MAX Scalar elements[unpacket_traits<Packet>::size];
+  for (int k=0; k<unpacket_traits<Packet>::size; ++k)
+    elements[k] = from[indices[k]];
+  return pload<Packet>(elements);
+}
+
+/** \internal copies the coefficients of the packet \a from to to[indices[0]], to[indices[1]], ...
+  * The indices must be distinct. */
+template<typename Scalar, typename Packet> EIGEN_DEVICE_FUNC inline void
+pscatter_indexed(Scalar* to, const Packet& from, const int* indices)
+{
+  EIGEN_ALIGN_MAX Scalar elements[unpacket_traits<Packet>::size];
+  pstore(elements, from);
+  for (int k=0; k<unpacket_traits<Packet>::size; ++k)
+    to[indices[k]] = elements[k];
+}
+
 /** \internal tries to do cache prefetching of \a addr */
 template<typename Scalar> EIGEN_DEVICE_FUNC inline void prefetch(const Scalar* addr)
 {
@@ -393,6 +436,20 @@ template<typename Packet> EIGEN_DEVICE_FUNC inline typename unpacket_traits<Pack
 template<typename Packet> EIGEN_DEVICE_FUNC inline typename unpacket_traits<Packet>::type predux_max(const Packet& a)
 { return a; }
 
+/** \internal \returns whether at least one lane of the bit mask \a mask returned by a pcmp_* function is set */
+template<typename Packet> EIGEN_DEVICE_FUNC inline bool
+pmask_any(const Packet& mask) {
+  typedef typename unpacket_traits<Packet>::type Scalar;
+  return predux(pand(mask, pset1<Packet>(Scalar(1)))) != Scalar(0);
+}
+
+/** \internal \returns whether all the lanes of the bit mask \a mask returned by a pcmp_* function are set */
+template<typename Packet> EIGEN_DEVICE_FUNC inline bool
+pmask_all(const Packet& mask) {
+  typedef typename unpacket_traits<Packet>::type Scalar;
+  return predux(pand(mask, pset1<Packet>(Scalar(1)))) == Scalar(unpacket_traits<Packet>::size);
+}
+
 /** \internal \returns the reversed elements of \a a*/
 template<typename Packet> EIGEN_DEVICE_FUNC inline Packet preverse(const Packet& a)
 { return a; }
@@ -158,17 +158,61 @@ public:
 
 namespace internal {
 
+// Tells how a packet of consecutive inner indices can be loaded: AllRange maps to consecutive coefficients,
+// while arrays of contiguous int, like std::vector<int> or ArrayXi, can be passed to pgather_indexed.
+template<typename Indices, typename EnableIf=void>
+struct indexed_view_inner_indices
+{
+  enum { IsAll = 0, IsIntArray = 0 };
+  static const int* data(const Indices&) { return 0; }
+};
+
+template<int Size>
+struct indexed_view_inner_indices<AllRange<Size> >
+{
+  enum { IsAll = 1, IsIntArray = 0 };
+  static const int* data(const AllRange<Size>&) { return 0; }
+};
+
+#if EIGEN_HAS_CXX11
+template<typename Indices, bool IsEigenType = std::is_base_of<EigenBase<Indices>,Indices>::value>
+struct indexed_view_has_unit_stride { enum { value = 1 }; };
+
+template<typename Indices>
+struct indexed_view_has_unit_stride<Indices,true> { enum { value = int(inner_stride_at_compile_time<Indices>::ret)==1 }; };
+
+template<typename Indices>
+struct indexed_view_inner_indices<Indices,
+  typename enable_if<is_same<decltype(static_cast<const Indices*>(0)->data()),const int*>::value>::type>
+{
+  enum { IsAll = 0, IsIntArray = indexed_view_has_unit_stride<Indices>::value };
+  static const int* data(const Indices& indices) { return indices.data(); }
+};
+#endif
 
 template<typename ArgType, typename RowIndices, typename ColIndices>
 struct unary_evaluator<IndexedView<ArgType, RowIndices, ColIndices>, IndexBased>
   : evaluator_base<IndexedView<ArgType, RowIndices, ColIndices> >
 {
   typedef IndexedView<ArgType, RowIndices, ColIndices> XprType;
+  typedef traits<XprType> XprTraits;
+  typedef typename conditional<bool(XprTraits::IsRowMajor), ColIndices, RowIndices>::type InnerIndices;
+  typedef indexed_view_inner_indices<InnerIndices> InnerIndicesTraits;
 
   enum {
     CoeffReadCost = evaluator<ArgType>::CoeffReadCost /* TODO + cost of row/col index */,
 
-    Flags = (evaluator<ArgType>::Flags & (HereditaryBits /*| LinearAccessBit | DirectAccessBit*/)),
+    // Packets are read along the inner dimension of a directly accessible nested expression, either with
+    // unaligned loads when all the inner indices are taken, or with a gather through the index array.
+    PacketAccess = bool(XprTraits::HasSameStorageOrderAsXprType)
+                && int(XprTraits::XprInnerStride)==1
+                && (int(traits<ArgType>::Flags) & DirectAccessBit)
+                && bool(packet_traits<typename XprType::Scalar>::Vectorizable)
+                && (bool(InnerIndicesTraits::IsAll)
+                    || (bool(InnerIndicesTraits::IsIntArray) && bool(packet_traits<typename XprType::Scalar>::HasIndexedGather))),
+
+    Flags = (evaluator<ArgType>::Flags & (HereditaryBits /*| LinearAccessBit | DirectAccessBit*/))
+          | (PacketAccess ? PacketAccessBit : 0),
 
     Alignment = 0
   };
@@ -193,8 +237,43 @@ struct unary_evaluator<IndexedView<ArgType, RowIndices, ColIndices>, IndexBased>
     return m_argImpl.coeffRef(m_xpr.rowIndices()[row], m_xpr.colIndices()[col]);
   }
 
+  template<int LoadMode, typename PacketType>
+  EIGEN_STRONG_INLINE
+  PacketType packet(Index row, Index col) const
+  {
+    const Index inner = XprTraits::IsRowMajor ? col : row;
+    const Scalar* base = outerData(row, col);
+    if (InnerIndicesTraits::IsAll)
+      return ploadu<PacketType>(base + inner);
+    return pgather_indexed<Scalar,PacketType>(base, InnerIndicesTraits::data(innerIndices()) + inner);
+  }
+
+  template<int StoreMode, typename PacketType>
+  EIGEN_STRONG_INLINE
+  void writePacket(Index row, Index col, const PacketType& x)
+  {
+    const Index inner = XprTraits::IsRowMajor ? col : row;
+    Scalar* base = const_cast<Scalar*>(outerData(row, col));
+    if (InnerIndicesTraits::IsAll)
+      pstoreu<Scalar,PacketType>(base + inner, x);
+    else
+      pscatter_indexed<Scalar,PacketType>(base, x, InnerIndicesTraits::data(innerIndices()) + inner);
+  }
+
 protected:
 
+  EIGEN_STRONG_INLINE const InnerIndices& innerIndices() const
+  { return innerIndices(typename conditional<bool(XprTraits::IsRowMajor), true_type, false_type>::type()); }
+  EIGEN_STRONG_INLINE const InnerIndices& innerIndices(true_type) const { return m_xpr.colIndices(); }
+  EIGEN_STRONG_INLINE const InnerIndices& innerIndices(false_type) const { return m_xpr.rowIndices(); }
+
+  // pointer to the first coefficient of the nested inner vector holding (row,col)
+  EIGEN_STRONG_INLINE const Scalar* outerData(Index row, Index col) const
+  {
+    const Index outer = XprTraits::IsRowMajor ? m_xpr.rowIndices()[row] : m_xpr.colIndices()[col];
+    return m_xpr.nestedExpression().data() + outer * m_xpr.nestedExpression().outerStride();
+  }
+
   evaluator<ArgType> m_argImpl;
   const XprType& m_xpr;
 
@@ -971,43 +971,70 @@ struct permutation_matrix_product<ExpressionType, Side, Transposed, DenseShape>
     typedef typename nested_eval<ExpressionType, 1>::type MatrixType;
     typedef typename remove_all<MatrixType>::type MatrixTypeCleaned;
 
+    enum {
+      // when true, the row (or column) i is moved to perm(i), otherwise it is taken from perm(i)
+      Scatter = (Side==OnTheLeft) ^ Transposed
+    };
+
     template<typename Dest, typename PermutationType>
     static inline void run(Dest& dst, const PermutationType& perm, const ExpressionType& xpr)
     {
       MatrixType mat(xpr);
-      const Index n = Side==OnTheLeft ? mat.rows() : mat.cols();
       // FIXME we need an is_same for expression that is not sensitive to constness. For instance
       // is_same_xpr<Block<const Matrix>, Block<Matrix> >::value should be true.
       //if(is_same<MatrixTypeCleaned,Dest>::value && extract_data(dst) == extract_data(mat))
       if(is_same_dense(dst, mat))
-      {
-        // apply the permutation inplace
-        Matrix<bool,PermutationType::RowsAtCompileTime,1,0,PermutationType::MaxRowsAtCompileTime> mask(perm.size());
-        mask.fill(false);
-        Index r = 0;
-        while(r < perm.size())
-        {
-          // search for the next seed
-          while(r<perm.size() && mask[r]) r++;
-          if(r>=perm.size())
-            break;
-          // we got one, let's follow it until we are back to the seed
-          Index k0 = r++;
-          Index kPrev = k0;
-          mask.coeffRef(k0) = true;
-          for(Index k=perm.indices().coeff(k0); k!=k0; k=perm.indices().coeff(k))
-          {
-                  Block<Dest, Side==OnTheLeft ? 1 : Dest::RowsAtCompileTime, Side==OnTheRight ? 1 : Dest::ColsAtCompileTime>(dst, k)
-            .swap(Block<Dest, Side==OnTheLeft ? 1 : Dest::RowsAtCompileTime, Side==OnTheRight ? 1 : Dest::ColsAtCompileTime>
-                       (dst,((Side==OnTheLeft) ^ Transposed) ? k0 : kPrev));
-
-            mask.coeffRef(k) = true;
-            kPrev = k;
-          }
-        }
-      }
+        permute_inplace(dst, perm);
       else
+        permuted_copy(dst, perm, mat);
+    }
+
+  protected:
+
+    // The permutations only move memory: below this number of coefficients per thread, they are not worth the threads.
+    static Index threadsFor(Index size, Index maxChunks)
+    {
+#ifdef EIGEN_HAS_OPENMP
+      const Index minChunkSize = 32768;
+      if(omp_get_num_threads()>1)
+        return 1;
+      return numext::maxi<Index>(1, numext::mini<Index>(numext::mini<Index>(nbThreads(), size / minChunkSize), maxChunks));
+#else
+      EIGEN_UNUSED_VARIABLE(size);
+      EIGEN_UNUSED_VARIABLE(maxChunks);
+      return 1;
+#endif
+    }
+
+    // (i,j) are the coordinates along the permuted and along the other dimension
+    template<typename Xpr>
+    static EIGEN_STRONG_INLINE typename Xpr::Scalar& coeffAt(Xpr& xpr, Index i, Index j)
+    {
+      return Side==OnTheLeft ? xpr.coeffRef(i, j) : xpr.coeffRef(j, i);
+    }
+
+    // the segment of the given size starting at j0 of the row (or column) i
+    template<typename Xpr>
+    static EIGEN_STRONG_INLINE Block<Xpr, Side==OnTheLeft ? 1 : Dynamic, Side==OnTheLeft ? Dynamic : 1>
+    segmentAt(Xpr& xpr, Index i, Index j0, Index size)
+    {
+      return Block<Xpr, Side==OnTheLeft ? 1 : Dynamic, Side==OnTheLeft ? Dynamic : 1>
+               (xpr, Side==OnTheLeft ? i : j0, Side==OnTheLeft ? j0 : i, Side==OnTheLeft ? 1 : size, Side==OnTheLeft ? size : 1);
+    }
+
+    template<typename Dest, typename PermutationType>
+    static void permuted_copy(Dest& dst, const PermutationType& perm, const MatrixTypeCleaned& mat)
+    {
+      const Index n = perm.size();
+      const Index otherSize = Side==OnTheLeft ? mat.cols() : mat.rows();
+
+      if(bool(Dest::IsRowMajor) == (Side==OnTheLeft) && !(Dest::RowsAtCompileTime==1 || Dest::ColsAtCompileTime==1))
       {
+        // the permuted rows (or columns) are contiguous in dst, they are copied as a whole
+#ifdef EIGEN_HAS_OPENMP
+        const Index threads = threadsFor(n * otherSize, n);
+        #pragma omp parallel for num_threads(int(threads)) schedule(static) if(threads>1)
+#endif
         for(Index i = 0; i < n; ++i)
         {
           Block<Dest, Side==OnTheLeft ? 1 : Dest::RowsAtCompileTime, Side==OnTheRight ? 1 : Dest::ColsAtCompileTime>
@@ -1019,6 +1046,139 @@ struct permutation_matrix_product<ExpressionType, Side, Transposed, DenseShape>
                (mat, ((Side==OnTheRight) ^ Transposed) ? perm.indices().coeff(i) : i);
         }
       }
+      else if(Scatter && otherSize > 1)
+      {
+        // the scattered writes are slower than scattered reads: the inverse permutation is built once to gather
+        // the coefficients of dst instead
+        typedef typename PermutationType::StorageIndex StorageIndex;
+        ei_declare_aligned_stack_constructed_variable(StorageIndex, inverse, n, 0);
+        for(Index i = 0; i < n; ++i)
+          inverse[perm.indices().coeff(i)] = StorageIndex(i);
+        copy_coefficients<false>(dst, Map<const Matrix<StorageIndex,Dynamic,1> >(inverse, n), mat);
+      }
+      else
+        copy_coefficients<Scatter>(dst, perm.indices(), mat);
+    }
+
+    // The permuted coefficients are spread along the columns (or rows) of dst, which are permuted one after the
+    // other, so that the scattered accesses stay within a single column. The long columns of the matrices having
+    // less columns than threads are split into ranges of rows.
+    template<bool ScatterWrites, typename Dest, typename Indices>
+    static void copy_coefficients(Dest& dst, const Indices& indices, const MatrixTypeCleaned& mat)
+    {
+      const Index n = indices.size();
+      const Index otherSize = Side==OnTheLeft ? mat.cols() : mat.rows();
+      const Index threads = threadsFor(n * otherSize, n * otherSize);
+      const Index rangesPerColumn = otherSize >= threads ? 1 : numext::div_ceil(threads, otherSize);
+      const Index rangeSize = numext::div_ceil(n, rangesPerColumn);
+      const Index tasks = otherSize * rangesPerColumn;
+#ifdef EIGEN_HAS_OPENMP
+      #pragma omp parallel for num_threads(int(threads)) schedule(static) if(threads>1)
+#endif
+      for(Index t = 0; t < tasks; ++t)
+      {
+        const Index j = t / rangesPerColumn;
+        const Index begin = (t % rangesPerColumn) * rangeSize;
+        const Index end = numext::mini(n, begin + rangeSize);
+        for(Index i = begin; i < end; ++i)
+        {
+          const Index k = indices.coeff(i);
+          coeffAt(dst, ScatterWrites ? k : i, j) = Side==OnTheLeft ? mat.coeff(ScatterWrites ? i : k, j)
+                                                                   : mat.coeff(j, ScatterWrites ? i : k);
+        }
+      }
+    }
+
+    template<typename Dest, typename PermutationType>
+    static void permute_inplace(Dest& dst, const PermutationType& perm)
+    {
+      typedef typename Dest::Scalar Scalar;
+      const Index n = perm.size();
+      const Index otherSize = Side==OnTheLeft ? dst.cols() : dst.rows();
+
+      // The non trivial cycles of the permutation are listed once, each one in the order in which its rows (or
+      // columns) are overwritten: the row order[t] takes the row order[t+1], and the last row of a cycle, stored as
+      // -1-order[t], takes the first one. They are then applied to one column at a time, so that the moves stay
+      // within a column, or, when the rows are contiguous, to one segment of all the rows per thread.
+      ei_declare_aligned_stack_constructed_variable(Index, order, n, 0);
+      Index orderSize = 0;
+      {
+        Matrix<bool,PermutationType::RowsAtCompileTime,1,0,PermutationType::MaxRowsAtCompileTime> mask(n);
+        mask.fill(false);
+        for(Index r = 0; r < n; ++r)
+        {
+          if(mask.coeff(r) || perm.indices().coeff(r) == r)
+            continue;
+          const Index begin = orderSize;
+          for(Index k = r; !mask.coeff(k); k = perm.indices().coeff(k))
+          {
+            mask.coeffRef(k) = true;
+            order[orderSize++] = k;
+          }
+          // the rows moved to perm(k) are taken from the inverse permutation
+          if(Scatter)
+            std::reverse(order + begin + 1, order + orderSize);
+          order[orderSize-1] = -1 - order[orderSize-1];
+        }
+      }
+      if(orderSize == 0)
+        return;
+
+      if(bool(Dest::IsRowMajor) == (Side==OnTheLeft) && !(Dest::RowsAtCompileTime==1 || Dest::ColsAtCompileTime==1))
+      {
+        // the permuted rows (or columns) are contiguous: each thread moves the same segment of all of them, the
+        // first row of a cycle being swapped along the cycle
+        const Index packetSize = packet_traits<Scalar>::size;
+        const Index threads = threadsFor(orderSize * otherSize, numext::div_ceil(otherSize, packetSize));
+        const Index chunkSize = numext::div_ceil(numext::div_ceil(otherSize, threads), packetSize) * packetSize;
+        const Index chunks = numext::div_ceil(otherSize, chunkSize);
+#ifdef EIGEN_HAS_OPENMP
+        #pragma omp parallel for num_threads(int(threads)) schedule(static) if(threads>1)
+#endif
+        for(Index c = 0; c < chunks; ++c)
+        {
+          const Index j0 = c * chunkSize;
+          const Index size = numext::mini(otherSize - j0, chunkSize);
+          for(Index t = 0; t < orderSize; ++t)
+          {
+            Index k = order[t];
+            Index next;
+            do
+            {
+              next = order[++t];
+              const Index row = next < 0 ? -1 - next : next;
+              segmentAt(dst, k, j0, size).swap(segmentAt(dst, row, j0, size));
+              k = row;
+            } while(next >= 0);
+          }
+        }
+      }
+      else
+      {
+        // the permuted coefficients are spread along the columns (or rows), which are permuted one after the other
+#ifdef EIGEN_HAS_OPENMP
+        const Index threads = threadsFor(orderSize * otherSize, otherSize);
+        #pragma omp parallel for num_threads(int(threads)) schedule(static) if(threads>1)
+#endif
+        for(Index j = 0; j < otherSize; ++j)
+        {
+          for(Index t = 0; t < orderSize; ++t)
+          {
+            const Index first = order[t];
+            const Scalar tmp = coeffAt(dst, first, j);
+            Index k = first;
+            Index next;
+            while((next = order[++t]) >= 0)
+            {
+              coeffAt(dst, k, j) = coeffAt(dst, next, j);
+              k = next;
+            }
+            next = -1 - next;
+            coeffAt(dst, k, j) = coeffAt(dst, next, j);
+            coeffAt(dst, next, j) = tmp;
+          }
+        }
+      }
     }
 };
 
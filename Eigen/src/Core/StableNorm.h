@@ -115,19 +115,15 @@ stable_norm_impl(const MatrixType &mat, typename enable_if<!MatrixType::IsVector
   return scale * sqrt(ssq);
 }
 
-template<typename Derived>
-inline typename NumTraits<typename traits<Derived>::Scalar>::Real
-blueNorm_impl(const EigenBase<Derived>& _vec)
+template<typename RealScalar>
+struct blue_norm_constants
 {
-  typedef typename Derived::RealScalar RealScalar;  
-  using std::pow;
-  using std::sqrt;
-  using std::abs;
-  const Derived& vec(_vec.derived());
-  static bool initialized = false;
-  static RealScalar b1, b2, s1m, s2m, rbig, relerr;
-  if(!initialized)
+  RealScalar b1, b2, s1m, s2m, rbig, relerr;
+
+  blue_norm_constants()
   {
+    using std::pow;
+    using std::sqrt;
     int ibeta, it, iemin, iemax, iexp;
     RealScalar eps;
     // This program calculates the machine-dependent constants
@@ -156,68 +152,426 @@ blueNorm_impl(const EigenBase<Derived>& _vec)
 
     eps     = RealScalar(pow(double(ibeta), 1-it));
     relerr  = sqrt(eps);                                            // tolerance for neglecting asml
-    initialized = true;
   }
-  Index n = vec.size();
-  RealScalar ab2 = b2 / RealScalar(n);
-  RealScalar asml = RealScalar(0);
-  RealScalar amed = RealScalar(0);
-  RealScalar abig = RealScalar(0);
+
+  static const blue_norm_constants& get()
+  {
+    static const blue_norm_constants constants;
+    return constants;
+  }
+};
+
+// Sums of squares of the small, medium and big coefficients of Blue's algorithm,
+// the small and big ones being scaled by s1m and s2m respectively.
+template<typename RealScalar>
+struct blue_norm_sums
+{
+  RealScalar asml, amed, abig;
+
+  blue_norm_sums() : asml(0), amed(0), abig(0) {}
+
+  EIGEN_STRONG_INLINE void add(const RealScalar& ax, const RealScalar& ab2, const blue_norm_constants<RealScalar>& c)
+  {
+    if(ax > ab2)       abig += numext::abs2(ax*c.s2m);
+    else if(ax < c.b1) asml += numext::abs2(ax*c.s1m);
+    else               amed += numext::abs2(ax);
+  }
+
+  void merge(const blue_norm_sums& other)
+  {
+    asml += other.asml;
+    amed += other.amed;
+    abig += other.abig;
+  }
+
+  RealScalar norm() const
+  {
+    using std::sqrt;
+    const blue_norm_constants<RealScalar>& c = blue_norm_constants<RealScalar>::get();
+    RealScalar asml = this->asml, amed = this->amed, abig = this->abig;
+    if(amed!=amed)
+      return amed;  // we got a NaN
+    if(abig > RealScalar(0))
+    {
+      abig = sqrt(abig);
+      if(abig > c.rbig) // overflow, or *this contains INF values
+        return abig;  // return INF
+      if(amed > RealScalar(0))
+      {
+        abig = abig/c.s2m;
+        amed = sqrt(amed);
+      }
+      else
+        return abig/c.s2m;
+    }
+    else if(asml > RealScalar(0))
+    {
+      if (amed > RealScalar(0))
+      {
+        abig = sqrt(amed);
+        amed = sqrt(asml) / c.s1m;
+      }
+      else
+        return sqrt(asml)/c.s1m;
+    }
+    else
+      return sqrt(amed);
+    asml = numext::mini(abig, amed);
+    abig = numext::maxi(abig, amed);
+    if(asml <= abig*c.relerr)
+      return abig;
+    else
+      return abig * sqrt(RealScalar(1) + numext::abs2(asml/abig));
+  }
+};
+
+template<typename Derived>
+inline typename NumTraits<typename traits<Derived>::Scalar>::Real
+blueNorm_impl(const EigenBase<Derived>& _vec)
+{
+  typedef typename Derived::RealScalar RealScalar;  
+  using std::abs;
+  const Derived& vec(_vec.derived());
+  const blue_norm_constants<RealScalar>& c = blue_norm_constants<RealScalar>::get();
+  const RealScalar ab2 = c.b2 / RealScalar(vec.size());
+  blue_norm_sums<RealScalar> sums;
 
   for(Index j=0; j<vec.outerSize(); ++j)
   {
     for(typename Derived::InnerIterator it(vec, j); it; ++it)
+      sums.add(abs(it.value()), ab2, c);
+  }
+  return sums.norm();
+}
+
+// The norm of a scaled sum of squares, scale * sqrt(ssq), of some coefficients.
+template<typename RealScalar>
+struct stable_norm_sums
+{
+  RealScalar scale, ssq;
+
+  stable_norm_sums() : scale(0), ssq(0) {}
+
+  void merge(RealScalar otherScale, RealScalar otherSsq)
+  {
+    if(otherScale > scale)
     {
-      RealScalar ax = abs(it.value());
-      if(ax > ab2)     abig += numext::abs2(ax*s2m);
-      else if(ax < b1) asml += numext::abs2(ax*s1m);
-      else             amed += numext::abs2(ax);
+      std::swap(scale, otherScale);
+      std::swap(ssq, otherSsq);
     }
+    // equal scales include the zero and infinite ones
+    if(otherScale == scale)
+      ssq += otherSsq;
+    else
+      ssq += otherSsq * numext::abs2(otherScale/scale);
   }
-  if(amed!=amed)
-    return amed;  // we got a NaN
-  if(abig > RealScalar(0))
+
+  void merge(const stable_norm_sums& other) { merge(other.scale, other.ssq); }
+
+  RealScalar norm() const
   {
-    abig = sqrt(abig);
-    if(abig > rbig) // overflow, or *this contains INF values
-      return abig;  // return INF
-    if(amed > RealScalar(0))
+    using std::sqrt;
+    return scale * sqrt(ssq);
+  }
+};
+
+/** \internal
+  * Whether the norms of the dense expression \a Derived are computed from packets of its coefficients, in a
+  * single pass over its linear storage order.
+  */
+template<typename Derived>
+struct norm_vectorization
+{
+  typedef typename Derived::Scalar Scalar;
+  enum {
+    Flags = evaluator<Derived>::Flags,
+    value = (!NumTraits<Scalar>::IsComplex) && packet_traits<Scalar>::Vectorizable
+         && packet_traits<Scalar>::HasAbs && packet_traits<Scalar>::HasDiv && packet_traits<Scalar>::HasCmp
+         && (Flags & LinearAccessBit) && (Flags & PacketAccessBit)
+  };
+};
+
+// Accumulates the coefficients [begin,end) of eval into the three sums of Blue's algorithm, kept per lane of
+// two packets of accumulators.
+template<typename Evaluator, typename RealScalar>
+struct blue_norm_packet_reducer
+{
+  typedef typename packet_traits<RealScalar>::type Packet;
+  typedef blue_norm_sums<RealScalar> Sums;
+  enum { PacketSize = unpacket_traits<Packet>::size };
+
+  struct Lanes
+  {
+    Packet asml, amed, abig;
+    Lanes() : asml(pset1<Packet>(RealScalar(0))), amed(asml), abig(asml) {}
+  };
+
+  blue_norm_packet_reducer(const Evaluator& eval, const RealScalar& ab2)
+    : m_eval(eval), m_ab2(ab2)
+  {
+    const blue_norm_constants<RealScalar>& c = blue_norm_constants<RealScalar>::get();
+    m_pb1 = pset1<Packet>(c.b1);
+    m_pab2 = pset1<Packet>(ab2);
+    m_ps1m = pset1<Packet>(c.s1m);
+    m_ps2m = pset1<Packet>(c.s2m);
+  }
+
+  EIGEN_STRONG_INLINE void accumulate(Index i, Lanes& lanes) const
+  {
+    // the masks select the range of each coefficient, NaNs falling in the medium range
+    const Packet ax = pabs(m_eval.template packet<Unaligned,Packet>(i));
+    const Packet big = pcmp_lt(m_pab2, ax);
+    const Packet sml = pcmp_lt(ax, m_pb1);
+    if(!pmask_any(por(big, sml)))
     {
-      abig = abig/s2m;
-      amed = sqrt(amed);
+      lanes.amed = pmadd(ax, ax, lanes.amed);
+      return;
     }
-    else
-      return abig/s2m;
+    // each lane is scaled for its own range only, which never produces subnormal squares
+    const Packet y = pmul(ax, pselect(big, m_ps2m, pselect(sml, m_ps1m, pset1<Packet>(RealScalar(1)))));
+    const Packet y2 = pmul(y, y);
+    lanes.abig = padd(lanes.abig, pand(big, y2));
+    lanes.asml = padd(lanes.asml, pand(sml, y2));
+    lanes.amed = padd(lanes.amed, pandnot(y2, por(big, sml)));
+  }
+
+  void operator()(Index begin, Index end, Sums& sums) const
+  {
+    using std::abs;
+    Lanes lanes0, lanes1;
+    const Index packetEnd = begin + ((end-begin)/PacketSize)*PacketSize;
+    const Index packetEnd2 = begin + ((end-begin)/(2*PacketSize))*(2*PacketSize);
+    Index i = begin;
+    for(; i<packetEnd2; i+=2*PacketSize)
+    {
+      accumulate(i, lanes0);
+      accumulate(i+PacketSize, lanes1);
+    }
+    if(i<packetEnd)
+    {
+      accumulate(i, lanes0);
+      i += PacketSize;
+    }
+    sums.asml += predux(padd(lanes0.asml, lanes1.asml));
+    sums.amed += predux(padd(lanes0.amed, lanes1.amed));
+    sums.abig += predux(padd(lanes0.abig, lanes1.abig));
+    const blue_norm_constants<RealScalar>& c = blue_norm_constants<RealScalar>::get();
+    for(; i<end; ++i)
+      sums.add(abs(m_eval.coeff(i)), m_ab2, c);
+  }
+
+  const Evaluator& m_eval;
+  const RealScalar m_ab2;
+  Packet m_pb1, m_pab2, m_ps1m, m_ps2m;
+};
+
+// Accumulates the coefficients [begin,end) of eval into scaled sums of squares kept per lane of a packet, and
+// merged at the end. The coefficients are processed by blocks of a few packets: the scales of the lanes are first
+// raised to the largest coefficients of the block, which is rare after the first blocks, and then the scaled
+// squares are summed while the block is still in the L1 cache.
+template<typename Evaluator, typename RealScalar>
+struct stable_norm_packet_reducer
+{
+  typedef typename packet_traits<RealScalar>::type Packet;
+  typedef stable_norm_sums<RealScalar> Sums;
+  enum { PacketSize = unpacket_traits<Packet>::size, BlockPackets = 8 };
+
+  struct Lanes
+  {
+    Packet scale, invScale, ssq;
+    Lanes() : scale(pset1<Packet>(RealScalar(0))), invScale(pset1<Packet>(RealScalar(1))), ssq(scale) {}
+  };
+
+  explicit stable_norm_packet_reducer(const Evaluator& eval) : m_eval(eval)
+  {
+    // squares of coefficients up to the upper bound of the medium range of Blue's algorithm can be summed
+    // without overflow, and the squares of those lower than lo*relerr are negligible
+    const blue_norm_constants<RealScalar>& c = blue_norm_constants<RealScalar>::get();
+    m_plo = pset1<Packet>(c.b1 / c.relerr);
+    m_phi = pset1<Packet>(c.b2);
+  }
+
+  EIGEN_STRONG_INLINE Packet load(Index i) const { return m_eval.template packet<Unaligned,Packet>(i); }
+
+  // Accumulates the packets [i, i+packets*PacketSize).
+  EIGEN_STRONG_INLINE void accumulate(Index i, Index packets, Lanes& lanes) const
+  {
+    Packet amax0 = pabs(load(i)), amax1 = amax0;
+    Index k = 1;
+    for(; k+1<packets; k+=2)
+    {
+      amax0 = pmax(amax0, pabs(load(i+k*PacketSize)));
+      amax1 = pmax(amax1, pabs(load(i+(k+1)*PacketSize)));
+    }
+    if(k<packets)
+      amax0 = pmax(amax0, pabs(load(i+k*PacketSize)));
+    const Packet amax = pmax(amax0, amax1);
+    const Packet grow = pcmp_lt(lanes.scale, amax);
+    if(pmask_any(grow))
+      rescale(amax, grow, lanes);
+    // When the scales are moderate, the squares are summed unscaled and scaled once per block.
+    const bool unscaled = pmask_all(pand(pcmp_le(m_plo, lanes.scale), pcmp_le(lanes.scale, m_phi)));
+    const Packet factor = unscaled ? pset1<Packet>(RealScalar(1)) : lanes.invScale;
+    Packet ssq0 = pset1<Packet>(RealScalar(0)), ssq1 = ssq0;
+    for(k=0; k+1<packets; k+=2)
+    {
+      const Packet x0 = pmul(load(i+k*PacketSize), factor);
+      const Packet x1 = pmul(load(i+(k+1)*PacketSize), factor);
+      ssq0 = pmadd(x0, x0, ssq0);
+      ssq1 = pmadd(x1, x1, ssq1);
+    }
+    if(k<packets)
+    {
+      const Packet x0 = pmul(load(i+k*PacketSize), factor);
+      ssq0 = pmadd(x0, x0, ssq0);
+    }
+    const Packet blockSsq = padd(ssq0, ssq1);
+    lanes.ssq = unscaled ? pmadd(blockSsq, pmul(lanes.invScale, lanes.invScale), lanes.ssq)
+                         : padd(lanes.ssq, blockSsq);
+  }
+
+  // Raises the scale of the lanes selected by grow to amax.
+  static void rescale(const Packet& amax, const Packet& grow, Lanes& lanes)
+  {
+    const RealScalar highest = NumTraits<RealScalar>::highest();
+    const Packet one = pset1<Packet>(RealScalar(1));
+    const Packet phighest = pset1<Packet>(highest);
+    Packet newScale = pselect(grow, amax, lanes.scale);
+    Packet newInvScale = pdiv(one, newScale);
+    // as in stable_norm_kernel, subnormal scales are clamped to 1/highest and infinite ones are not inverted
+    const Packet tiny = pcmp_lt(phighest, newInvScale);
+    newScale = pselect(tiny, pset1<Packet>(RealScalar(1)/highest), newScale);
+    newInvScale = pselect(tiny, phighest, newInvScale);
+    newInvScale = pselect(pcmp_lt(phighest, newScale), one, newInvScale);
+    const Packet ratio = pdiv(lanes.scale, newScale);
+    lanes.ssq = pselect(grow, pmul(lanes.ssq, pmul(ratio, ratio)), lanes.ssq);
+    lanes.scale = pselect(grow, newScale, lanes.scale);
+    lanes.invScale = pselect(grow, newInvScale, lanes.invScale);
   }
-  else if(asml > RealScalar(0))
+
+  static void merge(const Lanes& lanes, Sums& sums)
   {
-    if (amed > RealScalar(0))
+    const RealScalar scale = predux_max(lanes.scale);
+    if(scale > RealScalar(0) && scale <= NumTraits<RealScalar>::highest())
     {
-      abig = sqrt(amed);
-      amed = sqrt(asml) / s1m;
+      // all the lanes are rescaled to the largest scale at once
+      const Packet ratio = pdiv(lanes.scale, pset1<Packet>(scale));
+      sums.merge(scale, predux(pmul(lanes.ssq, pmul(ratio, ratio))));
     }
     else
-      return sqrt(asml)/s1m;
+    {
+      EIGEN_ALIGN_MAX RealScalar scales[PacketSize];
+      EIGEN_ALIGN_MAX RealScalar ssqs[PacketSize];
+      pstore(scales, lanes.scale);
+      pstore(ssqs, lanes.ssq);
+      for(Index k=0; k<PacketSize; ++k)
+        sums.merge(scales[k], ssqs[k]);
+    }
   }
-  else
-    return sqrt(amed);
-  asml = numext::mini(abig, amed);
-  abig = numext::maxi(abig, amed);
-  if(asml <= abig*relerr)
-    return abig;
-  else
-    return abig * sqrt(RealScalar(1) + numext::abs2(asml/abig));
+
+  void operator()(Index begin, Index end, Sums& sums) const
+  {
+    using std::abs;
+    Lanes lanes;
+    const Index packetEnd = begin + ((end-begin)/PacketSize)*PacketSize;
+    Index i = begin;
+    for(; i+BlockPackets*PacketSize<=packetEnd; i+=BlockPackets*PacketSize)
+      accumulate(i, BlockPackets, lanes);
+    if(i<packetEnd)
+    {
+      accumulate(i, (packetEnd-i)/PacketSize, lanes);
+      i = packetEnd;
+    }
+    merge(lanes, sums);
+    for(; i<end; ++i)
+      sums.merge(abs(m_eval.coeff(i)), RealScalar(1));
+  }
+
+  const Evaluator& m_eval;
+  Packet m_plo, m_phi;
+};
+
+/** \internal
+  * Reduces the coefficients [0,n) with reducer(begin,end,sums) into a Sums object. Long ranges are split into
+  * chunks reduced by several OpenMP threads and merged in order. In deterministic mode, the number of chunks does
+  * not depend on the number of threads, see setDeterministicParallelism().
+  */
+template<typename Sums, typename Reducer>
+Sums parallel_norm_reduce(const Reducer& reducer, Index n)
+{
+  Sums sums;
+#ifdef EIGEN_HAS_OPENMP
+  // below this number of coefficients per chunk, the norm is not worth the threads
+  const Index minChunkSize = 32768;
+  const Index maxChunks = numext::maxi<Index>(1, n / minChunkSize);
+  Index threads = numext::mini<Index>(nbThreads(), maxChunks);
+  if(omp_get_num_threads()>1)
+    threads = 1;
+  const Index chunks = deterministicParallelism() ? numext::mini<Index>(EIGEN_GEMM_DETERMINISTIC_SPLIT, maxChunks) : threads;
+  if(chunks>1)
+  {
+    const Index chunkSize = numext::div_ceil(numext::div_ceil(n, chunks), Index(Reducer::PacketSize)) * Reducer::PacketSize;
+    const int numChunks = int(numext::div_ceil(n, chunkSize));
+    ei_declare_aligned_stack_constructed_variable(Sums, partials, numChunks, 0);
+    #pragma omp parallel for num_threads(int(threads)) schedule(static) if(threads>1)
+    for(int k=0; k<numChunks; ++k)
+      reducer(k*chunkSize, numext::mini(n, (k+1)*chunkSize), partials[k]);
+    for(int k=0; k<numChunks; ++k)
+      sums.merge(partials[k]);
+    return sums;
+  }
+#endif
+  reducer(0, n, sums);
+  return sums;
 }
 
+template<typename Derived, bool Vectorize = norm_vectorization<Derived>::value>
+struct stable_norm_selector
+{
+  static typename Derived::RealScalar run(const Derived& x) { return stable_norm_impl(x); }
+};
+
+template<typename Derived>
+struct stable_norm_selector<Derived,true>
+{
+  typedef typename Derived::RealScalar RealScalar;
+  static RealScalar run(const Derived& x)
+  {
+    typedef evaluator<Derived> Evaluator;
+    const Evaluator eval(x);
+    const stable_norm_packet_reducer<Evaluator,RealScalar> reducer(eval);
+    return parallel_norm_reduce<stable_norm_sums<RealScalar> >(reducer, x.size()).norm();
+  }
+};
+
+template<typename Derived, bool Vectorize = norm_vectorization<Derived>::value>
+struct blue_norm_selector
+{
+  static typename Derived::RealScalar run(const Derived& x) { return blueNorm_impl(x); }
+};
+
+template<typename Derived>
+struct blue_norm_selector<Derived,true>
+{
+  typedef typename Derived::RealScalar RealScalar;
+  static RealScalar run(const Derived& x)
+  {
+    typedef evaluator<Derived> Evaluator;
+    const Evaluator eval(x);
+    const blue_norm_packet_reducer<Evaluator,RealScalar> reducer(eval, blue_norm_constants<RealScalar>::get().b2 / RealScalar(x.size()));
+    return parallel_norm_reduce<blue_norm_sums<RealScalar> >(reducer, x.size()).norm();
+  }
+};
+
 } // end namespace internal
 
 /** \returns the \em l2 norm of \c *this avoiding underflow and overflow.
-  * This version use a blockwise two passes algorithm:
-  *  1 - find the absolute largest coefficient \c s
-  *  2 - compute \f$ s \Vert \frac{*this}{s} \Vert \f$ in a standard way
+  * This version computes \f$ s \Vert \frac{*this}{s} \Vert \f$ where \c s is the absolute largest coefficient.
   *
-  * For architecture/scalar types supporting vectorization, this version
-  * is faster than blueNorm(). Otherwise the blueNorm() is much faster.
+  * For real scalar types supporting vectorization and expressions with linear access, the coefficients are read
+  * once, by packets whose lanes keep their own scale, updated when a larger coefficient comes in. Long vectors are
+  * reduced by several threads when OpenMP is enabled, see setNbThreads(). Otherwise, a blockwise two passes
+  * algorithm is used, and blueNorm() is faster.
   *
   * \sa norm(), blueNorm(), hypotNorm()
   */
@@ -225,15 +579,16 @@ template<typename Derived>
 inline typename NumTraits<typename internal::traits<Derived>::Scalar>::Real
 MatrixBase<Derived>::stableNorm() const
 {
-  return internal::stable_norm_impl(derived());
+  return internal::stable_norm_selector<Derived>::run(derived());
 }
 
 /** \returns the \em l2 norm of \c *this using the Blue's algorithm.
   * A Portable Fortran Program to Find the Euclidean Norm of a Vector,
   * ACM TOMS, Vol 4, Issue 1, 1978.
   *
-  * For architecture/scalar types without vectorization, this version
-  * is much faster than stableNorm(). Otherwise the stableNorm() is faster.
+  * For real scalar types supporting vectorization and expressions with linear access, the three sums of squares
+  * of the algorithm are accumulated by packets, and long vectors are reduced by several threads when OpenMP is
+  * enabled. For other types, this version is much faster than stableNorm().
   *
   * \sa norm(), stableNorm(), hypotNorm()
   */
@@ -241,7 +596,7 @@ template<typename Derived>
 inline typename NumTraits<typename internal::traits<Derived>::Scalar>::Real
 MatrixBase<Derived>::blueNorm() const
 {
-  return internal::blueNorm_impl(*this);
+  return internal::blue_norm_selector<Derived>::run(derived());
 }
 
 /** \returns the \em l2 norm of \c *this avoiding undeflow and overflow.
@@ -69,7 +69,15 @@ template<> struct packet_traits<float>  : default_packet_traits
     HasSqrt = 1,
     HasRsqrt = 1,
     HasTanh  = EIGEN_FAST_MATH,
+    HasLGamma = 1,
+    HasDiGamma = 1,
+    HasI0e = 1,
+    HasI1e = 1,
     HasBlend = 1,
+    HasCmp = 1,
+#ifdef EIGEN_VECTORIZE_AVX2
+    HasIndexedGather = 1,
+#endif
     HasRound = 1,
     HasFloor = 1,
     HasCeil = 1
@@ -89,7 +97,13 @@ template<> struct packet_traits<double> : default_packet_traits
     HasExp  = 1,
     HasSqrt = 1,
     HasRsqrt = 1,
+    HasI0e = 1,
+    HasI1e = 1,
     HasBlend = 1,
+    HasCmp = 1,
+#ifdef EIGEN_VECTORIZE_AVX2
+    HasIndexedGather = 1,
+#endif
     HasRound = 1,
     HasFloor = 1,
     HasCeil = 1
@@ -210,6 +224,20 @@ template<> EIGEN_STRONG_INLINE Packet8f pcmp_lt(const Packet8f& a, const Packet8
 template<> EIGEN_STRONG_INLINE Packet8f pcmp_eq(const Packet8f& a, const Packet8f& b) { return _mm256_cmp_ps(a,b,_CMP_EQ_OQ); }
 template<> EIGEN_STRONG_INLINE Packet8f pcmp_lt_or_nan(const Packet8f& a, const Packet8f& b) { return _mm256_cmp_ps(a, b, _CMP_NGE_UQ); }
 
+template<> EIGEN_STRONG_INLINE Packet4d pcmp_le(const Packet4d& a, const Packet4d& b) { return _mm256_cmp_pd(a,b,_CMP_LE_OQ); }
+template<> EIGEN_STRONG_INLINE Packet4d pcmp_lt(const Packet4d& a, const Packet4d& b) { return _mm256_cmp_pd(a,b,_CMP_LT_OQ); }
+template<> EIGEN_STRONG_INLINE Packet4d pcmp_eq(const Packet4d& a, const Packet4d& b) { return _mm256_cmp_pd(a,b,_CMP_EQ_OQ); }
+template<> EIGEN_STRONG_INLINE Packet4d pcmp_lt_or_nan(const Packet4d& a, const Packet4d& b) { return _mm256_cmp_pd(a, b, _CMP_NGE_UQ); }
+
+template<> EIGEN_STRONG_INLINE bool pmask_any(const Packet8f& mask) { return _mm256_movemask_ps(mask) != 0; }
+template<> EIGEN_STRONG_INLINE bool pmask_all(const Packet8f& mask) { return _mm256_movemask_ps(mask) == 0xFF; }
+
+template<> EIGEN_STRONG_INLINE bool pmask_any(const Packet4d& mask) { return _mm256_movemask_pd(mask) != 0; }
+template<> EIGEN_STRONG_INLINE bool pmask_all(const Packet4d& mask) { return _mm256_movemask_pd(mask) == 0xF; }
+
+template<> EIGEN_STRONG_INLINE Packet8f pselect(const Packet8f& mask, const Packet8f& a, const Packet8f& b) { return _mm256_blendv_ps(b,a,mask); }
+template<> EIGEN_STRONG_INLINE Packet4d pselect(const Packet4d& mask, const Packet4d& a, const Packet4d& b) { return _mm256_blendv_pd(b,a,mask); }
+
 template<> EIGEN_STRONG_INLINE Packet8f pround<Packet8f>(const Packet8f& a) { return _mm256_round_ps(a, _MM_FROUND_CUR_DIRECTION); }
 template<> EIGEN_STRONG_INLINE Packet4d pround<Packet4d>(const Packet4d& a) { return _mm256_round_pd(a, _MM_FROUND_CUR_DIRECTION); }
 
@@ -312,6 +340,18 @@ template<> EIGEN_DEVICE_FUNC inline void pscatter<double, Packet4d>(double* to,
   to[stride*3] = _mm_cvtsd_f64(_mm_shuffle_pd(high, high, 1));
 }
 
+#ifdef EIGEN_VECTORIZE_AVX2
+// AVX2 has no scatter instruction: pscatter_indexed keeps the generic implementation
+template<> EIGEN_DEVICE_FUNC inline Packet8f pgather_indexed<float, Packet8f>(const float* from, const int* indices)
+{
+  return _mm256_i32gather_ps(from, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices)), 4);
+}
+template<> EIGEN_DEVICE_FUNC inline Packet4d pgather_indexed<double, Packet4d>(const double* from, const int* indices)
+{
+  return _mm256_i32gather_pd(from, _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices)), 8);
+}
+#endif
+
 template<> EIGEN_STRONG_INLINE void pstore1<Packet8f>(float* to, const float& a)
 {
   Packet8f pa = pset1<Packet8f>(a);
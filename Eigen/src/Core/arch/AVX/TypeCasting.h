@@ -14,36 +14,135 @@ namespace Eigen {
 
 namespace internal {
 
-// For now we use SSE to handle integers, so we can't use AVX instructions to cast
-// from int to float
+// The integers are handled by SSE packets, so the conversions between ints and floats or doubles take or produce
+// half of an AVX packet. With AVX512, the packets of floats and doubles are larger and these traits are replaced.
+#ifndef EIGEN_VECTORIZE_AVX512
 template <>
 struct type_casting_traits<float, int> {
   enum {
-    VectorizedCast = 0,
+    VectorizedCast = 1,
     SrcCoeffRatio = 1,
-    TgtCoeffRatio = 1
+    TgtCoeffRatio = 2
   };
 };
 
 template <>
 struct type_casting_traits<int, float> {
   enum {
-    VectorizedCast = 0,
+    VectorizedCast = 1,
+    SrcCoeffRatio = 2,
+    TgtCoeffRatio = 1
+  };
+};
+
+template <>
+struct type_casting_traits<float, double> {
+  enum {
+    VectorizedCast = 1,
     SrcCoeffRatio = 1,
+    TgtCoeffRatio = 2
+  };
+};
+
+template <>
+struct type_casting_traits<double, float> {
+  enum {
+    VectorizedCast = 1,
+    SrcCoeffRatio = 2,
     TgtCoeffRatio = 1
   };
 };
 
+template <>
+struct type_casting_traits<int, double> {
+  enum {
+    VectorizedCast = 1,
+    SrcCoeffRatio = 1,
+    TgtCoeffRatio = 1
+  };
+};
 
+template <>
+struct type_casting_traits<double, int> {
+  enum {
+    VectorizedCast = 1,
+    SrcCoeffRatio = 1,
+    TgtCoeffRatio = 1
+  };
+};
+
+template <> struct load_casting_traits<signed char, float> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<unsigned char, float> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<short, float> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<unsigned short, float> { enum { VectorizedLoad = 1 }; };
+#endif
 
 template<> EIGEN_STRONG_INLINE Packet8i pcast<Packet8f, Packet8i>(const Packet8f& a) {
-  return _mm256_cvtps_epi32(a);
+  return _mm256_cvttps_epi32(a);
 }
 
 template<> EIGEN_STRONG_INLINE Packet8f pcast<Packet8i, Packet8f>(const Packet8i& a) {
   return _mm256_cvtepi32_ps(a);
 }
 
+template<> EIGEN_STRONG_INLINE Packet4i pcast<Packet8f, Packet4i>(const Packet8f& a) {
+  // Simply discard the second half of the input
+  return _mm_cvttps_epi32(_mm256_castps256_ps128(a));
+}
+
+template<> EIGEN_STRONG_INLINE Packet8f pcast<Packet4i, Packet8f>(const Packet4i& a, const Packet4i& b) {
+  return _mm256_cvtepi32_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(a), b, 1));
+}
+
+template<> EIGEN_STRONG_INLINE Packet4d pcast<Packet8f, Packet4d>(const Packet8f& a) {
+  // Simply discard the second half of the input
+  return _mm256_cvtps_pd(_mm256_castps256_ps128(a));
+}
+
+template<> EIGEN_STRONG_INLINE Packet8f pcast<Packet4d, Packet8f>(const Packet4d& a, const Packet4d& b) {
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(a)), _mm256_cvtpd_ps(b), 1);
+}
+
+template<> EIGEN_STRONG_INLINE Packet4d pcast<Packet4i, Packet4d>(const Packet4i& a) {
+  return _mm256_cvtepi32_pd(a);
+}
+
+template<> EIGEN_STRONG_INLINE Packet4i pcast<Packet4d, Packet4i>(const Packet4d& a) {
+  return _mm256_cvttpd_epi32(a);
+}
+
+template<> EIGEN_STRONG_INLINE Packet8f ploadu_cast<Packet8f, unsigned char>(const unsigned char* from) {
+#ifdef EIGEN_VECTORIZE_AVX2
+  return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(from))));
+#else
+  return pcast<Packet4i, Packet8f>(ploadu_cast<Packet4i>(from), ploadu_cast<Packet4i>(from + 4));
+#endif
+}
+
+template<> EIGEN_STRONG_INLINE Packet8f ploadu_cast<Packet8f, signed char>(const signed char* from) {
+#ifdef EIGEN_VECTORIZE_AVX2
+  return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(from))));
+#else
+  return pcast<Packet4i, Packet8f>(ploadu_cast<Packet4i>(from), ploadu_cast<Packet4i>(from + 4));
+#endif
+}
+
+template<> EIGEN_STRONG_INLINE Packet8f ploadu_cast<Packet8f, unsigned short>(const unsigned short* from) {
+#ifdef EIGEN_VECTORIZE_AVX2
+  return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(from))));
+#else
+  return pcast<Packet4i, Packet8f>(ploadu_cast<Packet4i>(from), ploadu_cast<Packet4i>(from + 4));
+#endif
+}
+
+template<> EIGEN_STRONG_INLINE Packet8f ploadu_cast<Packet8f, short>(const short* from) {
+#ifdef EIGEN_VECTORIZE_AVX2
+  return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(from))));
+#else
+  return pcast<Packet4i, Packet8f>(ploadu_cast<Packet4i>(from), ploadu_cast<Packet4i>(from + 4));
+#endif
+}
+
 } // end namespace internal
 
 } // end namespace Eigen
@@ -55,6 +55,7 @@ template<> struct packet_traits<float>  : default_packet_traits
     size = 16,
     HasHalfPacket = 1,
     HasBlend = 0,
+    HasIndexedGather = 1,
 #if EIGEN_GNUC_AT_LEAST(5, 3) || EIGEN_COMP_CLANG
 #ifdef EIGEN_VECTORIZE_AVX512DQ
     HasLog = 1,
@@ -75,6 +76,7 @@ template<> struct packet_traits<double> : default_packet_traits
     AlignedOnScalar = 1,
     size = 8,
     HasHalfPacket = 1,
+    HasIndexedGather = 1,
 #if EIGEN_GNUC_AT_LEAST(5, 3)
     HasSqrt = EIGEN_FAST_MATH,
     HasRsqrt = EIGEN_FAST_MATH,
@@ -590,6 +592,30 @@ EIGEN_DEVICE_FUNC inline void pscatter<double, Packet8d>(double* to,
   _mm512_i32scatter_pd(to, indices, from, 8);
 }
 
+template <>
+EIGEN_DEVICE_FUNC inline Packet16f pgather_indexed<float, Packet16f>(const float* from,
+                                                                     const int* indices) {
+  return _mm512_i32gather_ps(_mm512_loadu_si512(indices), from, 4);
+}
+template <>
+EIGEN_DEVICE_FUNC inline Packet8d pgather_indexed<double, Packet8d>(const double* from,
+                                                                    const int* indices) {
+  return _mm512_i32gather_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices)), from, 8);
+}
+
+template <>
+EIGEN_DEVICE_FUNC inline void pscatter_indexed<float, Packet16f>(float* to,
+                                                                 const Packet16f& from,
+                                                                 const int* indices) {
+  _mm512_i32scatter_ps(to, _mm512_loadu_si512(indices), from, 4);
+}
+template <>
+EIGEN_DEVICE_FUNC inline void pscatter_indexed<double, Packet8d>(double* to,
+                                                                 const Packet8d& from,
+                                                                 const int* indices) {
+  _mm512_i32scatter_pd(to, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices)), from, 8);
+}
+
 template <>
 EIGEN_STRONG_INLINE void pstore1<Packet16f>(float* to, const float& a) {
   Packet16f pa = pset1<Packet16f>(a);
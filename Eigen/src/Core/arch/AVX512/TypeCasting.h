@@ -0,0 +1,116 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_TYPE_CASTING_AVX512_H
+#define EIGEN_TYPE_CASTING_AVX512_H
+
+namespace Eigen {
+
+namespace internal {
+
+// The integers are handled by SSE packets, so a packet of ints holds a quarter of a packet of floats and a half
+// of a packet of doubles. The conversions from floats to ints would only use a quarter of the source packets,
+// and are left to the scalar path.
+template <>
+struct type_casting_traits<int, float> {
+  enum {
+    VectorizedCast = 1,
+    SrcCoeffRatio = 4,
+    TgtCoeffRatio = 1
+  };
+};
+
+template <>
+struct type_casting_traits<int, double> {
+  enum {
+    VectorizedCast = 1,
+    SrcCoeffRatio = 2,
+    TgtCoeffRatio = 1
+  };
+};
+
+template <>
+struct type_casting_traits<double, int> {
+  enum {
+    VectorizedCast = 1,
+    SrcCoeffRatio = 1,
+    TgtCoeffRatio = 2
+  };
+};
+
+template <>
+struct type_casting_traits<float, double> {
+  enum {
+    VectorizedCast = 1,
+    SrcCoeffRatio = 1,
+    TgtCoeffRatio = 2
+  };
+};
+
+template <>
+struct type_casting_traits<double, float> {
+  enum {
+    VectorizedCast = 1,
+    SrcCoeffRatio = 2,
+    TgtCoeffRatio = 1
+  };
+};
+
+template <> struct load_casting_traits<signed char, float> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<unsigned char, float> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<short, float> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<unsigned short, float> { enum { VectorizedLoad = 1 }; };
+
+template<> EIGEN_STRONG_INLINE Packet16f pcast<Packet4i, Packet16f>(const Packet4i& a, const Packet4i& b,
+                                                                    const Packet4i& c, const Packet4i& d) {
+  __m512i abcd = _mm512_castsi128_si512(a);
+  abcd = _mm512_inserti32x4(abcd, b, 1);
+  abcd = _mm512_inserti32x4(abcd, c, 2);
+  abcd = _mm512_inserti32x4(abcd, d, 3);
+  return _mm512_cvtepi32_ps(abcd);
+}
+
+template<> EIGEN_STRONG_INLINE Packet8d pcast<Packet4i, Packet8d>(const Packet4i& a, const Packet4i& b) {
+  return _mm512_cvtepi32_pd(_mm256_insertf128_si256(_mm256_castsi128_si256(a), b, 1));
+}
+
+template<> EIGEN_STRONG_INLINE Packet4i pcast<Packet8d, Packet4i>(const Packet8d& a) {
+  // Simply discard the second half of the input
+  return _mm256_castsi256_si128(_mm512_cvttpd_epi32(a));
+}
+
+template<> EIGEN_STRONG_INLINE Packet8d pcast<Packet16f, Packet8d>(const Packet16f& a) {
+  // Simply discard the second half of the input
+  return _mm512_cvtps_pd(_mm512_castps512_ps256(a));
+}
+
+template<> EIGEN_STRONG_INLINE Packet16f pcast<Packet8d, Packet16f>(const Packet8d& a, const Packet8d& b) {
+  return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castpd256_pd512(_mm256_castps_pd(_mm512_cvtpd_ps(a))),
+                                             _mm256_castps_pd(_mm512_cvtpd_ps(b)), 1));
+}
+
+template<> EIGEN_STRONG_INLINE Packet16f ploadu_cast<Packet16f, unsigned char>(const unsigned char* from) {
+  return _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(from))));
+}
+
+template<> EIGEN_STRONG_INLINE Packet16f ploadu_cast<Packet16f, signed char>(const signed char* from) {
+  return _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(from))));
+}
+
+template<> EIGEN_STRONG_INLINE Packet16f ploadu_cast<Packet16f, unsigned short>(const unsigned short* from) {
+  return _mm512_cvtepi32_ps(_mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(from))));
+}
+
+template<> EIGEN_STRONG_INLINE Packet16f ploadu_cast<Packet16f, short>(const short* from) {
+  return _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(from))));
+}
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_TYPE_CASTING_AVX512_H
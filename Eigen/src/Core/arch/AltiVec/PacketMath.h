@@ -165,7 +165,8 @@ template<> struct packet_traits<float>  : default_packet_traits
     HasFloor = 1,
     HasCeil = 1,
     HasNegate = 1,
-    HasBlend = 1
+    HasBlend = 1,
+    HasCmp = 1
   };
 };
 template<> struct packet_traits<int>    : default_packet_traits
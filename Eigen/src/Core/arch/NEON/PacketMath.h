@@ -110,12 +110,15 @@ template<> struct packet_traits<float>  : default_packet_traits
    
     HasDiv   = 1,
     HasFloor = 1,
+    HasCmp   = 1,
     // FIXME check the Has*
     HasSin  = 0,
     HasCos  = 0,
     HasLog  = 1,
     HasExp  = 1,
-    HasSqrt = 0
+    HasSqrt = 0,
+    HasLGamma = 1,
+    HasDiGamma = 1
   };
 };
 template<> struct packet_traits<int32_t>    : default_packet_traits
@@ -32,6 +32,14 @@ struct type_casting_traits<int, float> {
   };
 };
 
+template <> struct load_casting_traits<signed char, int> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<unsigned char, int> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<short, int> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<unsigned short, int> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<signed char, float> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<unsigned char, float> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<short, float> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<unsigned short, float> { enum { VectorizedLoad = 1 }; };
 
 template<> EIGEN_STRONG_INLINE Packet4i pcast<Packet4f, Packet4i>(const Packet4f& a) {
   return vcvtq_s32_f32(a);
@@ -41,6 +49,101 @@ template<> EIGEN_STRONG_INLINE Packet4f pcast<Packet4i, Packet4f>(const Packet4i
   return vcvtq_f32_s32(a);
 }
 
+// The 8 and 16 bits integers are widened in registers after a load of exactly 4 coefficients.
+template<> EIGEN_STRONG_INLINE Packet4i ploadu_cast<Packet4i, unsigned char>(const unsigned char* from) {
+  uint32_t bytes;
+  std::memcpy(&bytes, from, sizeof(bytes));
+  return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(bytes))))));
+}
+
+template<> EIGEN_STRONG_INLINE Packet4i ploadu_cast<Packet4i, signed char>(const signed char* from) {
+  uint32_t bytes;
+  std::memcpy(&bytes, from, sizeof(bytes));
+  return vmovl_s16(vget_low_s16(vmovl_s8(vreinterpret_s8_u32(vdup_n_u32(bytes)))));
+}
+
+template<> EIGEN_STRONG_INLINE Packet4i ploadu_cast<Packet4i, unsigned short>(const unsigned short* from) {
+  return vreinterpretq_s32_u32(vmovl_u16(vld1_u16(from)));
+}
+
+template<> EIGEN_STRONG_INLINE Packet4i ploadu_cast<Packet4i, short>(const short* from) {
+  return vmovl_s16(vld1_s16(from));
+}
+
+template<> EIGEN_STRONG_INLINE Packet4f ploadu_cast<Packet4f, unsigned char>(const unsigned char* from) {
+  return vcvtq_f32_s32(ploadu_cast<Packet4i>(from));
+}
+
+template<> EIGEN_STRONG_INLINE Packet4f ploadu_cast<Packet4f, signed char>(const signed char* from) {
+  return vcvtq_f32_s32(ploadu_cast<Packet4i>(from));
+}
+
+template<> EIGEN_STRONG_INLINE Packet4f ploadu_cast<Packet4f, unsigned short>(const unsigned short* from) {
+  return vcvtq_f32_s32(ploadu_cast<Packet4i>(from));
+}
+
+template<> EIGEN_STRONG_INLINE Packet4f ploadu_cast<Packet4f, short>(const short* from) {
+  return vcvtq_f32_s32(ploadu_cast<Packet4i>(from));
+}
+
+#if EIGEN_ARCH_ARM64 && !EIGEN_APPLE_DOUBLE_NEON_BUG
+
+template <>
+struct type_casting_traits<float, double> {
+  enum {
+    VectorizedCast = 1,
+    SrcCoeffRatio = 1,
+    TgtCoeffRatio = 2
+  };
+};
+
+template <>
+struct type_casting_traits<double, float> {
+  enum {
+    VectorizedCast = 1,
+    SrcCoeffRatio = 2,
+    TgtCoeffRatio = 1
+  };
+};
+
+template <>
+struct type_casting_traits<int, double> {
+  enum {
+    VectorizedCast = 1,
+    SrcCoeffRatio = 1,
+    TgtCoeffRatio = 2
+  };
+};
+
+template <>
+struct type_casting_traits<double, int> {
+  enum {
+    VectorizedCast = 1,
+    SrcCoeffRatio = 2,
+    TgtCoeffRatio = 1
+  };
+};
+
+template<> EIGEN_STRONG_INLINE Packet2d pcast<Packet4f, Packet2d>(const Packet4f& a) {
+  // Simply discard the second half of the input
+  return vcvt_f64_f32(vget_low_f32(a));
+}
+
+template<> EIGEN_STRONG_INLINE Packet4f pcast<Packet2d, Packet4f>(const Packet2d& a, const Packet2d& b) {
+  return vcombine_f32(vcvt_f32_f64(a), vcvt_f32_f64(b));
+}
+
+template<> EIGEN_STRONG_INLINE Packet2d pcast<Packet4i, Packet2d>(const Packet4i& a) {
+  // Simply discard the second half of the input
+  return vcvtq_f64_s64(vmovl_s32(vget_low_s32(a)));
+}
+
+template<> EIGEN_STRONG_INLINE Packet4i pcast<Packet2d, Packet4i>(const Packet2d& a, const Packet2d& b) {
+  return vcombine_s32(vmovn_s64(vcvtq_s64_f64(a)), vmovn_s64(vcvtq_s64_f64(b)));
+}
+
+#endif // EIGEN_ARCH_ARM64
+
 } // end namespace internal
 
 } // end namespace Eigen
@@ -110,7 +110,12 @@ template<> struct packet_traits<float>  : default_packet_traits
     HasSqrt = 1,
     HasRsqrt = 1,
     HasTanh  = EIGEN_FAST_MATH,
+    HasLGamma = 1,
+    HasDiGamma = 1,
+    HasI0e = 1,
+    HasI1e = 1,
     HasBlend = 1,
+    HasCmp = 1,
     HasFloor = 1
 
 #ifdef EIGEN_VECTORIZE_SSE4_1
@@ -134,7 +139,10 @@ template<> struct packet_traits<double> : default_packet_traits
     HasExp  = 1,
     HasSqrt = 1,
     HasRsqrt = 1,
-    HasBlend = 1
+    HasI0e = 1,
+    HasI1e = 1,
+    HasBlend = 1,
+    HasCmp = 1
 
 #ifdef EIGEN_VECTORIZE_SSE4_1
     ,
@@ -338,6 +346,22 @@ template<> EIGEN_STRONG_INLINE Packet4f pcmp_lt(const Packet4f& a, const Packet4
 template<> EIGEN_STRONG_INLINE Packet4f pcmp_eq(const Packet4f& a, const Packet4f& b) { return _mm_cmpeq_ps(a,b); }
 template<> EIGEN_STRONG_INLINE Packet4f pcmp_lt_or_nan(const Packet4f& a, const Packet4f& b) { return _mm_cmpnge_ps(a,b); }
 
+template<> EIGEN_STRONG_INLINE Packet2d pcmp_le(const Packet2d& a, const Packet2d& b) { return _mm_cmple_pd(a,b); }
+template<> EIGEN_STRONG_INLINE Packet2d pcmp_lt(const Packet2d& a, const Packet2d& b) { return _mm_cmplt_pd(a,b); }
+template<> EIGEN_STRONG_INLINE Packet2d pcmp_eq(const Packet2d& a, const Packet2d& b) { return _mm_cmpeq_pd(a,b); }
+template<> EIGEN_STRONG_INLINE Packet2d pcmp_lt_or_nan(const Packet2d& a, const Packet2d& b) { return _mm_cmpnge_pd(a,b); }
+
+template<> EIGEN_STRONG_INLINE bool pmask_any(const Packet4f& mask) { return _mm_movemask_ps(mask) != 0; }
+template<> EIGEN_STRONG_INLINE bool pmask_all(const Packet4f& mask) { return _mm_movemask_ps(mask) == 0xF; }
+
+template<> EIGEN_STRONG_INLINE bool pmask_any(const Packet2d& mask) { return _mm_movemask_pd(mask) != 0; }
+template<> EIGEN_STRONG_INLINE bool pmask_all(const Packet2d& mask) { return _mm_movemask_pd(mask) == 0x3; }
+
+#ifdef EIGEN_VECTORIZE_SSE4_1
+template<> EIGEN_STRONG_INLINE Packet4f pselect(const Packet4f& mask, const Packet4f& a, const Packet4f& b) { return _mm_blendv_ps(b,a,mask); }
+template<> EIGEN_STRONG_INLINE Packet2d pselect(const Packet2d& mask, const Packet2d& a, const Packet2d& b) { return _mm_blendv_pd(b,a,mask); }
+#endif
+
 template<> EIGEN_STRONG_INLINE Packet4f pand<Packet4f>(const Packet4f& a, const Packet4f& b) { return _mm_and_ps(a,b); }
 template<> EIGEN_STRONG_INLINE Packet2d pand<Packet2d>(const Packet2d& a, const Packet2d& b) { return _mm_and_pd(a,b); }
 template<> EIGEN_STRONG_INLINE Packet4i pand<Packet4i>(const Packet4i& a, const Packet4i& b) { return _mm_and_si128(a,b); }
@@ -482,6 +506,17 @@ template<> EIGEN_DEVICE_FUNC inline void pscatter<int, Packet4i>(int* to, const
   to[stride*3] = _mm_cvtsi128_si32(_mm_shuffle_epi32(from, 3));
 }
 
+#ifdef EIGEN_VECTORIZE_AVX2
+template<> EIGEN_DEVICE_FUNC inline Packet4f pgather_indexed<float, Packet4f>(const float* from, const int* indices)
+{
+  return _mm_i32gather_ps(from, _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices)), 4);
+}
+template<> EIGEN_DEVICE_FUNC inline Packet2d pgather_indexed<double, Packet2d>(const double* from, const int* indices)
+{
+  return _mm_i32gather_pd(from, _mm_loadl_epi64(reinterpret_cast<const __m128i*>(indices)), 8);
+}
+#endif
+
 // some compilers might be tempted to perform multiple moves instead of using a vector path.
 template<> EIGEN_STRONG_INLINE void pstore1<Packet4f>(float* to, const float& a)
 {
@@ -50,8 +50,37 @@ struct type_casting_traits<float, double> {
     TgtCoeffRatio = 2
   };
 };
+
+template <>
+struct type_casting_traits<int, double> {
+  enum {
+    VectorizedCast = 1,
+    SrcCoeffRatio = 1,
+    TgtCoeffRatio = 2
+  };
+};
+
+template <>
+struct type_casting_traits<double, int> {
+  enum {
+    VectorizedCast = 1,
+    SrcCoeffRatio = 2,
+    TgtCoeffRatio = 1
+  };
+};
+
+template <> struct load_casting_traits<signed char, float> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<unsigned char, float> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<short, float> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<unsigned short, float> { enum { VectorizedLoad = 1 }; };
 #endif
 
+// The integers are handled by SSE packets with AVX and AVX512 as well.
+template <> struct load_casting_traits<signed char, int> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<unsigned char, int> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<short, int> { enum { VectorizedLoad = 1 }; };
+template <> struct load_casting_traits<unsigned short, int> { enum { VectorizedLoad = 1 }; };
+
 template<> EIGEN_STRONG_INLINE Packet4i pcast<Packet4f, Packet4i>(const Packet4f& a) {
   return _mm_cvttps_epi32(a);
 }
@@ -69,6 +98,74 @@ template<> EIGEN_STRONG_INLINE Packet2d pcast<Packet4f, Packet2d>(const Packet4f
   return _mm_cvtps_pd(a);
 }
 
+template<> EIGEN_STRONG_INLINE Packet2d pcast<Packet4i, Packet2d>(const Packet4i& a) {
+  // Simply discard the second half of the input
+  return _mm_cvtepi32_pd(a);
+}
+
+template<> EIGEN_STRONG_INLINE Packet4i pcast<Packet2d, Packet4i>(const Packet2d& a, const Packet2d& b) {
+  return _mm_unpacklo_epi64(_mm_cvttpd_epi32(a), _mm_cvttpd_epi32(b));
+}
+
+// The 8 and 16 bits integers are widened in registers after a load of exactly 4 coefficients.
+template<> EIGEN_STRONG_INLINE Packet4i ploadu_cast<Packet4i, unsigned char>(const unsigned char* from) {
+  int bytes;
+  std::memcpy(&bytes, from, sizeof(bytes));
+  const __m128i a = _mm_cvtsi32_si128(bytes);
+#ifdef EIGEN_VECTORIZE_SSE4_1
+  return _mm_cvtepu8_epi32(a);
+#else
+  const __m128i zero = _mm_setzero_si128();
+  return _mm_unpacklo_epi16(_mm_unpacklo_epi8(a, zero), zero);
+#endif
+}
+
+template<> EIGEN_STRONG_INLINE Packet4i ploadu_cast<Packet4i, signed char>(const signed char* from) {
+  int bytes;
+  std::memcpy(&bytes, from, sizeof(bytes));
+  const __m128i a = _mm_cvtsi32_si128(bytes);
+#ifdef EIGEN_VECTORIZE_SSE4_1
+  return _mm_cvtepi8_epi32(a);
+#else
+  // the bytes are moved to the most significant bits of the lanes, and shifted back with their sign
+  return _mm_srai_epi32(_mm_unpacklo_epi16(_mm_unpacklo_epi8(a, a), _mm_unpacklo_epi8(a, a)), 24);
+#endif
+}
+
+template<> EIGEN_STRONG_INLINE Packet4i ploadu_cast<Packet4i, unsigned short>(const unsigned short* from) {
+  const __m128i a = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(from));
+#ifdef EIGEN_VECTORIZE_SSE4_1
+  return _mm_cvtepu16_epi32(a);
+#else
+  return _mm_unpacklo_epi16(a, _mm_setzero_si128());
+#endif
+}
+
+template<> EIGEN_STRONG_INLINE Packet4i ploadu_cast<Packet4i, short>(const short* from) {
+  const __m128i a = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(from));
+#ifdef EIGEN_VECTORIZE_SSE4_1
+  return _mm_cvtepi16_epi32(a);
+#else
+  return _mm_srai_epi32(_mm_unpacklo_epi16(a, a), 16);
+#endif
+}
+
+template<> EIGEN_STRONG_INLINE Packet4f ploadu_cast<Packet4f, unsigned char>(const unsigned char* from) {
+  return _mm_cvtepi32_ps(ploadu_cast<Packet4i>(from));
+}
+
+template<> EIGEN_STRONG_INLINE Packet4f ploadu_cast<Packet4f, signed char>(const signed char* from) {
+  return _mm_cvtepi32_ps(ploadu_cast<Packet4i>(from));
+}
+
+template<> EIGEN_STRONG_INLINE Packet4f ploadu_cast<Packet4f, unsigned short>(const unsigned short* from) {
+  return _mm_cvtepi32_ps(ploadu_cast<Packet4i>(from));
+}
+
+template<> EIGEN_STRONG_INLINE Packet4f ploadu_cast<Packet4f, short>(const short* from) {
+  return _mm_cvtepi32_ps(ploadu_cast<Packet4i>(from));
+}
+
 
 } // end namespace internal
 
@@ -14,6 +14,44 @@ namespace Eigen {
 
 namespace internal {
 
+/** \internal */
+inline ComplexProductAlgorithm& complex_product_algorithm()
+{
+  static ComplexProductAlgorithm algorithm = ComplexProductInterleaved;
+  return algorithm;
+}
+
+}
+
+/** \returns the algorithm computing the large products of complex matrices
+  * \sa setComplexProductAlgorithm */
+inline ComplexProductAlgorithm complexProductAlgorithm()
+{
+  return internal::complex_product_algorithm();
+}
+
+/** Selects the algorithm computing the large products of two complex matrices of the same scalar type
+  * (ComplexProductInterleaved by default).
+  *
+  * With ComplexProduct4M and ComplexProduct3M, the real and imaginary parts of the factors are copied to separate
+  * real matrices, which are multiplied by the real product kernel. This is faster on architectures where the complex
+  * kernel reaches a lower throughput than the real one, at the price of temporary buffers for twice the size of the
+  * factors and of the result.
+  * ComplexProduct4M performs the same operations as the complex kernel, and is as accurate.
+  * ComplexProduct3M saves a quarter of the operations, but the error on the imaginary part of the result is then
+  * only bounded relatively to the products of the magnitudes of the real and imaginary parts, which makes it less
+  * accurate when some coefficients of the result suffer from cancellation.
+  *
+  * The products of self-adjoint and triangular matrices, and the products with vectors, are not affected.
+  *
+  * \sa complexProductAlgorithm */
+inline void setComplexProductAlgorithm(ComplexProductAlgorithm algorithm)
+{
+  internal::complex_product_algorithm() = algorithm;
+}
+
+namespace internal {
+
 template<typename _LhsScalar, typename _RhsScalar> class level3_blocking;
 
 /* Specialization for a row-major destination matrix => simple transposition of the product */
@@ -83,73 +121,64 @@ static void run(Index rows, Index cols, Index depth,
   if(info)
   {
     // this is the parallel version!
-    int tid = omp_get_thread_num();
-    int threads = omp_get_num_threads();
+    // Each thread repeatedly pulls a tile of info->block_rows x nc coefficients of the result, and computes it
+    // as in the sequential version. The packed panels A'_i,k of the block of rows i are shared through the two
+    // slots of this block in blockA, the panel k using the slot k%2: a panel is packed by the first thread
+    // needing it, and reused by the others as long as the slot is not recycled.
+    // A thread never waits for a slow thread longer than it takes to pack its own copy of a panel.
+    // The tiles depend on info->threads only, and not on the number of threads actually running.
+    const Index threads = info->threads;
 
     LhsScalar* blockA = blocking.blockA();
     eigen_internal_assert(blockA!=0);
 
+    // split the columns such that there are at least as many tiles per block of rows as threads
+    nc = (std::min)(nc, numext::div_ceil(numext::div_ceil(cols, threads), Index(Traits::nr)) * Traits::nr);
+    const Index block_rows = info->block_rows;
+    const Index col_blocks = numext::div_ceil(cols, nc);
+    const Index tiles = info->row_blocks * col_blocks;
+    // with a single panel along the depth, a single slot per block of rows is needed
+    const Index slots = depth>kc ? 2 : 1;
+    // the second slots start on a multiple of mr rows to preserve the alignment of the packed panels
+    const Index slot_size = numext::div_ceil(rows, Index(Traits::mr)) * Traits::mr * kc;
+
+    std::size_t sizeA = kc*block_rows;
     std::size_t sizeB = kc*nc;
+    ei_declare_aligned_stack_constructed_variable(LhsScalar, privateA, sizeA, 0);
     ei_declare_aligned_stack_constructed_variable(RhsScalar, blockB, sizeB, 0);
 
-    // For each horizontal panel of the rhs, and corresponding vertical panel of the lhs...
-    for(Index k=0; k<depth; k+=kc)
+    // Consecutive tiles belong to the same block of rows, so that the threads working at the same time
+    // are likely to share its panels.
+    for(Index tile=info->nextTile(); tile<tiles; tile=info->nextTile())
     {
-      const Index actual_kc = (std::min)(k+kc,depth)-k; // => rows of B', and cols of the A'
+      const Index i = tile / col_blocks;
+      const Index i2 = i*block_rows;
+      const Index actual_mc = (std::min)(i2+block_rows,rows)-i2;
+      const Index j2 = (tile % col_blocks) * nc;
+      const Index actual_nc = (std::min)(j2+nc,cols)-j2;
 
-      // In order to reduce the chance that a thread has to wait for the other,
-      // let's start by packing B'.
-      pack_rhs(blockB, rhs.getSubMapper(k,0), actual_kc, nc);
-
-      // Pack A_k to A' in a parallel fashion:
-      // each thread packs the sub block A_k,i to A'_i where i is the thread id.
-
-      // However, before copying to A'_i, we have to make sure that no other thread is still using it,
-      // i.e., we test that info[tid].users equals 0.
-      // Then, we set info[tid].users to the number of threads to mark that all other threads are going to use it.
-      while(info[tid].users!=0) {}
-      info[tid].users = threads;
-
-      pack_lhs(blockA+info[tid].lhs_start*actual_kc, lhs.getSubMapper(info[tid].lhs_start,k), actual_kc, info[tid].lhs_length);
-
-      // Notify the other threads that the part A'_i is ready to go.
-      info[tid].sync = k;
-
-      // Computes C_i += A' * B' per A'_i
-      for(int shift=0; shift<threads; ++shift)
+      for(Index k2=0; k2<depth; k2+=kc)
       {
-        int i = (tid+shift)%threads;
-
-        // At this point we have to make sure that A'_i has been updated by the thread i,
-        // we use testAndSetOrdered to mimic a volatile access.
-        // However, no need to wait for the B' part which has been updated by the current thread!
-        if (shift>0) {
-          while(info[i].sync!=k) {
-          }
-        }
+        const Index actual_kc = (std::min)(k2+kc,depth)-k2;
+        const Index k = k2/kc;
 
-        gebp(res.getSubMapper(info[i].lhs_start, 0), blockA+info[i].lhs_start*actual_kc, blockB, info[i].lhs_length, actual_kc, nc, alpha);
-      }
+        // Pack B' first, which leaves some time to another thread packing the shared A'_i,k.
+        pack_rhs(blockB, rhs.getSubMapper(k2,j2), actual_kc, actual_nc);
 
-      // Then keep going as usual with the remaining B'
-      for(Index j=nc; j<cols; j+=nc)
-      {
-        const Index actual_nc = (std::min)(j+nc,cols)-j;
+        GemmParallelPanel<Index>& panel = info->panel(i, k%slots);
+        LhsScalar* sharedA = blockA + (k%slots)*slot_size + i2*kc;
+        typename GemmParallelPanel<Index>::Status status = panel.acquire(k, actual_mc*actual_kc);
+        if(status!=GemmParallelPanel<Index>::Shared)
+          pack_lhs(status==GemmParallelPanel<Index>::Pack ? sharedA : privateA, lhs.getSubMapper(i2,k2), actual_kc, actual_mc);
+        if(status==GemmParallelPanel<Index>::Pack)
+          panel.publish();
 
-        // pack B_k,j to B'
-        pack_rhs(blockB, rhs.getSubMapper(k,j), actual_kc, actual_nc);
+        gebp(res.getSubMapper(i2, j2), status==GemmParallelPanel<Index>::Private ? privateA : sharedA, blockB,
+             actual_mc, actual_kc, actual_nc, alpha);
 
-        // C_j += A' * B'
-        gebp(res.getSubMapper(0, j), blockA, blockB, rows, actual_kc, actual_nc, alpha);
+        if(status!=GemmParallelPanel<Index>::Private)
+          panel.release();
       }
-
-      // Release all the sub blocks A'_i of A' for the current thread,
-      // i.e., we simply decrement the number of users by 1
-      for(Index i=0; i<threads; ++i)
-#if !EIGEN_HAS_CXX11_ATOMIC
-        #pragma omp atomic
-#endif
-        info[i].users -= 1;
     }
   }
   else
@@ -371,7 +400,9 @@ class gemm_blocking_space<StorageOrder,_LhsScalar,_RhsScalar,MaxRows, MaxCols, M
       eigen_internal_assert(this->m_blockA==0 && this->m_blockB==0);
       Index m = this->m_mc;
       computeProductBlockingSizes<LhsScalar,RhsScalar,KcFactor>(this->m_kc, m, this->m_nc, num_threads);
-      m_sizeA = this->m_mc * this->m_kc;
+      // blockA holds two panels of the whole lhs, such that the next one can be packed while the current one is in use
+      m_sizeA = this->m_kc<depth ? 2 * numext::div_ceil(this->m_mc, Index(Traits::mr)) * Traits::mr * this->m_kc
+                                 : this->m_mc * this->m_kc;
       m_sizeB = this->m_kc * this->m_nc;
     }
 
@@ -404,6 +435,88 @@ class gemm_blocking_space<StorageOrder,_LhsScalar,_RhsScalar,MaxRows, MaxCols, M
 
 namespace internal {
 
+/* Products of complex matrices computed by the real product kernel, see setComplexProductAlgorithm() */
+template<typename LhsScalar, typename RhsScalar,
+         bool Enable = is_same<LhsScalar,RhsScalar>::value && NumTraits<LhsScalar>::IsComplex>
+struct gemm_real_planes
+{
+  enum { Enabled = 0 };
+
+  template<typename Dest, typename Lhs, typename Rhs, typename Scalar>
+  static void run(Dest&, const Lhs&, const Rhs&, const Scalar&, bool, bool, ComplexProductAlgorithm) {}
+};
+
+template<typename Scalar>
+struct gemm_real_planes<Scalar,Scalar,true>
+{
+  enum { Enabled = 1 };
+
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+
+  template<typename Xpr, typename Plane>
+  static void split(const Xpr& xpr, Plane& re, Plane& im)
+  {
+    re = xpr.real();
+    im = xpr.imag();
+  }
+
+  template<typename Dest, typename Lhs, typename Rhs>
+  static void run(Dest& dst, const Lhs& lhs, const Rhs& rhs, const Scalar& alpha, bool conjLhs, bool conjRhs,
+                  ComplexProductAlgorithm algorithm)
+  {
+    // the planes keep the storage orders of the factors and of the result, so that they are split and
+    // accumulated linearly
+    typedef Map<Matrix<RealScalar,Dynamic,Dynamic,(Lhs::Flags&RowMajorBit) ? RowMajor : ColMajor>,AlignedMax> LhsPlane;
+    typedef Map<Matrix<RealScalar,Dynamic,Dynamic,(Rhs::Flags&RowMajorBit) ? RowMajor : ColMajor>,AlignedMax> RhsPlane;
+    typedef Map<Matrix<RealScalar,Dynamic,Dynamic,(Dest::Flags&RowMajorBit) ? RowMajor : ColMajor>,AlignedMax> ResPlane;
+
+    const Index rows = lhs.rows(), cols = rhs.cols(), depth = lhs.cols();
+    // each plane starts on a multiple of 16 coefficients to preserve the alignment
+    const Index lhsSize = numext::div_ceil(rows*depth, Index(16)) * 16;
+    const Index rhsSize = numext::div_ceil(depth*cols, Index(16)) * 16;
+    const Index resSize = numext::div_ceil(rows*cols, Index(16)) * 16;
+    ei_declare_aligned_stack_constructed_variable(RealScalar, planes, 2*(lhsSize+rhsSize+resSize), 0);
+    LhsPlane lhsRe(planes, rows, depth), lhsIm(planes+lhsSize, rows, depth);
+    RhsPlane rhsRe(planes+2*lhsSize, depth, cols), rhsIm(planes+2*lhsSize+rhsSize, depth, cols);
+    ResPlane resRe(planes+2*(lhsSize+rhsSize), rows, cols), resIm(planes+2*(lhsSize+rhsSize)+resSize, rows, cols);
+
+    // alpha is applied to the planes of the lhs
+    if(conjLhs) split(alpha*lhs.conjugate(), lhsRe, lhsIm);
+    else        split(alpha*lhs, lhsRe, lhsIm);
+    if(conjRhs) split(rhs.conjugate(), rhsRe, rhsIm);
+    else        split(rhs, rhsRe, rhsIm);
+
+    if(algorithm==ComplexProduct3M)
+    {
+      // re = Ar*Br - Ai*Bi, and im = (Ar+Ai)*(Br+Bi) - (Ar*Br + Ai*Bi)
+      resRe.noalias() = lhsRe*rhsRe;
+      resIm.noalias() = lhsIm*rhsIm;
+      RealScalar* re = resRe.data();
+      RealScalar* im = resIm.data();
+      for(Index k=0; k<rows*cols; ++k)
+      {
+        const RealScalar rr = re[k], ii = im[k];
+        re[k] = rr - ii;
+        im[k] = -(rr + ii);
+      }
+      lhsRe += lhsIm;
+      rhsRe += rhsIm;
+      resIm.noalias() += lhsRe*rhsRe;
+    }
+    else
+    {
+      // re = Ar*Br - Ai*Bi, and im = Ar*Bi + Ai*Br
+      resRe.noalias() = lhsRe*rhsRe;
+      resRe.noalias() -= lhsIm*rhsIm;
+      resIm.noalias() = lhsRe*rhsIm;
+      resIm.noalias() += lhsIm*rhsRe;
+    }
+
+    dst.real().array() += resRe.array();
+    dst.imag().array() += resIm.array();
+  }
+};
+
 template<typename Lhs, typename Rhs>
 struct generic_product_impl<Lhs,Rhs,DenseShape,DenseShape,GemmProduct>
   : generic_product_impl_base<Lhs,Rhs,generic_product_impl<Lhs,Rhs,DenseShape,DenseShape,GemmProduct> >
@@ -475,6 +588,14 @@ struct generic_product_impl<Lhs,Rhs,DenseShape,DenseShape,GemmProduct>
     Scalar actualAlpha = alpha * LhsBlasTraits::extractScalarFactor(a_lhs)
                                * RhsBlasTraits::extractScalarFactor(a_rhs);
 
+    typedef internal::gemm_real_planes<LhsScalar,RhsScalar> RealPlanes;
+    if(RealPlanes::Enabled && complexProductAlgorithm()!=ComplexProductInterleaved)
+    {
+      RealPlanes::run(dst, lhs, rhs, actualAlpha, bool(LhsBlasTraits::NeedToConjugate), bool(RhsBlasTraits::NeedToConjugate),
+                      complexProductAlgorithm());
+      return;
+    }
+
     typedef internal::gemm_blocking_space<(Dest::Flags&RowMajorBit) ? RowMajor : ColMajor,LhsScalar,RhsScalar,
             Dest::MaxRowsAtCompileTime,Dest::MaxColsAtCompileTime,MaxDepthAtCompileTime> BlockingType;
 
@@ -64,6 +64,7 @@ EIGEN_DEVICE_FUNC EIGEN_DONT_INLINE void general_matrix_vector_product<Index,Lhs
         ResScalar* res, Index resIncr,
   RhsScalar alpha)
 {
+  EIGEN_PROFILE_KERNEL("gemv", rows, 1, cols, 2.*double(rows)*double(cols));
   EIGEN_UNUSED_VARIABLE(resIncr);
   eigen_internal_assert(resIncr==1);
 
@@ -247,6 +248,7 @@ EIGEN_DEVICE_FUNC EIGEN_DONT_INLINE void general_matrix_vector_product<Index,Lhs
   ResScalar* res, Index resIncr,
   ResScalar alpha)
 {
+  EIGEN_PROFILE_KERNEL("gemv", rows, 1, cols, 2.*double(rows)*double(cols));
   // The following copy tells the compiler that lhs's attributes are not modified outside this function
   // This helps GCC to generate propoer code.
   LhsMapper lhs(alhs);
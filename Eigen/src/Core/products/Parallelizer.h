@@ -14,6 +14,11 @@
 #include <atomic>
 #endif
 
+// Number of threads a matrix product is split for in deterministic mode, see setDeterministicParallelism()
+#ifndef EIGEN_GEMM_DETERMINISTIC_SPLIT
+#define EIGEN_GEMM_DETERMINISTIC_SPLIT 8
+#endif
+
 namespace Eigen {
 
 namespace internal {
@@ -75,29 +80,195 @@ inline void setNbThreads(int v)
 
 namespace internal {
 
-template<typename Index> struct GemmParallelInfo
+/** \internal */
+inline bool& deterministic_parallelism()
+{
+  static bool enabled = false;
+  return enabled;
+}
+
+}
+
+/** \returns whether the deterministic mode of the parallel algorithms is enabled
+  * \sa setDeterministicParallelism */
+inline bool deterministicParallelism()
+{
+  return internal::deterministic_parallelism();
+}
+
+/** Enables or disables the deterministic mode of the parallel algorithms (disabled by default).
+  *
+  * In this mode, a parallel matrix product is split into tiles as if it ran on EIGEN_GEMM_DETERMINISTIC_SPLIT
+  * threads, whatever the number of threads actually used. Its result is then bitwise identical for any value
+  * of nbThreads(), at the price of a less even distribution of the work when running on many more threads.
+  * Likewise, the long vectors whose stableNorm() or blueNorm() is reduced in parallel are split into at most
+  * EIGEN_GEMM_DETERMINISTIC_SPLIT chunks, depending on their size only.
+  *
+  * \sa deterministicParallelism, setNbThreads */
+inline void setDeterministicParallelism(bool enable)
+{
+  internal::deterministic_parallelism() = enable;
+}
+
+namespace internal {
+
+// volatile is not enough on all architectures (see bug 1572)
+// to guarantee that when thread A says to thread B that it is
+// done with packing a block, then all writes have been really
+// carried out... C++11 memory model+atomic guarantees this.
+// Without it, the compare-and-swap operations are emulated by an OpenMP critical section.
+#if !EIGEN_HAS_CXX11_ATOMIC
+template<typename T> bool gemm_parallel_compare_exchange(T volatile& x, T expected, T desired)
+{
+  bool done = false;
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp critical(EigenGemmParallel)
+#endif
+  if(x==expected)
+  {
+    x = desired;
+    done = true;
+  }
+  return done;
+}
+#endif
+
+/** \internal
+  * Slot of the shared buffer of the parallel GEMM holding a packed panel A'_i,k of the lhs for a block of rows i.
+  * The panel is shared through reference counting: \c users is the number of threads currently reading the
+  * panel \c k, or -1 while a thread is packing it. A new panel can be packed into the slot only once all the
+  * users of the previous one released it.
+  */
+template<typename Index> struct GemmParallelPanel
 {
-  GemmParallelInfo() : sync(-1), users(0), lhs_start(0), lhs_length(0) {}
+  enum Status {
+    Shared,   // the slot holds the requested panel, which must be released after use
+    Pack,     // the caller must pack the requested panel into the slot, and then publish() it
+    Private   // the slot is busy with another panel, the caller has to pack its own copy
+  };
 
-  // volatile is not enough on all architectures (see bug 1572)
-  // to guarantee that when thread A says to thread B that it is
-  // done with packing a block, then all writes have been really
-  // carried out... C++11 memory model+atomic guarantees this.
+  GemmParallelPanel() : k(-1), users(0) {}
+
+  /* Acquires the panel \a panel of the slot, spinning at most \a max_spin iterations while another
+   * thread is packing it. Waiting longer than the time it takes to pack a private copy would be pointless. */
+  Status acquire(Index panel, Index max_spin)
+  {
+    for(Index spin=0; spin<max_spin; ++spin)
+    {
+      int u = users;
+      if(u<0)
+      {
+        // someone is packing, wait only if this is the requested panel
+        if(k!=panel)
+          return Private;
+        continue;
+      }
+      Index current = k;
+      if(current==panel)
+      {
+        // k cannot change once we hold a reference, but it might have changed before
+        if(compareExchange(u, u+1))
+        {
+          if(k==panel)
+            return Shared;
+          release();
+        }
+      }
+      else if(current<panel && u==0)
+      {
+        if(compareExchange(0, -1))
+        {
+          k = panel;
+          return Pack;
+        }
+      }
+      else
+        return Private;
+    }
+    return Private;
+  }
+
+  /* Makes the panel packed after acquire() returned Pack available to the other threads,
+   * the caller becoming its first user. */
+  void publish()
+  {
 #if EIGEN_HAS_CXX11_ATOMIC
-  std::atomic<Index> sync;
+    users.store(1, std::memory_order_release);
+#else
+    gemm_parallel_compare_exchange(users, -1, 1);
+#endif
+  }
+
+  void release()
+  {
+#if (!EIGEN_HAS_CXX11_ATOMIC) && defined(EIGEN_HAS_OPENMP)
+    #pragma omp atomic
+#endif
+    users -= 1;
+  }
+
+#if EIGEN_HAS_CXX11_ATOMIC
+  std::atomic<Index> k;
   std::atomic<int> users;
+
+  bool compareExchange(int expected, int desired) { return users.compare_exchange_strong(expected, desired); }
 #else
-  Index volatile sync;
+  Index volatile k;
   int volatile users;
+
+  bool compareExchange(int expected, int desired) { return gemm_parallel_compare_exchange(users, expected, desired); }
 #endif
+};
+
+/** \internal
+  * State shared by the threads of a parallel GEMM.
+  *
+  * The result is split into tiles of \c block_rows rows times nc columns which are distributed dynamically:
+  * each thread pulls the next tile from the counter \c next_tile and computes it for the whole depth.
+  * A thread lagging behind, e.g., because it has been preempted, thus only delays its own tile.
+  * Each block of rows owns two slots of packed lhs panels, such that the next panel can be packed while the
+  * current one is still in use.
+  */
+template<typename Index> struct GemmParallelInfo
+{
+  GemmParallelInfo(Index rows, Index threads_, Index block_rows_, GemmParallelPanel<Index>* panels_)
+    : next_tile(0), threads(threads_), block_rows(block_rows_), row_blocks(numext::div_ceil(rows, block_rows_)),
+      panels(panels_)
+  {}
 
-  Index lhs_start;
-  Index lhs_length;
+  /* \returns the index of the next tile to compute */
+  Index nextTile()
+  {
+#if EIGEN_HAS_CXX11_ATOMIC
+    return next_tile.fetch_add(1, std::memory_order_relaxed);
+#else
+    Index tile;
+    do {
+      tile = next_tile;
+    } while(!gemm_parallel_compare_exchange(next_tile, tile, tile+1));
+    return tile;
+#endif
+  }
+
+  /* \returns the slot \a slot of the lhs panels of the block of rows \a i */
+  GemmParallelPanel<Index>& panel(Index i, Index slot) { return panels[2*i+slot]; }
+
+#if EIGEN_HAS_CXX11_ATOMIC
+  std::atomic<Index> next_tile;
+#else
+  Index volatile next_tile;
+#endif
+  Index threads;     // number of threads the product is split for
+  Index block_rows;
+  Index row_blocks;
+  GemmParallelPanel<Index>* panels;
 };
 
 template<bool Condition, typename Functor, typename Index>
 void parallelize_gemm(const Functor& func, Index rows, Index cols, Index depth, bool transpose)
 {
+  EIGEN_PROFILE_KERNEL("gemm", rows, cols, depth, 2.*double(rows)*double(cols)*double(depth));
+
   // TODO when EIGEN_USE_BLAS is defined,
   // we should still enable OMP for other scalar types
   // Without C++11, we have to disable GEMM's parallelization on
@@ -133,41 +304,41 @@ void parallelize_gemm(const Functor& func, Index rows, Index cols, Index depth,
   // compute the number of threads we are going to use
   Index threads = std::min<Index>(nbThreads(), pb_max_threads);
 
-  // if multi-threading is explicitly disabled, not useful, or if we already are in a parallel session,
-  // then abort multi-threading
+  // if we already are in a parallel session, the product runs on the calling thread only
   // FIXME omp_get_num_threads()>1 only works for openmp, what if the user does not use openmp?
-  if((!Condition) || (threads==1) || (omp_get_num_threads()>1))
+  if(omp_get_num_threads()>1)
+    threads = 1;
+
+  // In deterministic mode, the product is split independently of the number of threads actually used,
+  // including when it runs on a single one.
+  const Index split_threads = deterministicParallelism()
+                            ? std::min<Index>(EIGEN_GEMM_DETERMINISTIC_SPLIT, pb_max_threads)
+                            : threads;
+
+  // if multi-threading is explicitly disabled or not useful, then abort multi-threading
+  if((!Condition) || (split_threads==1))
     return func(0,rows, 0,cols);
 
   Eigen::initParallel();
-  func.initParallelSession(threads);
+  func.initParallelSession(split_threads);
 
-  if(transpose)
-    std::swap(rows,cols);
+  // The product kernel computes the transposed product when the destination is row-major.
+  // Its rows are split into one block per thread, the columns being split further by the kernel itself.
+  const Index kernel_rows = transpose ? cols : rows;
+  Index block_rows = numext::div_ceil(kernel_rows, split_threads);
+  block_rows = numext::div_ceil(block_rows, Index(Functor::Traits::mr)) * Functor::Traits::mr;
+  const Index row_blocks = numext::div_ceil(kernel_rows, block_rows);
 
-  ei_declare_aligned_stack_constructed_variable(GemmParallelInfo<Index>,info,threads,0);
+  ei_declare_aligned_stack_constructed_variable(GemmParallelPanel<Index>,panels,2*row_blocks,0);
+  GemmParallelInfo<Index> info(kernel_rows, split_threads, block_rows, panels);
 
-  #pragma omp parallel num_threads(threads)
+  // all the threads run the whole product, sharing its tiles through info
+  if(threads==1)
+    func(0, rows, 0, cols, &info);
+  else
   {
-    Index i = omp_get_thread_num();
-    // Note that the actual number of threads might be lower than the number of request ones.
-    Index actual_threads = omp_get_num_threads();
-
-    Index blockCols = (cols / actual_threads) & ~Index(0x3);
-    Index blockRows = (rows / actual_threads);
-    blockRows = (blockRows/Functor::Traits::mr)*Functor::Traits::mr;
-
-    Index r0 = i*blockRows;
-    Index actualBlockRows = (i+1==actual_threads) ? rows-r0 : blockRows;
-
-    Index c0 = i*blockCols;
-    Index actualBlockCols = (i+1==actual_threads) ? cols-c0 : blockCols;
-
-    info[i].lhs_start = r0;
-    info[i].lhs_length = actualBlockRows;
-
-    if(transpose) func(c0, actualBlockCols, 0, rows, info);
-    else          func(0, rows, c0, actualBlockCols, info);
+    #pragma omp parallel num_threads(threads)
+    func(0, rows, 0, cols, &info);
   }
 #endif
 }
@@ -496,6 +496,18 @@ enum ProductImplType
   * Enum used in experimental parallel implementation. */
 enum Action {GetAction, SetAction};
 
+/** \ingroup enums
+  * Enum selecting how the large products of complex matrices are computed, see setComplexProductAlgorithm(). */
+enum ComplexProductAlgorithm {
+  /** The complex matrices are multiplied by the complex product kernel (default). */
+  ComplexProductInterleaved = 0,
+  /** The product is computed from the four real products of the real and imaginary parts of the factors. */
+  ComplexProduct4M = 1,
+  /** The product is computed from three real products only, of the real parts, of the imaginary parts, and of the
+    * sums of the real and imaginary parts of the factors (3M method). */
+  ComplexProduct3M = 2
+};
+
 /** The type used to identify a dense storage. */
 struct Dense {};
 
@@ -0,0 +1,260 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_PROFILING_H
+#define EIGEN_PROFILING_H
+
+/** \internal \def EIGEN_PROFILE_KERNEL(NAME, ROWS, COLS, DEPTH, FLOPS)
+  * Reports the enclosing scope to the profiling hooks as one call of the kernel \a NAME, when
+  * EIGEN_PROFILING_HOOKS is defined. Otherwise it expands to nothing and its arguments are not evaluated.
+  */
+#if defined(EIGEN_PROFILING_HOOKS) && !defined(EIGEN_GPU_COMPILE_PHASE)
+
+#if !EIGEN_HAS_CXX11
+#error EIGEN_PROFILING_HOOKS requires C++11
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Eigen {
+
+/** \ingroup Core_Module
+  *
+  * \brief Description of a call to an instrumented kernel, passed to the profiling hooks
+  *
+  * The instrumented kernels are the matrix-matrix (\c "gemm") and matrix-vector (\c "gemv") products, the
+  * factorizations of SimplicialLLT/SimplicialLDLT (\c "simplicial_cholesky_factorize") and SparseLU
+  * (\c "sparse_lu_factorize"), and the evaluation of tensor expressions (\c "tensor_executor").
+  *
+  * \sa setProfilingHooks(), ProfilingCollector
+  */
+struct ProfilingEvent
+{
+  /** name of the kernel */
+  const char* kernel;
+  /** source location of the instrumentation point, identifying the call site together with the kernel name */
+  const char* file;
+  int line;
+  /** dimensions of the problem: rows, columns and inner dimension of a product; rows, columns and number of
+    * nonzeros of a sparse factorization; number of coefficients of a tensor expression, the others being 1 */
+  Index rows, cols, depth;
+  /** estimated number of floating point operations, or 0 when it is unknown */
+  double flops;
+  /** hash of the id of the calling thread */
+  std::size_t threadId;
+  /** duration of the call in seconds, only set in the end event */
+  double seconds;
+};
+
+/** \ingroup Core_Module
+  * Signature of the profiling hooks, \a userData is the pointer passed to setProfilingHooks() */
+typedef void (*ProfilingHook)(const ProfilingEvent& event, void* userData);
+
+namespace internal {
+
+struct profiling_hooks
+{
+  ProfilingHook begin;
+  ProfilingHook end;
+  void* userData;
+};
+
+inline profiling_hooks& get_profiling_hooks()
+{
+  static profiling_hooks hooks = { 0, 0, 0 };
+  return hooks;
+}
+
+class profiling_scope
+{
+  public:
+    profiling_scope(const char* kernel, const char* file, int line, Index rows, Index cols, Index depth, double flops)
+    {
+      const profiling_hooks& hooks = get_profiling_hooks();
+      m_active = hooks.begin!=0 || hooks.end!=0;
+      if(!m_active)
+        return;
+      m_event.kernel = kernel;
+      m_event.file = file;
+      m_event.line = line;
+      m_event.rows = rows;
+      m_event.cols = cols;
+      m_event.depth = depth;
+      m_event.flops = flops;
+      m_event.threadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+      m_event.seconds = 0;
+      if(hooks.begin)
+        hooks.begin(m_event, hooks.userData);
+      m_start = std::chrono::steady_clock::now();
+    }
+
+    ~profiling_scope()
+    {
+      if(!m_active)
+        return;
+      m_event.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+      const profiling_hooks& hooks = get_profiling_hooks();
+      if(hooks.end)
+        hooks.end(m_event, hooks.userData);
+    }
+
+  private:
+    bool m_active;
+    ProfilingEvent m_event;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+} // end namespace internal
+
+/** \ingroup Core_Module
+  * Installs the callbacks called at the beginning and at the end of each call to an instrumented kernel.
+  * Either hook can be null. The hooks may be called concurrently from several threads, and should be installed
+  * before any instrumented kernel runs.
+  *
+  * This function, like the instrumentation itself, only exists when EIGEN_PROFILING_HOOKS is defined.
+  *
+  * \sa ProfilingEvent, ProfilingCollector, clearProfilingHooks() */
+inline void setProfilingHooks(ProfilingHook begin, ProfilingHook end, void* userData = 0)
+{
+  internal::profiling_hooks& hooks = internal::get_profiling_hooks();
+  hooks.begin = begin;
+  hooks.end = end;
+  hooks.userData = userData;
+}
+
+/** \ingroup Core_Module
+  * Removes the profiling hooks. \sa setProfilingHooks() */
+inline void clearProfilingHooks()
+{
+  setProfilingHooks(0, 0, 0);
+}
+
+/** \ingroup Core_Module
+  *
+  * \brief Default profiling hook aggregating per call site statistics
+  *
+  * \code
+  * ProfilingCollector collector;
+  * collector.install();
+  * // ... run some Eigen code ...
+  * collector.report(std::cout);
+  * \endcode
+  *
+  * A call site is an instrumentation point inside %Eigen, identified by the kernel name and the source location.
+  * The times of nested kernels, like the products performed by SparseLU, are included in the time of the
+  * enclosing kernel.
+  */
+class ProfilingCollector
+{
+  public:
+    struct Statistics
+    {
+      std::string kernel;
+      std::string site;
+      Index calls;
+      double totalSeconds;
+      double minSeconds;
+      double maxSeconds;
+      double totalFlops;
+    };
+
+    /** Installs this collector as the end hook */
+    void install() { setProfilingHooks(0, &ProfilingCollector::collect, this); }
+
+    /** Removes the hooks if this collector is installed */
+    void uninstall()
+    {
+      if(internal::get_profiling_hooks().userData==this)
+        clearProfilingHooks();
+    }
+
+    ~ProfilingCollector() { uninstall(); }
+
+    /** Forgets all the collected statistics */
+    void reset()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_statistics.clear();
+    }
+
+    /** \returns the statistics of each call site, by decreasing total time */
+    std::vector<Statistics> statistics() const
+    {
+      std::vector<Statistics> result;
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for(std::map<std::string,Statistics>::const_iterator it=m_statistics.begin(); it!=m_statistics.end(); ++it)
+          result.push_back(it->second);
+      }
+      std::sort(result.begin(), result.end(), byTotalTime);
+      return result;
+    }
+
+    /** Prints the statistics of each call site, by decreasing total time */
+    void report(std::ostream& s) const
+    {
+      std::vector<Statistics> stats = statistics();
+      for(std::size_t i=0; i<stats.size(); ++i)
+      {
+        const Statistics& st = stats[i];
+        s << st.kernel << " (" << st.site << "): " << st.calls << " calls, " << st.totalSeconds << " s total, "
+          << st.totalSeconds/double(st.calls) << " s mean, " << st.minSeconds << " s min, " << st.maxSeconds << " s max";
+        if(st.totalFlops>0)
+          s << ", " << 1e-9*st.totalFlops/st.totalSeconds << " GFLOP/s";
+        s << "\n";
+      }
+    }
+
+  protected:
+    static bool byTotalTime(const Statistics& a, const Statistics& b) { return a.totalSeconds > b.totalSeconds; }
+
+    static void collect(const ProfilingEvent& event, void* userData)
+    {
+      ProfilingCollector* self = static_cast<ProfilingCollector*>(userData);
+      std::string file(event.file);
+      std::string::size_type slash = file.find_last_of("/\\");
+      std::string site = (slash==std::string::npos ? file : file.substr(slash+1)) + ":" + std::to_string(event.line);
+
+      std::lock_guard<std::mutex> lock(self->m_mutex);
+      std::map<std::string,Statistics>::iterator it = self->m_statistics.find(site + event.kernel);
+      if(it==self->m_statistics.end())
+      {
+        Statistics st = { event.kernel, site, 0, 0, event.seconds, event.seconds, 0 };
+        it = self->m_statistics.insert(std::make_pair(site + event.kernel, st)).first;
+      }
+      Statistics& st = it->second;
+      ++st.calls;
+      st.totalSeconds += event.seconds;
+      st.minSeconds = (std::min)(st.minSeconds, event.seconds);
+      st.maxSeconds = (std::max)(st.maxSeconds, event.seconds);
+      st.totalFlops += event.flops;
+    }
+
+    mutable std::mutex m_mutex;
+    std::map<std::string,Statistics> m_statistics;
+};
+
+} // end namespace Eigen
+
+#define EIGEN_PROFILE_KERNEL(NAME, ROWS, COLS, DEPTH, FLOPS) \
+  ::Eigen::internal::profiling_scope eigen_profiling_scope(NAME, __FILE__, __LINE__, ROWS, COLS, DEPTH, FLOPS)
+
+#else
+
+#define EIGEN_PROFILE_KERNEL(NAME, ROWS, COLS, DEPTH, FLOPS)
+
+#endif // EIGEN_PROFILING_HOOKS
+
+#endif // EIGEN_PROFILING_H
@@ -50,24 +50,79 @@ struct sparse_time_dense_product_impl<SparseLhsType,DenseRhsType,DenseResType, t
       {
         #pragma omp parallel for schedule(dynamic,(n+threads*4-1)/(threads*4)) num_threads(threads)
         for(Index i=0; i<n; ++i)
-          processRow(lhsEval,rhs,res,alpha,i,c);
+          processRow(lhs,lhsEval,rhs,res,alpha,i,c);
       }
       else
 #endif
       {
         for(Index i=0; i<n; ++i)
-          processRow(lhsEval,rhs,res,alpha,i,c);
+          processRow(lhs,lhsEval,rhs,res,alpha,i,c);
       }
     }
   }
   
-  static void processRow(const LhsEval& lhsEval, const DenseRhsType& rhs, DenseResType& res, const typename Res::Scalar& alpha, Index i, Index col)
+  template<typename Derived>
+  static void processRow(const SparseMatrixBase<Derived>&, const LhsEval& lhsEval, const DenseRhsType& rhs, DenseResType& res, const typename Res::Scalar& alpha, Index i, Index col)
   {
     typename Res::Scalar tmp(0);
     for(LhsInnerIterator it(lhsEval,i); it ;++it)
       tmp += it.value() * rhs.coeff(it.index(),col);
     res.coeffRef(i,col) += alpha * tmp;
   }
+
+  // Rows stored in compressed arrays: when the rhs column is contiguous, its coefficients are gathered packet-wise
+  // through the inner indices.
+  template<typename Derived>
+  static void processRow(const SparseCompressedBase<Derived>& lhs, const LhsEval& lhsEval, const DenseRhsType& rhs, DenseResType& res, const typename Res::Scalar& alpha, Index i, Index col)
+  {
+    typedef typename Res::Scalar Scalar;
+    enum {
+      Vectorize = is_same<typename Derived::StorageIndex,int>::value
+               && is_same<typename Derived::Scalar,Scalar>::value
+               && is_same<typename Rhs::Scalar,Scalar>::value
+               && packet_traits<Scalar>::HasIndexedGather
+               && (int(traits<Rhs>::Flags)&DirectAccessBit)
+               && int(inner_stride_at_compile_time<Rhs>::ret)==1
+    };
+    processCompressedRow(lhs.derived(), lhsEval, rhs, res, alpha, i, col, typename conditional<bool(Vectorize),true_type,false_type>::type());
+  }
+
+  template<typename Derived>
+  static void processCompressedRow(const Derived& lhs, const LhsEval& lhsEval, const DenseRhsType& rhs, DenseResType& res, const typename Res::Scalar& alpha, Index i, Index col, false_type)
+  {
+    processRow(static_cast<const SparseMatrixBase<Derived>&>(lhs), lhsEval, rhs, res, alpha, i, col);
+  }
+
+  template<typename Derived>
+  static void processCompressedRow(const Derived& lhs, const LhsEval& lhsEval, const DenseRhsType& rhs, DenseResType& res, const typename Res::Scalar& alpha, Index i, Index col, true_type)
+  {
+    typedef typename Res::Scalar Scalar;
+    typedef typename packet_traits<Scalar>::type Packet;
+    enum { PacketSize = unpacket_traits<Packet>::size };
+    if(lhs.outerIndexPtr()==0)
+    {
+      processRow(static_cast<const SparseMatrixBase<Derived>&>(lhs), lhsEval, rhs, res, alpha, i, col);
+      return;
+    }
+    const Scalar* values = lhs.valuePtr();
+    const int* indices = lhs.innerIndexPtr();
+    const Scalar* x = rhs.data() + col*rhs.outerStride();
+    const Index start = lhs.outerIndexPtr()[i];
+    const Index end = lhs.isCompressed() ? Index(lhs.outerIndexPtr()[i+1]) : start + lhs.innerNonZeroPtr()[i];
+    const Index packetEnd = start + ((end-start)/PacketSize)*PacketSize;
+    Scalar tmp(0);
+    Index k = start;
+    if(packetEnd>start)
+    {
+      Packet acc = pset1<Packet>(Scalar(0));
+      for(; k<packetEnd; k+=PacketSize)
+        acc = pmadd(ploadu<Packet>(values+k), pgather_indexed<Scalar,Packet>(x, indices+k), acc);
+      tmp = predux(acc);
+    }
+    for(; k<end; ++k)
+      tmp += values[k] * x[indices[k]];
+    res.coeffRef(i,col) += alpha * tmp;
+  }
   
 };
 
@@ -498,6 +498,7 @@ void SparseLU<MatrixType, OrderingType>::factorize(const MatrixType& matrix)
   using internal::emptyIdxLU;
   eigen_assert(m_analysisIsOk && "analyzePattern() should be called first"); 
   eigen_assert((matrix.rows() == matrix.cols()) && "Only for squared matrices");
+  EIGEN_PROFILE_KERNEL("sparse_lu_factorize", matrix.rows(), matrix.cols(), matrix.nonZeros(), 0);
   
   m_isInitialized = true;
   
@@ -0,0 +1,872 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SPARSE_MULTIFRONTAL_QR_H
+#define EIGEN_SPARSE_MULTIFRONTAL_QR_H
+
+namespace Eigen {
+
+template<typename MatrixType, typename OrderingType> class SparseMultifrontalQR;
+template<typename QRType> struct SparseMultifrontalQRMatrixQReturnType;
+template<typename QRType> struct SparseMultifrontalQRMatrixQTransposeReturnType;
+template<typename QRType, typename Derived> struct SparseMultifrontalQR_QProduct;
+namespace internal {
+  template <typename QRType> struct traits<SparseMultifrontalQRMatrixQReturnType<QRType> >
+  {
+    typedef typename QRType::MatrixType ReturnType;
+    typedef typename ReturnType::StorageIndex StorageIndex;
+    typedef typename ReturnType::StorageKind StorageKind;
+    enum {
+      RowsAtCompileTime = Dynamic,
+      ColsAtCompileTime = Dynamic
+    };
+  };
+  template <typename QRType> struct traits<SparseMultifrontalQRMatrixQTransposeReturnType<QRType> >
+  {
+    typedef typename QRType::MatrixType ReturnType;
+  };
+  template <typename QRType, typename Derived> struct traits<SparseMultifrontalQR_QProduct<QRType, Derived> >
+  {
+    typedef typename Derived::PlainObject ReturnType;
+  };
+} // End namespace internal
+
+/**
+  * \ingroup SparseQR_Module
+  * \class SparseMultifrontalQR
+  * \brief Sparse multifrontal QR factorization
+  *
+  * This class computes the QR factorization A*P = Q*R of a sparse matrix with at least as many rows
+  * as columns using the multifrontal method. The columns are grouped into supernodes along the
+  * column elimination tree of A*P. For each supernode, the rows of A whose leftmost nonzero falls
+  * into it and the contribution blocks of its children are assembled into a dense frontal matrix,
+  * which is factorized by the blocked Householder QR of the \link QR_Module QR \endlink module.
+  * The first rows of the result are rows of R, the remaining upper triangular part is the contribution
+  * block passed to the parent. Compared to the left-looking SparseQR, most of the work is thus done
+  * by level-3 dense kernels.
+  *
+  * When OpenMP is enabled, independent subtrees of the elimination tree are factorized concurrently
+  * using Eigen::nbThreads() threads, and the fronts near the root rely on the parallel matrix products.
+  *
+  * Q is never formed: the Householder reflectors of each front are kept in blocked form. Use matrixQ()
+  * to get an expression of Q, and matrixQ().adjoint() to get its adjoint.
+  *
+  * Unlike SparseQR, no numerical column pivoting is performed. A rank deficient matrix leads to
+  * negligible diagonal entries in R. solve() then sets the corresponding unknowns to zero, but the
+  * result is not a minimum norm solution. Use SparseQR for rank revealing factorizations.
+  *
+  * \tparam _MatrixType The type of the sparse matrix A, must be a column-major SparseMatrix<>
+  * \tparam _OrderingType The fill-reducing ordering method. See the \link OrderingMethods_Module
+  *  OrderingMethods \endlink module for the list of built-in and external ordering methods.
+  *
+  * \implsparsesolverconcept
+  *
+  * \warning The input sparse matrix A must be in compressed mode (see SparseMatrix::makeCompressed()).
+  *
+  * \sa SparseQR
+  */
+template<typename _MatrixType, typename _OrderingType>
+class SparseMultifrontalQR : public SparseSolverBase<SparseMultifrontalQR<_MatrixType,_OrderingType> >
+{
+  protected:
+    typedef SparseSolverBase<SparseMultifrontalQR<_MatrixType,_OrderingType> > Base;
+    using Base::m_isInitialized;
+  public:
+    using Base::_solve_impl;
+    typedef _MatrixType MatrixType;
+    typedef _OrderingType OrderingType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename MatrixType::StorageIndex StorageIndex;
+    typedef SparseMatrix<Scalar,ColMajor,StorageIndex> QRMatrixType;
+    typedef Matrix<StorageIndex, Dynamic, 1> IndexVector;
+    typedef Matrix<Scalar, Dynamic, 1> ScalarVector;
+    typedef Matrix<Scalar, Dynamic, Dynamic> FrontType;
+    typedef PermutationMatrix<Dynamic, Dynamic, StorageIndex> PermutationType;
+
+    enum {
+      ColsAtCompileTime = MatrixType::ColsAtCompileTime,
+      MaxColsAtCompileTime = MatrixType::MaxColsAtCompileTime
+    };
+
+  public:
+    SparseMultifrontalQR() : m_analysisIsok(false), m_factorizationIsok(false), m_useDefaultThreshold(true), m_relax(4)
+    { }
+
+    /** Construct a QR factorization of the matrix \a mat.
+      *
+      * \warning The matrix \a mat must be in compressed mode (see SparseMatrix::makeCompressed()).
+      *
+      * \sa compute()
+      */
+    explicit SparseMultifrontalQR(const MatrixType& mat) : m_analysisIsok(false), m_factorizationIsok(false), m_useDefaultThreshold(true), m_relax(4)
+    {
+      compute(mat);
+    }
+
+    /** Computes the QR factorization of the sparse matrix \a mat.
+      *
+      * \warning The matrix \a mat must be in compressed mode (see SparseMatrix::makeCompressed()).
+      *
+      * \sa analyzePattern(), factorize()
+      */
+    void compute(const MatrixType& mat)
+    {
+      analyzePattern(mat);
+      factorize(mat);
+    }
+    void analyzePattern(const MatrixType& mat);
+    void factorize(const MatrixType& mat);
+
+    /** \returns the number of rows of the represented matrix.
+      */
+    inline Index rows() const { return m_rows; }
+
+    /** \returns the number of columns of the represented matrix.
+      */
+    inline Index cols() const { return m_cols; }
+
+    /** \returns a const reference to the \b sparse upper triangular matrix R of the QR factorization.
+      * Its rows are gathered from the frontal matrices at the end of factorize().
+      */
+    const QRMatrixType& matrixR() const { return m_R; }
+
+    /** \returns the number of diagonal entries of R whose magnitude is above the pivot threshold.
+      *
+      * \warning Columns are not reordered according to the rank, so matrixR().topLeftCorner(rank(), rank())
+      * is not a full rank factor when rank() < cols().
+      *
+      * \sa setPivotThreshold()
+      */
+    Index rank() const
+    {
+      eigen_assert(m_isInitialized && "The factorization should be called first, use compute()");
+      return m_nonzeropivots;
+    }
+
+    /** \returns an expression of the matrix Q as products of the blocked Householder reflectors
+      * of the frontal matrices. The common usage of this function is to apply it to a dense matrix or vector
+      * \code
+      * VectorXd B1, B2;
+      * // Initialize B1
+      * B2 = matrixQ() * B1;
+      * \endcode
+      */
+    SparseMultifrontalQRMatrixQReturnType<SparseMultifrontalQR> matrixQ() const
+    { return SparseMultifrontalQRMatrixQReturnType<SparseMultifrontalQR>(*this); }
+
+    /** \returns a const reference to the column permutation P that was applied to A such that A*P = Q*R
+      * It is the fill-in reducing permutation followed by a postordering of the elimination tree.
+      */
+    const PermutationType& colsPermutation() const
+    {
+      eigen_assert(m_isInitialized && "Decomposition is not initialized.");
+      return m_outputPerm_c;
+    }
+
+    /** \returns the number of frontal matrices, that is the number of supernodes. */
+    Index fronts() const
+    {
+      eigen_assert(m_analysisIsok && "analyzePattern() should be called first");
+      return m_frontParent.size();
+    }
+
+    /** \internal */
+    template<typename Rhs, typename Dest>
+    bool _solve_impl(const MatrixBase<Rhs> &B, MatrixBase<Dest> &dest) const
+    {
+      eigen_assert(m_isInitialized && "The factorization should be called first, use compute()");
+      eigen_assert(this->rows() == B.rows() && "SparseMultifrontalQR::solve() : invalid number of rows in the right hand side matrix");
+
+      // Compute Q^* * b
+      typename Dest::PlainObject y = B;
+      _applyQAdjoint(y);
+
+      // Backward substitution with the columns of R, skipping the negligible pivots
+      for (Index k = m_cols-1; k >= 0; --k)
+      {
+        const Index last = m_R.outerIndexPtr()[k+1] - 1;
+        const bool hasDiag = last >= m_R.outerIndexPtr()[k] && m_R.innerIndexPtr()[last] == k;
+        if (!hasDiag || numext::abs(m_R.valuePtr()[last]) <= m_threshold)
+        {
+          y.row(k).setZero();
+          continue;
+        }
+        y.row(k) /= m_R.valuePtr()[last];
+        for (Index p = m_R.outerIndexPtr()[k]; p < last; ++p)
+          y.row(m_R.innerIndexPtr()[p]) -= m_R.valuePtr()[p] * y.row(k);
+      }
+
+      // Apply the column permutation
+      dest = colsPermutation() * y.topRows(cols());
+
+      m_info = Success;
+      return true;
+    }
+
+    /** Sets the threshold below which a diagonal entry of R is considered as zero by rank() and solve().
+      * The default is \f$ 20 (m+n) \epsilon \max_j \|A_j\| \f$, as in SparseQR.
+      */
+    void setPivotThreshold(const RealScalar& threshold)
+    {
+      m_useDefaultThreshold = false;
+      m_threshold = threshold;
+    }
+
+    /** Sets the number of explicit zeros that may be added to a row of R to merge a column with its parent
+      * in the same frontal matrix. Larger values lead to fewer and larger fronts. Default is 4.
+      * Must be called before analyzePattern().
+      */
+    void setRelaxation(Index relax) { m_relax = relax; }
+
+    /** \returns the solution X of \f$ A X = B \f$ using the current decomposition of A.
+      *
+      * \sa compute()
+      */
+    template<typename Rhs>
+    inline const Solve<SparseMultifrontalQR, Rhs> solve(const MatrixBase<Rhs>& B) const
+    {
+      eigen_assert(m_isInitialized && "The factorization should be called first, use compute()");
+      eigen_assert(this->rows() == B.rows() && "SparseMultifrontalQR::solve() : invalid number of rows in the right hand side matrix");
+      return Solve<SparseMultifrontalQR, Rhs>(*this, B.derived());
+    }
+
+    /** \brief Reports whether previous computation was successful.
+      *
+      * \returns \c Success if computation was successful,
+      *          \c InvalidInput if the input matrix is invalid
+      */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "Decomposition is not initialized.");
+      return m_info;
+    }
+
+    /** \internal Overwrites \a res by Q^* res. */
+    template<typename Dest>
+    void _applyQAdjoint(Dest& res) const
+    {
+      FrontType work;
+      for (Index f = 0; f < fronts(); ++f)
+      {
+        gatherRows(res, f, work);
+        work.applyOnTheLeft(householderSequence(m_fronts[f], m_hcoeffs[f].conjugate()).adjoint());
+        scatterRows(work, f, res);
+      }
+      typename Dest::PlainObject tmp(res);
+      for (Index i = 0; i < m_rows; ++i)
+        res.row(i) = tmp.row(m_rowPerm(i));
+    }
+
+    /** \internal Overwrites \a res by Q res. */
+    template<typename Dest>
+    void _applyQ(Dest& res) const
+    {
+      FrontType work;
+      typename Dest::PlainObject tmp(res);
+      for (Index i = 0; i < m_rows; ++i)
+        res.row(m_rowPerm(i)) = tmp.row(i);
+      for (Index f = fronts()-1; f >= 0; --f)
+      {
+        gatherRows(res, f, work);
+        work.applyOnTheLeft(householderSequence(m_fronts[f], m_hcoeffs[f].conjugate()));
+        scatterRows(work, f, res);
+      }
+    }
+
+  protected:
+    void symbolicR(const MatrixType& mat, const IndexVector& iperm, IndexVector& parent,
+                   IndexVector& patPtr, std::vector<StorageIndex>& pat);
+    void factorizeFront(const MatrixType& mat, Index f);
+
+    template<typename Src>
+    void gatherRows(const Src& src, Index f, FrontType& dst) const
+    {
+      const Index r = m_frontSlotPtr(f+1) - m_frontSlotPtr(f);
+      dst.resize(r, src.cols());
+      for (Index i = 0; i < r; ++i)
+        dst.row(i) = src.row(m_frontSlots(m_frontSlotPtr(f)+i));
+    }
+
+    template<typename Dst>
+    void scatterRows(const FrontType& src, Index f, Dst& dst) const
+    {
+      for (Index i = 0; i < src.rows(); ++i)
+        dst.row(m_frontSlots(m_frontSlotPtr(f)+i)) = src.row(i);
+    }
+
+    bool m_analysisIsok;
+    bool m_factorizationIsok;
+    mutable ComputationInfo m_info;
+    Index m_rows, m_cols;
+    QRMatrixType m_R;                   // The triangular factor matrix
+    PermutationType m_perm_c;           // Fill-reducing and postordering column permutation
+    PermutationType m_outputPerm_c;     // Its inverse, as returned by colsPermutation()
+    RealScalar m_threshold;             // Threshold to determine negligible pivots
+    bool m_useDefaultThreshold;         // Use default threshold
+    Index m_relax;                      // Maximal number of zeros added to a row of R by amalgamation
+    Index m_nonzeropivots;              // Number of non negligible pivots
+
+    // Structure of the frontal matrices, numbered in postorder. The columns of a front are its pivot
+    // columns followed by the columns of its contribution block, in increasing order. Its rows are
+    // identified by "slots", that is rows of the vectors Q is applied to.
+    IndexVector m_frontPivStart;        // First pivot column of each front, plus n
+    IndexVector m_frontColPtr, m_frontCols;
+    IndexVector m_frontSlotPtr, m_frontSlots;
+    IndexVector m_frontParent;          // Parent front, or -1
+    IndexVector m_frontChildPtr, m_frontChildren;
+    IndexVector m_childRowOffset;       // First row of the contribution block of a front in its parent
+    IndexVector m_relmapPtr, m_relmap;  // Columns of the contribution blocks in the parent front
+    IndexVector m_origPtr, m_origSrc;   // Entries of A assembled in each front...
+    Matrix<Index,Dynamic,1> m_origDst;  // ... and their position in the front
+    IndexVector m_rowPerm;              // Slot of each row of Q^* b, the rows of R coming first
+    std::vector<double> m_frontWork;    // Flop estimate of each front, used for scheduling
+
+    std::vector<FrontType> m_fronts;    // Householder vectors below the diagonal, R and contribution blocks above
+    std::vector<ScalarVector> m_hcoeffs;
+};
+
+/** \internal Computes the structure of R for the column ordering \a iperm (new to old):
+  * row k of R is made of the columns of the rows of A whose leftmost nonzero is in column k,
+  * and of the rows of R of the children of k in the column elimination tree, minus their pivot.
+  * The parent of k is then the first off-diagonal column of row k.
+  */
+template <typename MatrixType, typename OrderingType>
+void SparseMultifrontalQR<MatrixType,OrderingType>::symbolicR(const MatrixType& mat, const IndexVector& iperm, IndexVector& parent,
+                                                             IndexVector& patPtr, std::vector<StorageIndex>& pat)
+{
+  const Index m = mat.rows();
+  const Index n = mat.cols();
+
+  // Leftmost column of each row, and rows grouped by leftmost column
+  IndexVector leftmost = IndexVector::Constant(m, StorageIndex(n));
+  for (Index k = 0; k < n; ++k)
+    for (typename MatrixType::InnerIterator it(mat, iperm(k)); it; ++it)
+      leftmost(it.index()) = (std::min)(leftmost(it.index()), StorageIndex(k));
+  IndexVector rowPtr = IndexVector::Zero(n+2), rowList(m);
+  for (Index i = 0; i < m; ++i)
+    ++rowPtr(leftmost(i)+1);
+  for (Index k = 0; k <= n; ++k)
+    rowPtr(k+1) += rowPtr(k);
+  {
+    IndexVector pos = rowPtr;
+    for (Index i = 0; i < m; ++i)
+      rowList(pos(leftmost(i))++) = StorageIndex(i);
+  }
+
+  // Columns of each row of A, in the new ordering
+  IndexVector rowColPtr = IndexVector::Zero(m+1), rowCols(mat.nonZeros());
+  for (Index p = 0; p < mat.nonZeros(); ++p)
+    ++rowColPtr(mat.innerIndexPtr()[p]+1);
+  for (Index i = 0; i < m; ++i)
+    rowColPtr(i+1) += rowColPtr(i);
+  {
+    IndexVector pos = rowColPtr.head(m);
+    for (Index k = 0; k < n; ++k)
+      for (typename MatrixType::InnerIterator it(mat, iperm(k)); it; ++it)
+        rowCols(pos(it.index())++) = StorageIndex(k);
+  }
+
+  IndexVector marker = IndexVector::Constant(n, -1);
+  IndexVector firstKid = IndexVector::Constant(n, -1), nextKid(n);
+  parent.resize(n);
+  patPtr.resize(n+1);
+  pat.clear();
+  patPtr(0) = 0;
+  for (Index k = 0; k < n; ++k)
+  {
+    const Index start = pat.size();
+    marker(k) = StorageIndex(k);
+    pat.push_back(StorageIndex(k));
+    for (Index q = rowPtr(k); q < rowPtr(k+1); ++q)
+    {
+      const Index i = rowList(q);
+      for (Index p = rowColPtr(i); p < rowColPtr(i+1); ++p)
+        if (marker(rowCols(p)) != k)
+        {
+          marker(rowCols(p)) = StorageIndex(k);
+          pat.push_back(rowCols(p));
+        }
+    }
+    for (StorageIndex c = firstKid(k); c >= 0; c = nextKid(c))
+      for (Index p = patPtr(c)+1; p < patPtr(c+1); ++p)
+        if (marker(pat[p]) != k)
+        {
+          marker(pat[p]) = StorageIndex(k);
+          pat.push_back(pat[p]);
+        }
+    std::sort(pat.begin()+start, pat.end());
+    patPtr(k+1) = StorageIndex(pat.size());
+    parent(k) = pat.size()-start > 1 ? pat[start+1] : StorageIndex(n);
+    if (parent(k) < n)
+    {
+      nextKid(k) = firstKid(parent(k));
+      firstKid(parent(k)) = StorageIndex(k);
+    }
+  }
+}
+
+/** \brief Symbolic analysis of the multifrontal QR factorization
+  *
+  * Computes the fill-reducing ordering, the column elimination tree and its postordering, groups the
+  * columns into supernodes, and determines the structure of every frontal matrix, as well as where
+  * each entry of \a mat and each contribution block goes. Only the sparsity pattern of \a mat is used.
+  *
+  * \warning The matrix \a mat must be in compressed mode (see SparseMatrix::makeCompressed()).
+  */
+template <typename MatrixType, typename OrderingType>
+void SparseMultifrontalQR<MatrixType,OrderingType>::analyzePattern(const MatrixType& mat)
+{
+  eigen_assert(mat.isCompressed() && "SparseMultifrontalQR requires a sparse matrix in compressed mode. Call .makeCompressed() before passing it to SparseMultifrontalQR");
+  eigen_assert(mat.rows() >= mat.cols() && "SparseMultifrontalQR requires at least as many rows as columns");
+  const Index m = mat.rows();
+  const Index n = mat.cols();
+  m_rows = m;
+  m_cols = n;
+
+  // Compute the column fill reducing ordering
+  OrderingType ord;
+  PermutationType perm;
+  ord(mat, perm);
+  if (!perm.size())
+  {
+    perm.resize(n);
+    perm.indices().setLinSpaced(n, 0, StorageIndex(n-1));
+  }
+
+  // Postorder the column elimination tree, so that the columns of a supernode are consecutive
+  // and each subtree is a contiguous range of columns, then recompute the structure of R
+  IndexVector parent, patPtr, post;
+  std::vector<StorageIndex> pat;
+  PermutationType iperm = perm.inverse();
+  symbolicR(mat, iperm.indices(), parent, patPtr, pat);
+  internal::treePostorder(StorageIndex(n), parent, post);
+  m_perm_c.resize(n);
+  for (Index j = 0; j < n; ++j)
+    m_perm_c.indices()(j) = post(perm.indices()(j));
+  m_outputPerm_c = m_perm_c.inverse();
+  symbolicR(mat, m_outputPerm_c.indices(), parent, patPtr, pat);
+
+  // Fundamental and relaxed supernodes: a column is merged with its parent when it is its only
+  // child and the row of R of the column does not get more than m_relax explicit zeros.
+  IndexVector nchildren = IndexVector::Zero(n+1);
+  for (Index k = 0; k < n; ++k)
+    ++nchildren(parent(k));
+  std::vector<StorageIndex> frontStart;
+  for (Index k = 0; k < n; ++k)
+  {
+    const bool merge = k > 0 && parent(k-1) == k && nchildren(k) == 1
+                    && (patPtr(k+1)-patPtr(k)) - (patPtr(k)-patPtr(k-1)-1) <= m_relax;
+    if (!merge)
+      frontStart.push_back(StorageIndex(k));
+  }
+  const Index nf = frontStart.size();
+  m_frontPivStart.resize(nf+1);
+  for (Index f = 0; f < nf; ++f)
+    m_frontPivStart(f) = frontStart[f];
+  m_frontPivStart(nf) = StorageIndex(n);
+  IndexVector frontOf(n);
+  for (Index f = 0; f < nf; ++f)
+    frontOf.segment(m_frontPivStart(f), m_frontPivStart(f+1)-m_frontPivStart(f)).setConstant(StorageIndex(f));
+
+  // Columns of the fronts: the pivots, then the rest of the last row of R
+  m_frontColPtr.resize(nf+1);
+  m_frontColPtr(0) = 0;
+  for (Index f = 0; f < nf; ++f)
+  {
+    const Index k1 = m_frontPivStart(f+1)-1;
+    m_frontColPtr(f+1) = m_frontColPtr(f) + (k1-m_frontPivStart(f)) + (patPtr(k1+1)-patPtr(k1));
+  }
+  m_frontCols.resize(m_frontColPtr(nf));
+  m_frontParent.resize(nf);
+  for (Index f = 0; f < nf; ++f)
+  {
+    const Index k0 = m_frontPivStart(f), k1 = m_frontPivStart(f+1)-1;
+    Index q = m_frontColPtr(f);
+    for (Index k = k0; k < k1; ++k)
+      m_frontCols(q++) = StorageIndex(k);
+    for (Index p = patPtr(k1); p < patPtr(k1+1); ++p)
+      m_frontCols(q++) = pat[p];
+    m_frontParent(f) = parent(k1) < n ? frontOf(parent(k1)) : StorageIndex(-1);
+  }
+  pat.clear();
+
+  // Children of each front, in increasing order
+  m_frontChildPtr = IndexVector::Zero(nf+1);
+  for (Index f = 0; f < nf; ++f)
+    if (m_frontParent(f) >= 0)
+      ++m_frontChildPtr(m_frontParent(f)+1);
+  for (Index f = 0; f < nf; ++f)
+    m_frontChildPtr(f+1) += m_frontChildPtr(f);
+  m_frontChildren.resize(m_frontChildPtr(nf));
+  {
+    IndexVector pos = m_frontChildPtr.head(nf);
+    for (Index f = 0; f < nf; ++f)
+      if (m_frontParent(f) >= 0)
+        m_frontChildren(pos(m_frontParent(f))++) = StorageIndex(f);
+  }
+
+  // Rows of A assembled in each front: those whose leftmost column is one of its pivots
+  IndexVector rowFront = IndexVector::Constant(m, -1);
+  for (Index j = 0; j < n; ++j)
+    for (typename MatrixType::InnerIterator it(mat, j); it; ++it)
+    {
+      const StorageIndex f = frontOf(m_perm_c.indices()(j));
+      if (rowFront(it.index()) < 0 || m_frontPivStart(f) < m_frontPivStart(rowFront(it.index())))
+        rowFront(it.index()) = f;
+    }
+
+  // Rows of each front: its rows of A, then the contribution blocks of its children
+  IndexVector nrows = IndexVector::Zero(nf), rowLocal(m);
+  for (Index i = 0; i < m; ++i)
+    if (rowFront(i) >= 0)
+      rowLocal(i) = nrows(rowFront(i))++;
+  IndexVector contribRows(nf);
+  m_childRowOffset.resize(nf);
+  m_frontSlotPtr.resize(nf+1);
+  m_frontSlotPtr(0) = 0;
+  for (Index f = 0; f < nf; ++f)
+  {
+    Index r = nrows(f);
+    for (Index q = m_frontChildPtr(f); q < m_frontChildPtr(f+1); ++q)
+    {
+      const Index c = m_frontChildren(q);
+      m_childRowOffset(c) = StorageIndex(r);
+      r += contribRows(c);
+    }
+    const Index nc = m_frontColPtr(f+1) - m_frontColPtr(f);
+    const Index npiv = m_frontPivStart(f+1) - m_frontPivStart(f);
+    contribRows(f) = StorageIndex((std::max<Index>)(0, (std::min)(r, nc) - npiv));
+    nrows(f) = StorageIndex(r);
+    m_frontSlotPtr(f+1) = m_frontSlotPtr(f) + StorageIndex(r);
+  }
+  m_frontSlots.resize(m_frontSlotPtr(nf));
+  for (Index i = 0; i < m; ++i)
+    if (rowFront(i) >= 0)
+      m_frontSlots(m_frontSlotPtr(rowFront(i)) + rowLocal(i)) = StorageIndex(i);
+  for (Index c = 0; c < nf; ++c)
+  {
+    const Index f = m_frontParent(c);
+    if (f < 0) continue;
+    const Index npiv = m_frontPivStart(c+1) - m_frontPivStart(c);
+    for (Index t = 0; t < contribRows(c); ++t)
+      m_frontSlots(m_frontSlotPtr(f) + m_childRowOffset(c) + t) = m_frontSlots(m_frontSlotPtr(c) + npiv + t);
+  }
+
+  // Position of the columns of each contribution block in the parent front
+  m_relmapPtr.resize(nf+1);
+  m_relmapPtr(0) = 0;
+  for (Index c = 0; c < nf; ++c)
+  {
+    const Index npiv = m_frontPivStart(c+1) - m_frontPivStart(c);
+    m_relmapPtr(c+1) = m_relmapPtr(c) + (m_frontColPtr(c+1) - m_frontColPtr(c) - npiv);
+  }
+  m_relmap.resize(m_relmapPtr(nf));
+  for (Index c = 0; c < nf; ++c)
+  {
+    const Index f = m_frontParent(c);
+    if (f < 0) continue;
+    const Index npiv = m_frontPivStart(c+1) - m_frontPivStart(c);
+    const StorageIndex *first = m_frontCols.data() + m_frontColPtr(f), *last = m_frontCols.data() + m_frontColPtr(f+1);
+    for (Index q = m_relmapPtr(c); q < m_relmapPtr(c+1); ++q)
+    {
+      const StorageIndex col = m_frontCols(m_frontColPtr(c) + npiv + (q - m_relmapPtr(c)));
+      m_relmap(q) = StorageIndex(std::lower_bound(first, last, col) - first);
+    }
+  }
+
+  // Position of each entry of A in its front
+  m_origPtr = IndexVector::Zero(nf+1);
+  for (Index p = 0; p < mat.nonZeros(); ++p)
+    ++m_origPtr(rowFront(mat.innerIndexPtr()[p])+1);
+  for (Index f = 0; f < nf; ++f)
+    m_origPtr(f+1) += m_origPtr(f);
+  m_origSrc.resize(mat.nonZeros());
+  m_origDst.resize(mat.nonZeros());
+  {
+    IndexVector pos = m_origPtr.head(nf);
+    for (Index j = 0; j < n; ++j)
+      for (Index p = mat.outerIndexPtr()[j]; p < mat.outerIndexPtr()[j+1]; ++p)
+      {
+        const Index i = mat.innerIndexPtr()[p];
+        const Index f = rowFront(i);
+        const StorageIndex *first = m_frontCols.data() + m_frontColPtr(f), *last = m_frontCols.data() + m_frontColPtr(f+1);
+        const Index localCol = std::lower_bound(first, last, m_perm_c.indices()(j)) - first;
+        const Index q = pos(f)++;
+        m_origSrc(q) = StorageIndex(p);
+        m_origDst(q) = rowLocal(i) + localCol * nrows(f);
+      }
+  }
+
+  // Rows of Q^* b: the rows of R in order, then the remaining slots
+  m_rowPerm = IndexVector::Constant(m, -1);
+  std::vector<bool> used(m, false);
+  for (Index f = 0; f < nf; ++f)
+  {
+    const Index npiv = m_frontPivStart(f+1) - m_frontPivStart(f);
+    for (Index t = 0; t < (std::min<Index>)(npiv, nrows(f)); ++t)
+    {
+      const StorageIndex slot = m_frontSlots(m_frontSlotPtr(f) + t);
+      m_rowPerm(m_frontPivStart(f) + t) = slot;
+      used[slot] = true;
+    }
+  }
+  {
+    Index next = 0;
+    for (Index i = 0; i < m; ++i)
+    {
+      if (used[i]) continue;
+      while (m_rowPerm(next) >= 0) ++next;
+      m_rowPerm(next) = StorageIndex(i);
+    }
+  }
+
+  m_frontWork.resize(nf);
+  for (Index f = 0; f < nf; ++f)
+  {
+    const double r = double(nrows(f)), nc = double(m_frontColPtr(f+1) - m_frontColPtr(f));
+    m_frontWork[f] = r * nc * (std::min)(r, nc);
+  }
+
+  m_fronts.resize(nf);
+  m_hcoeffs.resize(nf);
+  m_analysisIsok = true;
+}
+
+/** \internal Assembles and factorizes the frontal matrix \a f. Its children must have been factorized. */
+template <typename MatrixType, typename OrderingType>
+void SparseMultifrontalQR<MatrixType,OrderingType>::factorizeFront(const MatrixType& mat, Index f)
+{
+  const Index r = m_frontSlotPtr(f+1) - m_frontSlotPtr(f);
+  const Index nc = m_frontColPtr(f+1) - m_frontColPtr(f);
+  FrontType& front = m_fronts[f];
+  front.setZero(r, nc);
+
+  // Rows of A
+  const Scalar *values = mat.valuePtr();
+  for (Index q = m_origPtr(f); q < m_origPtr(f+1); ++q)
+    front.data()[m_origDst(q)] = values[m_origSrc(q)];
+
+  // Contribution blocks of the children: the upper triangular part of their trailing rows
+  for (Index q = m_frontChildPtr(f); q < m_frontChildPtr(f+1); ++q)
+  {
+    const Index c = m_frontChildren(q);
+    const FrontType& child = m_fronts[c];
+    const Index npiv = m_frontPivStart(c+1) - m_frontPivStart(c);
+    const Index crows = (std::max<Index>)(0, (std::min)(child.rows(), child.cols()) - npiv);
+    const StorageIndex *relmap = m_relmap.data() + m_relmapPtr(c);
+    for (Index s = 0; s < child.cols() - npiv; ++s)
+      for (Index t = 0; t <= (std::min)(s, crows-1); ++t)
+        front(m_childRowOffset(c) + t, relmap[s]) = child(npiv + t, npiv + s);
+  }
+
+  m_hcoeffs[f].resize((std::min)(r, nc));
+  internal::householder_qr_inplace_blocked<FrontType, ScalarVector>::run(front, m_hcoeffs[f], 48);
+}
+
+/** \brief Performs the numerical QR factorization of the input matrix
+  *
+  * The function SparseMultifrontalQR::analyzePattern(const MatrixType&) must have been called beforehand with
+  * a matrix having the same sparsity pattern than \a mat.
+  *
+  * \param mat The sparse column-major matrix
+  */
+template <typename MatrixType, typename OrderingType>
+void SparseMultifrontalQR<MatrixType,OrderingType>::factorize(const MatrixType& mat)
+{
+  using std::abs;
+  eigen_assert(m_analysisIsok && "analyzePattern() should be called before this step");
+  eigen_assert(mat.rows() == m_rows && mat.cols() == m_cols && mat.nonZeros() == m_origSrc.size());
+  const Index nf = fronts();
+
+  if (m_useDefaultThreshold)
+  {
+    RealScalar max2Norm = 0.0;
+    for (Index j = 0; j < m_cols; j++) max2Norm = numext::maxi(max2Norm, mat.col(j).norm());
+    if(max2Norm==RealScalar(0))
+      max2Norm = RealScalar(1);
+    m_threshold = 20 * (m_rows + m_cols) * max2Norm * NumTraits<RealScalar>::epsilon();
+  }
+
+  std::vector<bool> done(nf, false);
+#ifdef EIGEN_HAS_OPENMP
+  // Map independent subtrees to threads: a subtree is processed as a whole by one thread when its work
+  // is small enough compared to the total but the work of its parent's subtree is not. The fronts above
+  // are processed afterwards, where the dense kernels are themselves parallelized.
+  const Index threads = nbThreads();
+  if (threads > 1 && nf > 1)
+  {
+    std::vector<double> subtreeWork(m_frontWork);
+    IndexVector firstDesc(nf);
+    for (Index f = 0; f < nf; ++f)
+      firstDesc(f) = StorageIndex(f);
+    double total = 0;
+    for (Index f = 0; f < nf; ++f)
+    {
+      const Index p = m_frontParent(f);
+      if (p >= 0)
+      {
+        subtreeWork[p] += subtreeWork[f];
+        firstDesc(p) = (std::min)(firstDesc(p), firstDesc(f));
+      }
+      else
+        total += subtreeWork[f];
+    }
+    const double limit = total / double(2*threads);
+    std::vector<std::pair<double,Index> > roots;
+    for (Index f = 0; f < nf; ++f)
+    {
+      const Index p = m_frontParent(f);
+      if (subtreeWork[f] <= limit && (p < 0 || subtreeWork[p] > limit))
+        roots.push_back(std::make_pair(subtreeWork[f], f));
+    }
+    std::sort(roots.begin(), roots.end(), std::greater<std::pair<double,Index> >());
+    const int nroots = int(roots.size());
+    #pragma omp parallel for schedule(dynamic,1) num_threads(int(threads))
+    for (int i = 0; i < nroots; ++i)
+      for (Index f = firstDesc(roots[i].second); f <= roots[i].second; ++f)
+        factorizeFront(mat, f);
+    for (int i = 0; i < nroots; ++i)
+      for (Index f = firstDesc(roots[i].second); f <= roots[i].second; ++f)
+        done[f] = true;
+  }
+#endif
+  for (Index f = 0; f < nf; ++f)
+    if (!done[f])
+      factorizeFront(mat, f);
+
+  // Gather the rows of R
+  SparseMatrix<Scalar,RowMajor,StorageIndex> R(m_rows, m_cols);
+  Index nnzR = 0;
+  for (Index f = 0; f < nf; ++f)
+  {
+    const Index npiv = (std::min<Index>)(m_frontPivStart(f+1) - m_frontPivStart(f), m_fronts[f].rows());
+    const Index nc = m_fronts[f].cols();
+    nnzR += npiv * nc - npiv * (npiv-1) / 2;
+  }
+  R.reserve(nnzR);
+  m_nonzeropivots = 0;
+  for (Index f = 0; f < nf; ++f)
+  {
+    const FrontType& front = m_fronts[f];
+    const Index k0 = m_frontPivStart(f);
+    for (Index t = 0; t < m_frontPivStart(f+1) - k0; ++t)
+    {
+      R.startVec(k0+t);
+      if (t >= front.rows()) continue;
+      for (Index s = t; s < front.cols(); ++s)
+        R.insertBack(k0+t, m_frontCols(m_frontColPtr(f)+s)) = front(t, s);
+      if (abs(front(t,t)) > m_threshold)
+        ++m_nonzeropivots;
+    }
+  }
+  for (Index k = m_cols; k < m_rows; ++k)
+    R.startVec(k);
+  R.finalize();
+  m_R = R;
+
+  m_isInitialized = true;
+  m_factorizationIsok = true;
+  m_info = Success;
+}
+
+template <typename QRType, typename Derived>
+struct SparseMultifrontalQR_QProduct : ReturnByValue<SparseMultifrontalQR_QProduct<QRType, Derived> >
+{
+  typedef typename QRType::Scalar Scalar;
+  // Get the references
+  SparseMultifrontalQR_QProduct(const QRType& qr, const Derived& other, bool transpose) :
+  m_qr(qr),m_other(other),m_transpose(transpose) {}
+  inline Index rows() const { return m_qr.rows(); }
+  inline Index cols() const { return m_other.cols(); }
+
+  // Assign to a vector
+  template<typename DesType>
+  void evalTo(DesType& res) const
+  {
+    eigen_assert(m_qr.rows() == m_other.rows() && "Non conforming object sizes");
+    res = m_other;
+    if (m_transpose)
+      m_qr._applyQAdjoint(res);
+    else
+      m_qr._applyQ(res);
+  }
+
+  const QRType& m_qr;
+  const Derived& m_other;
+  bool m_transpose; // this actually means adjoint
+};
+
+template<typename QRType>
+struct SparseMultifrontalQRMatrixQReturnType : public EigenBase<SparseMultifrontalQRMatrixQReturnType<QRType> >
+{
+  typedef typename QRType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  enum {
+    RowsAtCompileTime = Dynamic,
+    ColsAtCompileTime = Dynamic
+  };
+  explicit SparseMultifrontalQRMatrixQReturnType(const QRType& qr) : m_qr(qr) {}
+  template<typename Derived>
+  SparseMultifrontalQR_QProduct<QRType, Derived> operator*(const MatrixBase<Derived>& other)
+  {
+    return SparseMultifrontalQR_QProduct<QRType,Derived>(m_qr,other.derived(),false);
+  }
+  // To use for operations with the adjoint of Q
+  SparseMultifrontalQRMatrixQTransposeReturnType<QRType> adjoint() const
+  {
+    return SparseMultifrontalQRMatrixQTransposeReturnType<QRType>(m_qr);
+  }
+  inline Index rows() const { return m_qr.rows(); }
+  inline Index cols() const { return m_qr.rows(); }
+  // To use for operations with the transpose of Q, this is the same as adjoint
+  SparseMultifrontalQRMatrixQTransposeReturnType<QRType> transpose() const
+  {
+    return SparseMultifrontalQRMatrixQTransposeReturnType<QRType>(m_qr);
+  }
+  const QRType& m_qr;
+};
+
+// This actually represents the adjoint of Q
+template<typename QRType>
+struct SparseMultifrontalQRMatrixQTransposeReturnType
+{
+  explicit SparseMultifrontalQRMatrixQTransposeReturnType(const QRType& qr) : m_qr(qr) {}
+  template<typename Derived>
+  SparseMultifrontalQR_QProduct<QRType,Derived> operator*(const MatrixBase<Derived>& other)
+  {
+    return SparseMultifrontalQR_QProduct<QRType,Derived>(m_qr,other.derived(), true);
+  }
+  const QRType& m_qr;
+};
+
+namespace internal {
+
+template<typename QRType>
+struct evaluator_traits<SparseMultifrontalQRMatrixQReturnType<QRType> >
+{
+  typedef typename QRType::MatrixType MatrixType;
+  typedef typename storage_kind_to_evaluator_kind<typename MatrixType::StorageKind>::Kind Kind;
+  typedef SparseShape Shape;
+};
+
+template< typename DstXprType, typename QRType>
+struct Assignment<DstXprType, SparseMultifrontalQRMatrixQReturnType<QRType>, internal::assign_op<typename DstXprType::Scalar,typename DstXprType::Scalar>, Sparse2Dense>
+{
+  typedef SparseMultifrontalQRMatrixQReturnType<QRType> SrcXprType;
+  typedef typename DstXprType::Scalar Scalar;
+  static void run(DstXprType &dst, const SrcXprType &src, const internal::assign_op<Scalar,Scalar> &/*func*/)
+  {
+    dst = src.m_qr.matrixQ() * DstXprType::Identity(src.m_qr.rows(), src.m_qr.rows());
+  }
+};
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_SPARSE_MULTIFRONTAL_QR_H
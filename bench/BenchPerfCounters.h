@@ -0,0 +1,214 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BENCH_PERF_COUNTERS_H
+#define EIGEN_BENCH_PERF_COUNTERS_H
+
+// Hardware performance counters are read through perf_event_open on Linux.
+// Define EIGEN_BENCH_NO_PERF_COUNTERS to compile them out; elsewhere PerfCounters::open() always fails.
+#if defined(__linux__) && !defined(EIGEN_BENCH_NO_PERF_COUNTERS)
+#define EIGEN_BENCH_HAS_PERF_COUNTERS 1
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fstream>
+#include <string>
+#include <stdint.h>
+#include <cstring>
+#else
+#define EIGEN_BENCH_HAS_PERF_COUNTERS 0
+#endif
+
+// size of the cache lines, used to convert last level cache misses into bytes read from memory
+#ifndef EIGEN_BENCH_CACHE_LINE_SIZE
+#define EIGEN_BENCH_CACHE_LINE_SIZE 64
+#endif
+
+namespace Eigen
+{
+
+/** Group of hardware performance counters of the calling thread and of the threads it creates afterwards.
+  *
+  * Two counter groups are opened, so that the events of a group are always scheduled together:
+  *  - cycles, instructions retired, last level cache references and misses,
+  *  - on Intel cores, the floating point operations retired (FP_ARITH_INST_RETIRED, Broadwell and later),
+  *    weighted by the number of lanes of each vector width; fused multiply-adds count as two operations.
+  *
+  * Counts are scaled by the ratio of enabled to running time when the kernel multiplexes the counters.
+  * Counting user space events of one's own process requires /proc/sys/kernel/perf_event_paranoid <= 2.
+  */
+class PerfCounters
+{
+public:
+  enum Event {
+    Cycles = 0,
+    Instructions,
+    CacheReferences,
+    CacheMisses,
+    Flops,
+    EventCount
+  };
+
+  PerfCounters() { init(); }
+  // Counters are tied to their file descriptors: a copy starts closed.
+  PerfCounters(const PerfCounters&) { init(); }
+  PerfCounters& operator=(const PerfCounters&) { return *this; }
+  ~PerfCounters() { close(); }
+
+  /** Opens the counters. \returns whether at least the cycles and instructions could be opened */
+  bool open()
+  {
+#if EIGEN_BENCH_HAS_PERF_COUNTERS
+    close();
+    const uint64_t coreEvents[4] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                     PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES };
+    for(int k=0; k<4; ++k)
+      addEvent(m_core, PERF_TYPE_HARDWARE, coreEvents[k], Event(k), 1);
+    if(isIntel())
+    {
+      // FP_ARITH_INST_RETIRED (event 0xC7), umasks grouped by number of lanes:
+      // scalar (0x01|0x02), 128-bit double (0x04), 128-bit single|256-bit double (0x08|0x10),
+      // 256-bit single|512-bit double (0x20|0x40), 512-bit single (0x80)
+      const uint64_t umasks[5] = { 0x03, 0x04, 0x18, 0x60, 0x80 };
+      const double lanes[5] = { 1, 2, 4, 8, 16 };
+      for(int k=0; k<5; ++k)
+        addEvent(m_fp, PERF_TYPE_RAW, (umasks[k]<<8) | 0xC7, Flops, lanes[k]);
+    }
+    return m_core.size>=2;
+#else
+    return false;
+#endif
+  }
+
+  /** \returns whether the event \a e is counted */
+  bool available(int e) const
+  {
+    const Group& g = e==Flops ? m_fp : m_core;
+    for(int k=0; k<g.size; ++k)
+      if(g.events[k]==e)
+        return true;
+    return false;
+  }
+
+  /** Resets the counts to zero */
+  void reset() { ioctlAll(OpReset); }
+  /** Starts or resumes counting */
+  void enable() { ioctlAll(OpEnable); }
+  /** Pauses counting */
+  void disable() { ioctlAll(OpDisable); }
+
+  /** Reads the counts accumulated since the last reset() into \a counts, an array of EventCount values.
+    * Unavailable events are set to zero. */
+  void read(double* counts) const
+  {
+    for(int e=0; e<EventCount; ++e)
+      counts[e] = 0;
+    readGroup(m_core, counts);
+    readGroup(m_fp, counts);
+  }
+
+protected:
+  enum { MaxGroupSize = 8, OpReset, OpEnable, OpDisable };
+
+  struct Group
+  {
+    int fds[MaxGroupSize];
+    int events[MaxGroupSize];
+    double weights[MaxGroupSize];
+    int size;
+  };
+
+  void init()
+  {
+    m_core.size = 0;
+    m_fp.size = 0;
+  }
+
+  void close()
+  {
+#if EIGEN_BENCH_HAS_PERF_COUNTERS
+    for(int k=m_core.size-1; k>=0; --k) ::close(m_core.fds[k]);
+    for(int k=m_fp.size-1; k>=0; --k) ::close(m_fp.fds[k]);
+#endif
+    init();
+  }
+
+#if EIGEN_BENCH_HAS_PERF_COUNTERS
+  static bool isIntel()
+  {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while(std::getline(cpuinfo, line))
+      if(line.compare(0, 9, "vendor_id")==0)
+        return line.find("GenuineIntel")!=std::string::npos;
+    return false;
+  }
+
+  static void addEvent(Group& g, uint32_t type, uint64_t config, int event, double weight)
+  {
+    if(g.size==MaxGroupSize)
+      return;
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = g.size==0 ? 1 : 0;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING | PERF_FORMAT_ID;
+    const int leader = g.size==0 ? -1 : g.fds[0];
+    const int fd = int(syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0));
+    if(fd<0)
+      return;
+    g.fds[g.size] = fd;
+    g.events[g.size] = event;
+    g.weights[g.size] = weight;
+    ++g.size;
+  }
+
+  // Inherited counters cannot be read as a group, so each counter of the group is read separately.
+  static void readGroup(const Group& g, double* counts)
+  {
+    for(int k=0; k<g.size; ++k)
+    {
+      uint64_t values[4] = { 0, 0, 0, 0 };
+      if(::read(g.fds[k], values, sizeof(values))<ssize_t(3*sizeof(uint64_t)) || values[2]==0)
+        continue;
+      const double scale = double(values[1]) / double(values[2]);
+      counts[g.events[k]] += g.weights[k] * double(values[0]) * scale;
+    }
+  }
+
+  void ioctlAll(int op)
+  {
+    const Group* groups[2] = { &m_core, &m_fp };
+    for(int i=0; i<2; ++i)
+    {
+      if(groups[i]->size==0)
+        continue;
+      const int leader = groups[i]->fds[0];
+      if(op==OpReset)       ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      else if(op==OpEnable) ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+      else                  ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+  }
+#else
+  static void readGroup(const Group&, double*) {}
+  void ioctlAll(int) {}
+#endif
+
+  Group m_core;
+  Group m_fp;
+};
+
+}
+
+#endif // EIGEN_BENCH_PERF_COUNTERS_H
@@ -36,6 +36,8 @@ static void clobber() {
 }
 
 #include <Eigen/Core>
+#include <iostream>
+#include "BenchPerfCounters.h"
 
 namespace Eigen
 {
@@ -50,6 +52,10 @@ enum {
   * On POSIX platforms we use clock_gettime with CLOCK_PROCESS_CPUTIME_ID.
   * On Windows we use QueryPerformanceCounter
   *
+  * On Linux, enableCounters() additionally records hardware performance counters (see PerfCounters) for each
+  * try. The counts of the try with the best real time are kept, and give the derived metrics ipc(), gflops(),
+  * bandwidth() and arithmeticIntensity(), which printCounters() reports along with the roofline position.
+  *
   * Important: on linux, you must link with -lrt
   */
 class BenchTimer
@@ -63,6 +69,7 @@ public:
     QueryPerformanceFrequency(&freq);
     m_frequency = (double)freq.QuadPart;
 #endif
+    m_countersEnabled = false;
     reset();
   }
 
@@ -73,9 +80,16 @@ public:
     m_bests.fill(1e9);
     m_worsts.fill(0);
     m_totals.setZero();
+    for(int e=0; e<PerfCounters::EventCount; ++e)
+      m_bestCounts[e] = m_counts[e] = 0;
   }
   inline void start()
   {
+    if(m_countersEnabled)
+    {
+      m_counters.reset();
+      m_counters.enable();
+    }
     m_starts[CPU_TIMER]  = getCpuTime();
     m_starts[REAL_TIMER] = getRealTime();
   }
@@ -83,6 +97,13 @@ public:
   {
     m_times[CPU_TIMER] = getCpuTime() - m_starts[CPU_TIMER];
     m_times[REAL_TIMER] = getRealTime() - m_starts[REAL_TIMER];
+    if(m_countersEnabled)
+    {
+      m_counters.disable();
+      m_counters.read(m_counts);
+      if(m_times[REAL_TIMER] < m_bests[REAL_TIMER])
+        std::copy(m_counts, m_counts+PerfCounters::EventCount, m_bestCounts);
+    }
     #if EIGEN_VERSION_AT_LEAST(2,90,0)
     m_bests = m_bests.cwiseMin(m_times);
     m_worsts = m_worsts.cwiseMax(m_times);
@@ -123,6 +144,85 @@ public:
     return m_totals[TIMER];
   }
 
+  /** Starts recording the hardware performance counters in start()/stop().
+    * \returns false if they are not available on this platform or for this user */
+  inline bool enableCounters()
+  {
+    m_countersEnabled = m_counters.open();
+    return m_countersEnabled;
+  }
+
+  /** \returns whether the event \a e (a PerfCounters::Event) is counted */
+  inline bool hasCounter(int e) const
+  {
+    return m_countersEnabled && m_counters.available(e);
+  }
+
+  /** Return the count of the event \a e (a PerfCounters::Event) during the try with the best real time
+    */
+  inline double counter(int e) const
+  {
+    return m_bestCounts[e];
+  }
+
+  /** Return the instructions retired per cycle of the best try
+    */
+  inline double ipc() const
+  {
+    return m_bestCounts[PerfCounters::Cycles]>0 ? m_bestCounts[PerfCounters::Instructions]/m_bestCounts[PerfCounters::Cycles] : 0;
+  }
+
+  /** Return the floating point operations per second of the best try in GFLOP/s, as counted by the hardware
+    */
+  inline double gflops() const
+  {
+    return 1e-9 * m_bestCounts[PerfCounters::Flops] / best(REAL_TIMER);
+  }
+
+  /** Return the bandwidth from memory of the best try in GB/s, estimated from the last level cache misses
+    */
+  inline double bandwidth() const
+  {
+    return 1e-9 * m_bestCounts[PerfCounters::CacheMisses] * EIGEN_BENCH_CACHE_LINE_SIZE / best(REAL_TIMER);
+  }
+
+  /** Return the floating point operations per byte read from memory of the best try
+    */
+  inline double arithmeticIntensity() const
+  {
+    const double bytes = m_bestCounts[PerfCounters::CacheMisses] * EIGEN_BENCH_CACHE_LINE_SIZE;
+    return bytes>0 ? m_bestCounts[PerfCounters::Flops] / bytes : 0;
+  }
+
+  /** Prints the counters of the best try and their derived metrics on one line.
+    * When the peak performance \a peakGflops (GFLOP/s) and bandwidth \a peakBandwidth (GB/s) of the machine
+    * are given, also prints the roofline bound at the measured arithmetic intensity and the fraction of it
+    * which is achieved. */
+  void printCounters(std::ostream& s, double peakGflops = 0, double peakBandwidth = 0) const
+  {
+    if(!m_countersEnabled)
+    {
+      s << "counters: n/a";
+      return;
+    }
+    s << "IPC " << ipc();
+    if(hasCounter(PerfCounters::CacheReferences) && m_bestCounts[PerfCounters::CacheReferences]>0)
+      s << "  LLC miss " << 100. * m_bestCounts[PerfCounters::CacheMisses] / m_bestCounts[PerfCounters::CacheReferences] << "%";
+    if(hasCounter(PerfCounters::CacheMisses))
+      s << "  " << bandwidth() << " GB/s";
+    if(hasCounter(PerfCounters::Flops))
+    {
+      s << "  " << gflops() << " GFLOP/s  AI " << arithmeticIntensity() << " flop/B";
+      if(peakGflops>0 && peakBandwidth>0)
+      {
+        const double ai = arithmeticIntensity();
+        const double bound = ai>0 ? std::min(peakGflops, ai*peakBandwidth) : peakGflops;
+        s << "  roofline " << bound << " GFLOP/s (" << (ai*peakBandwidth<peakGflops ? "memory" : "compute")
+          << " bound, " << 100.*gflops()/bound << "% achieved)";
+      }
+    }
+  }
+
   inline double getCpuTime() const
   {
 #ifdef _WIN32
@@ -162,6 +262,10 @@ protected:
   Vector2d m_bests;
   Vector2d m_worsts;
   Vector2d m_totals;
+  PerfCounters m_counters;
+  bool m_countersEnabled;
+  double m_counts[PerfCounters::EventCount];
+  double m_bestCounts[PerfCounters::EventCount];
 
 public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
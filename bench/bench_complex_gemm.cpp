@@ -0,0 +1,90 @@
+// Compares the algorithms computing the products of complex matrices (see setComplexProductAlgorithm())
+// on the products of a beamforming chain:
+//  - the beams formed by a matrix of weights W (beams x sensors) from the snapshots X (sensors x samples),
+//  - the covariance X * X^H of the snapshots.
+// For each algorithm, it reports the time, the GFLOP/s (8 real operations per complex multiply-add), and the
+// errors with respect to a product computed in long double:
+//  - the normwise relative error |C-R|/|R|,
+//  - the componentwise relative error max |C-R|_ij / (|A|*|B|)_ij.
+//
+// g++ -O3 -DNDEBUG -march=native -I.. bench_complex_gemm.cpp -o bench_complex_gemm
+// ./bench_complex_gemm [beams sensors samples]
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <Eigen/Core>
+#include "BenchTimer.h"
+using namespace Eigen;
+
+#ifndef TRIES
+#define TRIES 3
+#endif
+
+typedef Matrix<std::complex<long double>,Dynamic,Dynamic> RefMatrix;
+
+template<typename Lhs, typename Rhs, typename Res>
+void report(const char* name, const BenchTimer& timer, const Lhs& a, const Rhs& b, const Res& c, const RefMatrix& ref)
+{
+  const double flops = 8. * a.rows() * a.cols() * b.cols();
+  RefMatrix diff = c.template cast<std::complex<long double> >() - ref;
+  MatrixXd bound = a.cwiseAbs().template cast<double>() * b.cwiseAbs().template cast<double>();
+  const double normwise = double(diff.norm() / ref.norm());
+  const double componentwise = (diff.cwiseAbs().template cast<double>().array() / bound.array()).maxCoeff();
+  std::cout << "  " << std::setw(12) << std::left << name << std::right
+            << std::setw(10) << std::fixed << std::setprecision(4) << timer.best() << " s"
+            << std::setw(10) << std::setprecision(2) << flops / timer.best() * 1e-9 << " GFLOP/s"
+            << std::setw(12) << std::scientific << std::setprecision(2) << normwise
+            << std::setw(12) << componentwise << "\n";
+}
+
+template<typename Lhs, typename Rhs>
+void bench_product(const char* title, const Lhs& a, const Rhs& b)
+{
+  typedef typename Lhs::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> Mat;
+  RefMatrix ref = a.template cast<std::complex<long double> >() * b.template cast<std::complex<long double> >();
+
+  std::cout << title << " (" << a.rows() << " x " << a.cols() << " x " << b.cols() << ")\n"
+            << "  algorithm          time           speed   normwise  componentwise\n";
+  const ComplexProductAlgorithm algorithms[] = { ComplexProductInterleaved, ComplexProduct4M, ComplexProduct3M };
+  const char* names[] = { "interleaved", "4M", "3M" };
+  Mat c(a.rows(), b.cols());
+  for(int k = 0; k < 3; ++k)
+  {
+    setComplexProductAlgorithm(algorithms[k]);
+    BenchTimer timer;
+    BENCH(timer, TRIES, 1, c.noalias() = a*b);
+    report(names[k], timer, a, b, c, ref);
+  }
+  setComplexProductAlgorithm(ComplexProductInterleaved);
+}
+
+template<typename RealScalar>
+void bench_beamforming(const char* type, Index beams, Index sensors, Index samples)
+{
+  typedef std::complex<RealScalar> Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> Mat;
+  // unit weights of random phases, and noisy snapshots
+  Mat w = Mat::Random(beams, sensors).unaryExpr([](const Scalar& z) { return z / std::abs(z); });
+  Mat x = Mat::Random(sensors, samples);
+
+  std::cout << "\n" << type << "\n";
+  bench_product("beams W * X", w, x);
+  bench_product("covariance X * X^H", x, x.adjoint());
+}
+
+int main(int argc, char** argv)
+{
+  Index beams = 512, sensors = 256, samples = 4096;
+  if(argc == 4)
+  {
+    beams = std::atoi(argv[1]);
+    sensors = std::atoi(argv[2]);
+    samples = std::atoi(argv[3]);
+  }
+  std::cout << "threads: " << nbThreads() << "\n";
+  bench_beamforming<float>("complex<float>", beams, sensors, samples);
+  bench_beamforming<double>("complex<double>", beams, sensors, samples);
+  return 0;
+}
@@ -1,11 +1,21 @@
 
+// Compares the random access backends used to assemble a sparse matrix:
+//   g++ -O3 -DNDEBUG -fopenmp -I.. sparse_randomsetter.cpp -o sparse_randomsetter
+// Define EIGEN_GOOGLEHASH_SUPPORT to include the google::dense_hash_map and sparse_hash_map backends,
+// and compile in C++11 mode to include std::unordered_map.
+
 #define NOGMM
 #define NOMTL
 
 #include <map>
-#include <ext/hash_map>
+#if __cplusplus >= 201103L
+#include <unordered_map>
+#define EIGEN_UNORDERED_MAP_SUPPORT
+#endif
+#ifdef EIGEN_GOOGLEHASH_SUPPORT
 #include <google/dense_hash_map>
 #include <google/sparse_hash_map>
+#endif
 
 #ifndef SIZE
 #define SIZE 10000
@@ -20,6 +30,7 @@
 #endif
 
 #include "BenchSparseUtil.h"
+#include <unsupported/Eigen/SparseExtra>
 
 #ifndef MINDENSITY
 #define MINDENSITY 0.0004
@@ -38,30 +49,73 @@
   } timer.stop(); }
 
 
-static double rtime;
-static double nentries;
+static int nentries;
+static std::vector<int> rowIndices, colIndices;
 
 template<typename SetterType>
 void dostuff(const char* name, EigenSparseMatrix& sm1)
 {
-  int rows = sm1.rows();
-  int cols = sm1.cols();
   sm1.setZero();
   BenchTimer t;
   SetterType* set1 = new SetterType(sm1);
   t.reset(); t.start();
   for (int k=0; k<nentries; ++k)
-    (*set1)(internal::random<int>(0,rows-1),internal::random<int>(0,cols-1)) += 1;
+    (*set1)(rowIndices[k],colIndices[k]) += 1;
   t.stop();
-  std::cout << "std::map =>      \t" << t.value()-rtime
+  std::cout << name << " =>  \t" << t.value()
             << " nnz=" << set1->nonZeros() << std::flush;
 
-  // getchar();
-
   t.reset(); t.start(); delete set1; t.stop();
   std::cout << "  back: \t" << t.value() << "\n";
 }
-    
+
+void dostuffDynamic(const char* name, EigenSparseMatrix& sm1)
+{
+  BenchTimer t;
+  DynamicSparseMatrix<Scalar> dm(sm1.rows(), sm1.cols());
+  t.reset(); t.start();
+  for (int k=0; k<nentries; ++k)
+    dm.coeffRef(rowIndices[k],colIndices[k]) += 1;
+  t.stop();
+  std::cout << name << " =>  \t" << t.value()
+            << " nnz=" << dm.nonZeros() << std::flush;
+
+  t.reset(); t.start(); sm1 = dm; t.stop();
+  std::cout << "  back: \t" << t.value() << "\n";
+}
+
+void dostuffTriplets(const char* name, EigenSparseMatrix& sm1)
+{
+  BenchTimer t;
+  std::vector<Triplet<Scalar> > triplets;
+  t.reset(); t.start();
+  triplets.reserve(nentries);
+  for (int k=0; k<nentries; ++k)
+    triplets.push_back(Triplet<Scalar>(rowIndices[k],colIndices[k],1));
+  t.stop();
+  std::cout << name << " =>  \t" << t.value()
+            << " nnz=" << triplets.size() << std::flush;
+
+  t.reset(); t.start(); sm1.setFromTriplets(triplets.begin(), triplets.end()); t.stop();
+  std::cout << "  back: \t" << t.value() << "\n";
+}
+
+void dostuffConcurrent(const char* name, EigenSparseMatrix& sm1)
+{
+  BenchTimer t;
+  ConcurrentSparseBuilder<EigenSparseMatrix> builder(sm1.rows(), sm1.cols());
+  t.reset(); t.start();
+  #pragma omp parallel for
+  for (int k=0; k<nentries; ++k)
+    builder.add(rowIndices[k],colIndices[k],1);
+  t.stop();
+  std::cout << name << " =>  \t" << t.value()
+            << " nnz=" << builder.nonZeros() << std::flush;
+
+  t.reset(); t.start(); builder.finalize(sm1); t.stop();
+  std::cout << "  back: \t" << t.value() << "\n";
+}
+
 int main(int argc, char *argv[])
 {
   int rows = SIZE;
@@ -70,54 +124,31 @@ int main(int argc, char *argv[])
 
   EigenSparseMatrix sm1(rows,cols), sm2(rows,cols);
 
-
-  nentries = rows*cols*density;
-  std::cout << "n = " << nentries << "\n";
-  int dummy;
-  BenchTimer t;
-
-  t.reset(); t.start();
+  nentries = int(rows*cols*density);
+  std::cout << "n = " << nentries << ", threads = " << Eigen::nbThreads() << "\n";
+  rowIndices.resize(nentries);
+  colIndices.resize(nentries);
   for (int k=0; k<nentries; ++k)
-    dummy = internal::random<int>(0,rows-1) + internal::random<int>(0,cols-1);
-  t.stop();
-  rtime = t.value();
-  std::cout << "rtime = " << rtime << " (" << dummy << ")\n\n";
+  {
+    rowIndices[k] = internal::random<int>(0,rows-1);
+    colIndices[k] = internal::random<int>(0,cols-1);
+  }
+
   const int Bits = 6;
-  for (;;)
+  for (int i=0; i<REPEAT; ++i)
   {
-    dostuff<RandomSetter<EigenSparseMatrix,StdMapTraits,Bits> >("std::map     ", sm1);
-    dostuff<RandomSetter<EigenSparseMatrix,GnuHashMapTraits,Bits> >("gnu::hash_map", sm1);
-    dostuff<RandomSetter<EigenSparseMatrix,GoogleDenseHashMapTraits,Bits> >("google::dense", sm1);
-    dostuff<RandomSetter<EigenSparseMatrix,GoogleSparseHashMapTraits,Bits> >("google::sparse", sm1);
-
-//     {
-//       RandomSetter<EigenSparseMatrix,GnuHashMapTraits,Bits> set1(sm1);
-//       t.reset(); t.start();
-//       for (int k=0; k<n; ++k)
-//         set1(internal::random<int>(0,rows-1),internal::random<int>(0,cols-1)) += 1;
-//       t.stop();
-//       std::cout << "gnu::hash_map => \t" << t.value()-rtime
-//                 << " nnz=" << set1.nonZeros() << "\n";getchar();
-//     }
-//     {
-//       RandomSetter<EigenSparseMatrix,GoogleDenseHashMapTraits,Bits> set1(sm1);
-//       t.reset(); t.start();
-//       for (int k=0; k<n; ++k)
-//         set1(internal::random<int>(0,rows-1),internal::random<int>(0,cols-1)) += 1;
-//       t.stop();
-//       std::cout << "google::dense => \t" << t.value()-rtime
-//                 << " nnz=" << set1.nonZeros() << "\n";getchar();
-//     }
-//     {
-//       RandomSetter<EigenSparseMatrix,GoogleSparseHashMapTraits,Bits> set1(sm1);
-//       t.reset(); t.start();
-//       for (int k=0; k<n; ++k)
-//         set1(internal::random<int>(0,rows-1),internal::random<int>(0,cols-1)) += 1;
-//       t.stop();
-//       std::cout << "google::sparse => \t" << t.value()-rtime
-//                 << " nnz=" << set1.nonZeros() << "\n";getchar();
-//     }
-    std::cout << "\n\n";
+    dostuff<RandomSetter<EigenSparseMatrix,StdMapTraits,Bits> >("std::map          ", sm1);
+    #ifdef EIGEN_UNORDERED_MAP_SUPPORT
+    dostuff<RandomSetter<EigenSparseMatrix,StdUnorderedMapTraits,Bits> >("std::unordered_map", sm1);
+    #endif
+    #ifdef EIGEN_GOOGLEHASH_SUPPORT
+    dostuff<RandomSetter<EigenSparseMatrix,GoogleDenseHashMapTraits,Bits> >("google::dense     ", sm1);
+    dostuff<RandomSetter<EigenSparseMatrix,GoogleSparseHashMapTraits,Bits> >("google::sparse    ", sm1);
+    #endif
+    dostuffDynamic("DynamicSparseMatrix", sm1);
+    dostuffTriplets("setFromTriplets   ", sm1);
+    dostuffConcurrent("ConcurrentBuilder ", sm1);
+    std::cout << "\n";
   }
 
   return 0;
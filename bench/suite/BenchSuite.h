@@ -0,0 +1,270 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BENCH_SUITE_H
+#define EIGEN_BENCH_SUITE_H
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../BenchTimer.h"
+
+namespace Eigen {
+
+/** Result of one benchmark of a BenchSuite: best wall-clock time of one call, and the rates derived from the
+  * number of floating point operations and of bytes moved by one call. */
+struct BenchResult
+{
+  std::string name;
+  double seconds;
+  double gflops;
+  double gbytesPerSecond;
+  // hardware counters, zero when --counters is not given or when they are not available
+  double ipc;
+  double hwGflops;
+  double memoryGbytesPerSecond;
+
+  /** \returns the figure compared to the baseline, higher is better: GFLOP/s when the benchmark counts its
+    * operations, bytes/s when it only counts its memory traffic, and calls per second otherwise. */
+  double score() const
+  {
+    if(gflops>0)          return gflops;
+    if(gbytesPerSecond>0) return gbytesPerSecond;
+    return seconds>0 ? 1./seconds : 0;
+  }
+};
+
+/** Minimal harness shared by the benchmarks of the eigen_benchmarks suite.
+  *
+  * Each call to run() times a functor with a BenchTimer: the number of calls per try is calibrated so that a
+  * try lasts at least --min-time seconds, and the best of --tries tries is kept. The results are written as
+  * JSON by finish(), with one benchmark object per line, and compared to a baseline written by a previous run.
+  *
+  * Command line options:
+  *  - --filter <str>     only run the benchmarks whose name contains str
+  *  - --output <file>    write the JSON report to file instead of the standard output
+  *  - --baseline <file>  compare the scores to those of a previous report
+  *  - --tolerance <x>    relative slowdown tolerated before a benchmark is reported as a regression (default 0.1)
+  *  - --min-time <s>     minimal duration of a try (default 0.1)
+  *  - --tries <n>        number of tries per benchmark (default 3)
+  *  - --threads <n>      number of threads of the parallel benchmarks (default: all cores)
+  *  - --counters         also report the IPC, the FLOP/s and the memory bandwidth measured by the hardware
+  *                       performance counters of BenchTimer
+  */
+class BenchSuite
+{
+  public:
+    BenchSuite(int argc, char** argv)
+      : m_tolerance(0.1), m_minTime(0.1), m_tries(3), m_threads(0), m_counters(false)
+    {
+      for(int i=1; i<argc; ++i)
+      {
+        std::string arg(argv[i]);
+        std::string value = i+1<argc ? std::string(argv[i+1]) : std::string();
+        if     (arg=="--filter")    { m_filter = value; ++i; }
+        else if(arg=="--output")    { m_output = value; ++i; }
+        else if(arg=="--baseline")  { m_baseline = value; ++i; }
+        else if(arg=="--tolerance") { m_tolerance = std::atof(value.c_str()); ++i; }
+        else if(arg=="--min-time")  { m_minTime = std::atof(value.c_str()); ++i; }
+        else if(arg=="--tries")     { m_tries = std::max(1,std::atoi(value.c_str())); ++i; }
+        else if(arg=="--threads")   { m_threads = std::max(1,std::atoi(value.c_str())); ++i; }
+        else if(arg=="--counters")  { m_counters = true; }
+        else
+          std::cerr << "eigen_benchmarks: ignoring unknown option " << arg << "\n";
+      }
+    }
+
+    /** \returns the number of threads requested on the command line, or 0 to use all cores */
+    int threads() const { return m_threads; }
+
+    /** Sets the number of threads actually used by the parallel benchmarks, as recorded in the report */
+    void setThreads(int threads) { m_threads = threads; }
+
+    /** \returns whether the benchmark \a name is selected by --filter */
+    bool selected(const std::string& name) const
+    {
+      return m_filter.empty() || name.find(m_filter)!=std::string::npos;
+    }
+
+    /** Times \a func, one call of which performs \a flops floating point operations and moves \a bytes bytes.
+      * Either count can be zero when it is not meaningful. */
+    template<typename Func>
+    void run(const std::string& name, double flops, double bytes, Func func)
+    {
+      if(!selected(name))
+        return;
+
+      BenchTimer timer;
+      if(m_counters && !timer.enableCounters())
+      {
+        std::cerr << "eigen_benchmarks: hardware performance counters are not available\n";
+        m_counters = false;
+      }
+      // calibration call, also warming up the caches and the thread pools
+      timer.start();
+      func();
+      timer.stop();
+      const double first = timer.value(REAL_TIMER);
+      const int rep = first>=m_minTime ? 1 : int(std::ceil(m_minTime/std::max(first,1e-9)));
+
+      BENCH(timer, m_tries, rep, func());
+
+      BenchResult result;
+      result.name = name;
+      result.seconds = timer.best(REAL_TIMER)/rep;
+      result.gflops = flops>0 ? 1e-9*flops/result.seconds : 0;
+      result.gbytesPerSecond = bytes>0 ? 1e-9*bytes/result.seconds : 0;
+      result.ipc = m_counters ? timer.ipc() : 0;
+      result.hwGflops = m_counters ? timer.gflops() : 0;
+      result.memoryGbytesPerSecond = m_counters ? timer.bandwidth() : 0;
+      m_results.push_back(result);
+
+      std::cerr << std::left << std::setw(48) << name << std::right
+                << std::setw(12) << result.seconds << " s";
+      if(result.gflops>0)          std::cerr << std::setw(10) << result.gflops << " GFLOP/s";
+      if(result.gbytesPerSecond>0) std::cerr << std::setw(10) << result.gbytesPerSecond << " GB/s";
+      if(m_counters)
+      {
+        std::cerr << "  ";
+        timer.printCounters(std::cerr);
+      }
+      std::cerr << "\n";
+    }
+
+    /** Writes the report and compares it to the baseline.
+      * \returns 0 on success, 1 when a benchmark regressed beyond the tolerance or the report cannot be written */
+    int finish() const
+    {
+      if(m_output.empty())
+        writeReport(std::cout);
+      else
+      {
+        std::ofstream file(m_output.c_str());
+        if(!file)
+        {
+          std::cerr << "eigen_benchmarks: cannot write " << m_output << "\n";
+          return 1;
+        }
+        writeReport(file);
+      }
+      return m_baseline.empty() ? 0 : compareToBaseline();
+    }
+
+  protected:
+    void writeReport(std::ostream& s) const
+    {
+      s << "{\n";
+      s << "  \"eigen_version\": \"" << EIGEN_WORLD_VERSION << "." << EIGEN_MAJOR_VERSION << "." << EIGEN_MINOR_VERSION << "\",\n";
+#ifdef __VERSION__
+      s << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+#endif
+      s << "  \"simd\": \"" << SimdInstructionSetsInUse() << "\",\n";
+      s << "  \"threads\": " << m_threads << ",\n";
+      s << "  \"benchmarks\": [\n";
+      s << std::setprecision(6);
+      for(std::size_t i=0; i<m_results.size(); ++i)
+      {
+        const BenchResult& r = m_results[i];
+        s << "    {\"name\": \"" << r.name << "\", \"seconds\": " << r.seconds
+          << ", \"gflops\": " << r.gflops << ", \"gbytes_per_second\": " << r.gbytesPerSecond;
+        if(m_counters)
+          s << ", \"ipc\": " << r.ipc << ", \"hw_gflops\": " << r.hwGflops
+            << ", \"memory_gbytes_per_second\": " << r.memoryGbytesPerSecond;
+        s << "}"
+          << (i+1<m_results.size() ? "," : "") << "\n";
+      }
+      s << "  ]\n";
+      s << "}\n";
+    }
+
+    // Reads the number following "key": in line
+    static bool extractNumber(const std::string& line, const std::string& key, double& value)
+    {
+      std::string::size_type pos = line.find("\"" + key + "\":");
+      if(pos==std::string::npos)
+        return false;
+      value = std::atof(line.c_str() + pos + key.size() + 3);
+      return true;
+    }
+
+    // Reads the benchmark objects of a report written by writeReport(), one per line
+    bool readBaseline(std::map<std::string,BenchResult>& baseline) const
+    {
+      std::ifstream file(m_baseline.c_str());
+      if(!file)
+        return false;
+      std::string line;
+      while(std::getline(file, line))
+      {
+        const std::string key("\"name\": \"");
+        std::string::size_type pos = line.find(key);
+        if(pos==std::string::npos)
+          continue;
+        pos += key.size();
+        BenchResult r;
+        r.name = line.substr(pos, line.find('"', pos)-pos);
+        if(!extractNumber(line, "seconds", r.seconds)) r.seconds = 0;
+        if(!extractNumber(line, "gflops", r.gflops)) r.gflops = 0;
+        if(!extractNumber(line, "gbytes_per_second", r.gbytesPerSecond)) r.gbytesPerSecond = 0;
+        r.ipc = r.hwGflops = r.memoryGbytesPerSecond = 0;
+        baseline[r.name] = r;
+      }
+      return true;
+    }
+
+    int compareToBaseline() const
+    {
+      std::map<std::string,BenchResult> baseline;
+      if(!readBaseline(baseline))
+      {
+        std::cerr << "eigen_benchmarks: no baseline found at " << m_baseline << ", skipping the comparison\n";
+        return 0;
+      }
+      int regressions = 0;
+      std::cerr << "\ncomparison to " << m_baseline << " (tolerance " << m_tolerance*100 << "%):\n";
+      for(std::size_t i=0; i<m_results.size(); ++i)
+      {
+        const BenchResult& r = m_results[i];
+        std::map<std::string,BenchResult>::const_iterator it = baseline.find(r.name);
+        if(it==baseline.end() || it->second.score()<=0)
+          continue;
+        const double ratio = r.score() / it->second.score();
+        const bool regressed = ratio < 1.-m_tolerance;
+        regressions += regressed;
+        std::cerr << std::left << std::setw(48) << r.name << std::right << std::setw(10)
+                  << std::fixed << std::setprecision(3) << ratio << "x"
+                  << (regressed ? "  REGRESSION" : "") << "\n";
+        std::cerr.unsetf(std::ios::floatfield);
+      }
+      if(regressions>0)
+        std::cerr << regressions << " benchmark(s) regressed\n";
+      return regressions>0 ? 1 : 0;
+    }
+
+    std::string m_filter;
+    std::string m_output;
+    std::string m_baseline;
+    double m_tolerance;
+    double m_minTime;
+    int m_tries;
+    int m_threads;
+    bool m_counters;
+    std::vector<BenchResult> m_results;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_BENCH_SUITE_H
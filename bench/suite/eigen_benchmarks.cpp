@@ -0,0 +1,234 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Curated benchmark suite run by the eigen_benchmarks target, see bench/suite/README.
+
+#define EIGEN_USE_THREADS
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <Eigen/SparseLU>
+#include <unsupported/Eigen/CXX11/Tensor>
+#include <unsupported/Eigen/CXX11/ThreadPool>
+#include <thread>
+
+#include "BenchSuite.h"
+
+using namespace Eigen;
+
+template<typename Scalar>
+void bench_gemm(BenchSuite& suite, const std::string& type, Index n)
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> Mat;
+  Mat a = Mat::Random(n,n), b = Mat::Random(n,n), c = Mat::Zero(n,n);
+  std::stringstream name;
+  name << "gemm/" << type << "/" << n;
+  // a complex multiply-add is 8 real operations
+  const double flopsPerMadd = NumTraits<Scalar>::IsComplex ? 8 : 2;
+  suite.run(name.str(), flopsPerMadd*n*n*n, 4.*n*n*sizeof(Scalar), [&]{ c.noalias() += a*b; escape(c.data()); });
+}
+
+template<typename Scalar>
+void bench_gemv(BenchSuite& suite, const std::string& type, Index n)
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> Mat;
+  typedef Matrix<Scalar,Dynamic,1> Vec;
+  Mat a = Mat::Random(n,n);
+  Vec x = Vec::Random(n), y = Vec::Zero(n);
+  std::stringstream name;
+  name << "gemv/" << type << "/" << n;
+  suite.run(name.str(), 2.*n*n, (n*n+3.*n)*sizeof(Scalar), [&]{ y.noalias() += a*x; escape(y.data()); });
+  name.str("");
+  name << "gemv_transposed/" << type << "/" << n;
+  suite.run(name.str(), 2.*n*n, (n*n+3.*n)*sizeof(Scalar), [&]{ y.noalias() += a.transpose()*x; escape(y.data()); });
+}
+
+template<typename Scalar>
+void bench_trsm(BenchSuite& suite, const std::string& type, Index n, Index cols)
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> Mat;
+  Mat l = Mat::Random(n,n);
+  l.diagonal().array() += Scalar(n);
+  Mat b = Mat::Random(n,cols), x(n,cols);
+  std::stringstream name;
+  name << "trsm/" << type << "/" << n << "x" << cols;
+  suite.run(name.str(), double(n)*n*cols, (n*n/2.+2.*n*cols)*sizeof(Scalar),
+            [&]{ x = b; l.template triangularView<Lower>().solveInPlace(x); escape(x.data()); });
+}
+
+template<typename Scalar>
+void bench_decompositions(BenchSuite& suite, const std::string& type, Index n)
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> Mat;
+  Mat a = Mat::Random(n,n);
+  Mat spd = a*a.adjoint() + Mat::Identity(n,n)*Scalar(n);
+  std::stringstream size;
+  size << "/" << type << "/" << n;
+  const double n3 = double(n)*n*n;
+
+  LLT<Mat> llt(n);
+  suite.run("llt" + size.str(), n3/3., 0, [&]{ llt.compute(spd); escape(&llt); });
+  PartialPivLU<Mat> lu(n);
+  suite.run("partial_piv_lu" + size.str(), 2.*n3/3., 0, [&]{ lu.compute(a); escape(&lu); });
+  HouseholderQR<Mat> qr(n,n);
+  suite.run("householder_qr" + size.str(), 4.*n3/3., 0, [&]{ qr.compute(a); escape(&qr); });
+  SelfAdjointEigenSolver<Mat> eig(n);
+  // usual estimate of a tridiagonalization followed by the QR iterations with eigenvectors
+  suite.run("selfadjoint_eigensolver" + size.str(), 9.*n3, 0, [&]{ eig.compute(spd); escape(&eig); });
+}
+
+// 5-point Laplacian on a grid x grid mesh
+template<typename Scalar>
+SparseMatrix<Scalar> laplacian_2d(Index grid)
+{
+  std::vector<Triplet<Scalar> > triplets;
+  triplets.reserve(5*grid*grid);
+  for(Index j=0; j<grid; ++j)
+    for(Index i=0; i<grid; ++i)
+    {
+      const Index k = i + j*grid;
+      triplets.push_back(Triplet<Scalar>(k, k, 4));
+      if(i>0)      triplets.push_back(Triplet<Scalar>(k, k-1, -1));
+      if(i<grid-1) triplets.push_back(Triplet<Scalar>(k, k+1, -1));
+      if(j>0)      triplets.push_back(Triplet<Scalar>(k, k-grid, -1));
+      if(j<grid-1) triplets.push_back(Triplet<Scalar>(k, k+grid, -1));
+    }
+  SparseMatrix<Scalar> a(grid*grid, grid*grid);
+  a.setFromTriplets(triplets.begin(), triplets.end());
+  return a;
+}
+
+void bench_sparse(BenchSuite& suite, Index grid)
+{
+  typedef SparseMatrix<double> SpMat;
+  typedef SparseMatrix<double,RowMajor> SpMatRow;
+  typedef VectorXd Vec;
+  SpMat a = laplacian_2d<double>(grid);
+  SpMatRow ar = a;
+  const Index n = a.rows();
+  Vec x = Vec::Random(n), y = Vec::Zero(n), b = Vec::Ones(n);
+  std::stringstream size;
+  size << "/double/" << grid << "x" << grid;
+  const double spmvBytes = a.nonZeros()*(sizeof(double)+sizeof(int)) + 2.*n*sizeof(double);
+
+  suite.run("spmv_csc" + size.str(), 2.*a.nonZeros(), spmvBytes, [&]{ y.noalias() += a*x; escape(y.data()); });
+  suite.run("spmv_csr" + size.str(), 2.*a.nonZeros(), spmvBytes, [&]{ y.noalias() += ar*x; escape(y.data()); });
+
+  SimplicialLDLT<SpMat> ldlt;
+  ldlt.analyzePattern(a);
+  suite.run("simplicial_ldlt_factorize" + size.str(), 0, 0, [&]{ ldlt.factorize(a); escape(&ldlt); });
+  suite.run("simplicial_ldlt_solve" + size.str(), 0, 0, [&]{ y = ldlt.solve(b); escape(y.data()); });
+
+  SparseLU<SpMat> lu;
+  lu.analyzePattern(a);
+  suite.run("sparse_lu_factorize" + size.str(), 0, 0, [&]{ lu.factorize(a); escape(&lu); });
+
+  ConjugateGradient<SpMat, Lower|Upper> cg;
+  cg.setMaxIterations(100);
+  cg.setTolerance(0);
+  cg.compute(a);
+  // fixed number of iterations, each one is a SpMV and a few vector operations
+  suite.run("conjugate_gradient_100_iterations" + size.str(), 100*(2.*a.nonZeros()+10.*n), 0,
+            [&]{ y = cg.solve(b); escape(y.data()); });
+}
+
+void bench_tensor(BenchSuite& suite, ThreadPoolDevice& device, Index n, Index size)
+{
+  typedef Tensor<float,2> Tensor2;
+  typedef Tensor<float,1> Tensor1;
+  Tensor2 a(n,n), b(n,n), c(n,n);
+  a.setRandom(); b.setRandom(); c.setZero();
+  Eigen::array<IndexPair<int>,1> dims = {{ IndexPair<int>(1,0) }};
+  std::stringstream name;
+  name << "tensor_contraction/float/" << n;
+  suite.run(name.str(), 2.*n*n*n, 3.*n*n*sizeof(float), [&]{ c = a.contract(b, dims); escape(c.data()); });
+  name.str("");
+  name << "tensor_contraction_threadpool/float/" << n;
+  suite.run(name.str(), 2.*n*n*n, 3.*n*n*sizeof(float), [&]{ c.device(device) = a.contract(b, dims); escape(c.data()); });
+
+  Tensor1 x(size), y(size), z(size);
+  x.setRandom(); y.setRandom(); z.setZero();
+  name.str("");
+  name << "tensor_cwise/float/" << size;
+  suite.run(name.str(), 2.*size, 4.*size*sizeof(float), [&]{ z = x*y + z; escape(z.data()); });
+  name.str("");
+  name << "tensor_cwise_threadpool/float/" << size;
+  suite.run(name.str(), 2.*size, 4.*size*sizeof(float), [&]{ z.device(device) = x*y + z; escape(z.data()); });
+
+  Tensor1 colSums(n);
+  Eigen::array<int,1> reduceDims = {{ 0 }};
+  name.str("");
+  name << "tensor_reduction/float/" << n;
+  suite.run(name.str(), double(n)*n, double(n)*n*sizeof(float), [&]{ colSums = a.sum(reduceDims); escape(colSums.data()); });
+  name.str("");
+  name << "tensor_reduction_threadpool/float/" << n;
+  suite.run(name.str(), double(n)*n, double(n)*n*sizeof(float),
+            [&]{ colSums.device(device) = a.sum(reduceDims); escape(colSums.data()); });
+}
+
+// suffix distinguishes the runs with non-default settings of the pool
+void bench_thread_pool(BenchSuite& suite, ThreadPool& pool, int tasks, const std::string& suffix = "")
+{
+  std::stringstream name;
+  name << "thread_pool_schedule" << suffix << "/" << tasks << "_tasks";
+  suite.run(name.str(), 0, 0, [&]{
+    Barrier barrier(tasks);
+    for(int i=0; i<tasks; ++i)
+      pool.Schedule([&barrier]{ barrier.Notify(); });
+    barrier.Wait();
+  });
+
+  ThreadPoolDevice device(&pool, pool.NumThreads());
+  name.str("");
+  name << "thread_pool_parallel_for" << suffix << "/" << tasks << "_blocks";
+  std::vector<float> data(tasks*1024, 1.f);
+  suite.run(name.str(), 0, data.size()*sizeof(float), [&]{
+    device.parallelFor(tasks, TensorOpCost(4096, 4096, 1024),
+                       [&](Index first, Index last) {
+                         for(Index i=first*1024; i<last*1024; ++i) data[i] = data[i]*0.5f + 1.f;
+                       });
+    escape(&data[0]);
+  });
+}
+
+int main(int argc, char** argv)
+{
+  BenchSuite suite(argc, argv);
+  const int threads = suite.threads()>0 ? suite.threads() : std::max(1, int(std::thread::hardware_concurrency()));
+  suite.setThreads(threads);
+  Eigen::setNbThreads(threads);
+
+  bench_gemm<float>(suite, "float", 256);
+  bench_gemm<float>(suite, "float", 1024);
+  bench_gemm<double>(suite, "double", 256);
+  bench_gemm<double>(suite, "double", 1024);
+  bench_gemm<std::complex<double> >(suite, "complex_double", 512);
+  setComplexProductAlgorithm(ComplexProduct4M);
+  bench_gemm<std::complex<double> >(suite, "complex_double_4m", 512);
+  setComplexProductAlgorithm(ComplexProduct3M);
+  bench_gemm<std::complex<double> >(suite, "complex_double_3m", 512);
+  setComplexProductAlgorithm(ComplexProductInterleaved);
+  bench_gemv<float>(suite, "float", 2048);
+  bench_gemv<double>(suite, "double", 2048);
+  bench_trsm<double>(suite, "double", 1024, 256);
+  bench_decompositions<double>(suite, "double", 512);
+  bench_sparse(suite, 200);
+
+  ThreadPool pool(threads);
+  ThreadPoolDevice device(&pool, threads);
+  bench_tensor(suite, device, 512, 1<<22);
+  bench_thread_pool(suite, pool, 4096);
+  pool.EnableStatistics(true);
+  bench_thread_pool(suite, pool, 4096, "_with_statistics");
+  pool.EnableStatistics(false);
+  pool.SetSpinPolicy(ThreadPool::kAdaptiveSpinning);
+  bench_thread_pool(suite, pool, 4096, "_adaptive_spinning");
+  pool.SetSpinPolicy(ThreadPool::kFixedSpinning);
+
+  return suite.finish();
+}
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "benchmark.h"
+#include "../BenchPerfCounters.h"
 #include <regex.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -26,6 +27,10 @@
 static int64_t g_flops_processed;
 static int64_t g_benchmark_total_time_ns;
 static int64_t g_benchmark_start_time_ns;
+// Hardware counters, enabled with --counters
+static bool g_use_counters = false;
+static Eigen::PerfCounters g_counters;
+static double g_counts[Eigen::PerfCounters::EventCount];
 typedef std::map<std::string, ::testing::Benchmark*> BenchmarkMap;
 typedef BenchmarkMap::iterator BenchmarkMapIt;
 
@@ -141,6 +146,10 @@ void Benchmark::Run() {
 void Benchmark::RunRepeatedlyWithArg(int iterations, int arg) {
   g_flops_processed = 0;
   g_benchmark_total_time_ns = 0;
+  if (g_use_counters) {
+    g_counters.reset();
+    g_counters.enable();
+  }
   g_benchmark_start_time_ns = NanoTime();
   if (fn_ != NULL) {
     fn_(iterations);
@@ -150,6 +159,10 @@ void Benchmark::RunRepeatedlyWithArg(int iterations, int arg) {
   if (g_benchmark_start_time_ns != 0) {
     g_benchmark_total_time_ns += NanoTime() - g_benchmark_start_time_ns;
   }
+  if (g_use_counters) {
+    g_counters.disable();
+    g_counters.read(g_counts);
+  }
 }
 void Benchmark::RunWithArg(int arg) {
   // run once in case it's expensive
@@ -185,8 +198,21 @@ void Benchmark::RunWithArg(int arg) {
   } else {
     snprintf(full_name, sizeof(full_name), "%s", name_);
   }
-  printf("%-*s %10d %10" PRId64 "%s\n", g_name_column_width, full_name,
-         iterations, g_benchmark_total_time_ns/iterations, throughput);
+  char counters[200];
+  counters[0] = '\0';
+  if (g_use_counters && g_benchmark_total_time_ns > 0) {
+    using Eigen::PerfCounters;
+    double seconds = static_cast<double>(g_benchmark_total_time_ns)/1e9;
+    double ipc = g_counts[PerfCounters::Cycles] > 0 ? g_counts[PerfCounters::Instructions]/g_counts[PerfCounters::Cycles] : 0;
+    double bytes = g_counts[PerfCounters::CacheMisses] * EIGEN_BENCH_CACHE_LINE_SIZE;
+    int len = snprintf(counters, sizeof(counters), " IPC %5.2f %8.2f GB/s", ipc, 1e-9*bytes/seconds);
+    if (g_counters.available(PerfCounters::Flops) && len > 0) {
+      snprintf(counters + len, sizeof(counters) - len, " %8.2f hw GFLOP/s AI %6.2f flop/B",
+               1e-9*g_counts[PerfCounters::Flops]/seconds, bytes > 0 ? g_counts[PerfCounters::Flops]/bytes : 0.);
+    }
+  }
+  printf("%-*s %10d %10" PRId64 "%s%s\n", g_name_column_width, full_name,
+         iterations, g_benchmark_total_time_ns/iterations, throughput, counters);
   fflush(stdout);
 }
 }  // namespace testing
@@ -196,15 +222,31 @@ void SetBenchmarkFlopsProcessed(int64_t x) {
 void StopBenchmarkTiming() {
   if (g_benchmark_start_time_ns != 0) {
     g_benchmark_total_time_ns += NanoTime() - g_benchmark_start_time_ns;
+    if (g_use_counters) g_counters.disable();
   }
   g_benchmark_start_time_ns = 0;
 }
 void StartBenchmarkTiming() {
   if (g_benchmark_start_time_ns == 0) {
+    if (g_use_counters) g_counters.enable();
     g_benchmark_start_time_ns = NanoTime();
   }
 }
 int main(int argc, char* argv[]) {
+  // --counters reports hardware performance counters, the other arguments select the benchmarks
+  int nargs = 1;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--counters") == 0) {
+      g_use_counters = true;
+    } else {
+      argv[nargs++] = argv[i];
+    }
+  }
+  argc = nargs;
+  if (g_use_counters && !g_counters.open()) {
+    fprintf(stderr, "Hardware performance counters are not available\n");
+    g_use_counters = false;
+  }
   if (gBenchmarks().empty()) {
     fprintf(stderr, "No benchmarks registered!\n");
     exit(EXIT_FAILURE);
@@ -202,6 +202,84 @@ template<typename ArrayType> void comparisons(const ArrayType& m)
   VERIFY_IS_APPROX(((m1.abs()+1)>RealScalar(0.1)).rowwise().count(), ArrayOfIndices::Constant(rows, cols));
 }
 
+// Select, count(), any() and all() of comparisons are vectorized from their lane masks: check them against
+// coefficient-wise references, with NaNs, combinations of masks, blocks and mixed storage orders.
+template<typename ArrayType> void comparison_masks(const ArrayType& m)
+{
+  typedef typename ArrayType::Scalar Scalar;
+  typedef Array<Scalar, Dynamic, Dynamic, RowMajor> RowMajorArray;
+
+  Index rows = m.rows();
+  Index cols = m.cols();
+
+  ArrayType m1 = ArrayType::Random(rows, cols),
+            m2 = ArrayType::Random(rows, cols),
+            m3 = ArrayType::Random(rows, cols),
+            m4 = ArrayType::Random(rows, cols),
+            res(rows, cols), ref(rows, cols);
+  m2(0,0) = m1(0,0);
+  if (!NumTraits<Scalar>::IsInteger && rows*cols>1)
+  {
+    Index k = internal::random<Index>(1, rows*cols-1);
+    m1(k%rows, k/rows) = NumTraits<Scalar>::quiet_NaN();
+  }
+  Scalar t = m2(rows-1,cols-1);
+
+  Index count_lt = 0, count_ge = 0, count_ne = 0, count_in = 0;
+  for (Index j = 0; j < cols; ++j)
+  for (Index i = 0; i < rows; ++i)
+  {
+    count_lt += m1(i,j) < m2(i,j);
+    count_ge += m1(i,j) >= t;
+    count_ne += m1(i,j) != m2(i,j);
+    count_in += m1(i,j) > -t && m1(i,j) <= t;
+    ref(i,j) = m1(i,j) < m2(i,j) || m1(i,j) == m2(i,j) ? m3(i,j) : m4(i,j);
+  }
+  VERIFY_IS_EQUAL((m1 < m2).count(), count_lt);
+  VERIFY_IS_EQUAL((m1 >= t).count(), count_ge);
+  VERIFY_IS_EQUAL((m1 != m2).count(), count_ne);
+  VERIFY_IS_EQUAL((m1 > -t && m1 <= t).count(), count_in);
+  VERIFY_IS_EQUAL((m2 > m1 || m2 <= m1).count(), (m1 == m1).count());
+  VERIFY_IS_EQUAL((m1 == m1).all(), !m1.hasNaN());
+  VERIFY_IS_EQUAL((m1 != m1).any(), bool(m1.hasNaN()));
+  VERIFY((m1 == m2).any());
+  VERIFY(!(m2 < m2).any());
+  VERIFY((m2 <= m2).all());
+  VERIFY_IS_EQUAL((m1 < m2).any(), count_lt > 0);
+  VERIFY_IS_EQUAL((m1 >= t).all(), count_ge == rows*cols);
+
+  res = (m1 < m2 || m1 == m2).select(m3, m4);
+  VERIFY_IS_APPROX(res, ref);
+  res = (m1 > m2).select(m3, Scalar(0));
+  for (Index j = 0; j < cols; ++j)
+  for (Index i = 0; i < rows; ++i)
+    ref(i,j) = m1(i,j) > m2(i,j) ? m3(i,j) : Scalar(0);
+  VERIFY_IS_APPROX(res, ref);
+
+  // inner blocks are not linearly accessible
+  Index r = internal::random<Index>(0, rows-1), c = internal::random<Index>(0, cols-1);
+  Index br = internal::random<Index>(1, rows-r), bc = internal::random<Index>(1, cols-c);
+  res.block(r, c, br, bc) = (m1.block(r, c, br, bc) < m2.block(r, c, br, bc)).select(m3.block(r, c, br, bc), m4.block(r, c, br, bc));
+  for (Index j = c; j < c+bc; ++j)
+  for (Index i = r; i < r+br; ++i)
+    ref(i,j) = m1(i,j) < m2(i,j) ? m3(i,j) : m4(i,j);
+  VERIFY_IS_APPROX(res.block(r, c, br, bc), ref.block(r, c, br, bc));
+  Index count_block = 0;
+  for (Index j = c; j < c+bc; ++j)
+  for (Index i = r; i < r+br; ++i)
+    count_block += m1(i,j) < m2(i,j);
+  VERIFY_IS_EQUAL((m1.block(r, c, br, bc) < m2.block(r, c, br, bc)).count(), count_block);
+
+  // the condition and the selected expressions have different storage orders
+  RowMajorArray m1r = m1, m2r = m2;
+  res = (m1r < m2r).select(m3, m4);
+  for (Index j = 0; j < cols; ++j)
+  for (Index i = 0; i < rows; ++i)
+    ref(i,j) = m1(i,j) < m2(i,j) ? m3(i,j) : m4(i,j);
+  VERIFY_IS_APPROX(res, ref);
+  VERIFY_IS_EQUAL((m1r < m2).count(), count_lt);
+}
+
 template<typename ArrayType> void array_real(const ArrayType& m)
 {
   using std::abs;
@@ -453,6 +531,63 @@ template<typename ArrayType> void min_max(const ArrayType& m)
 
 }
 
+template<typename DstScalar, typename SrcXpr> void check_cast(const SrcXpr& src)
+{
+  typedef typename internal::remove_all<typename SrcXpr::template CastXpr<DstScalar>::Type>::type::PlainObject DstArray;
+
+  DstArray dst = src.template cast<DstScalar>();
+  VERIFY(dst.rows() == src.rows() && dst.cols() == src.cols());
+  for(Index j = 0; j < src.cols(); ++j)
+    for(Index i = 0; i < src.rows(); ++i)
+      VERIFY(dst(i,j) == static_cast<DstScalar>(src(i,j)));
+
+  // a dynamic destination is filled by full packets whatever the size of the source
+  Array<DstScalar,Dynamic,Dynamic> dynDst = src.template cast<DstScalar>();
+  VERIFY((dynDst == dst).all());
+}
+
+template<typename SrcArray> void check_casts_of(const SrcArray& src)
+{
+  check_cast<float>(src);
+  check_cast<double>(src);
+  check_cast<int>(src);
+  check_cast<half>(src.template cast<float>());
+  check_cast<float>(src.template cast<float>().template cast<half>().eval());
+
+  Index rows = src.rows();
+  Index cols = src.cols();
+  if(rows > 1 && cols > 1)
+  {
+    check_cast<float>(src.block(1, 1, rows-1, cols-1));
+    check_cast<double>(src.block(1, 1, rows-1, cols-1));
+    check_cast<int>(src.block(0, 1, rows-1, cols-1));
+  }
+  check_cast<float>(src.transpose());
+  check_cast<int>(src.transpose());
+  check_cast<float>(src.col(cols-1));
+  check_cast<float>(src.row(rows-1));
+}
+
+template<typename ArrayType> void casts(const ArrayType& m)
+{
+  typedef typename ArrayType::Scalar Scalar;
+  enum { Rows = ArrayType::RowsAtCompileTime, Cols = ArrayType::ColsAtCompileTime };
+  Index rows = m.rows();
+  Index cols = m.cols();
+
+  // the small integers have no packets, but are read by converting loads
+  check_casts_of(Array<signed char, Rows, Cols>::Random(rows, cols).eval());
+  check_casts_of(Array<unsigned char, Rows, Cols>::Random(rows, cols).eval());
+  check_casts_of(Array<short, Rows, Cols>::Random(rows, cols).eval());
+  check_casts_of(Array<unsigned short, Rows, Cols>::Random(rows, cols).eval());
+
+  // the floating point values must fit in an int
+  ArrayType m1 = ArrayType::Random(rows, cols) * Scalar(1000);
+  check_casts_of(m1);
+  check_casts_of(Array<int, Rows, Cols>::Random(rows, cols).eval());
+  check_casts_of((m1.template cast<int>()).eval());
+}
+
 EIGEN_DECLARE_TEST(array_cwise)
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -470,6 +605,14 @@ EIGEN_DECLARE_TEST(array_cwise)
     CALL_SUBTEST_5( comparisons(ArrayXXf(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
     CALL_SUBTEST_6( comparisons(ArrayXXi(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
   }
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( comparison_masks(Array<float, 1, 1>()) );
+    CALL_SUBTEST_2( comparison_masks(Array22f()) );
+    CALL_SUBTEST_3( comparison_masks(Array44d()) );
+    CALL_SUBTEST_5( comparison_masks(ArrayXXf(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_5( comparison_masks(ArrayXXd(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_6( comparison_masks(ArrayXXi(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+  }
   for(int i = 0; i < g_repeat; i++) {
     CALL_SUBTEST_1( min_max(Array<float, 1, 1>()) );
     CALL_SUBTEST_2( min_max(Array22f()) );
@@ -483,6 +626,13 @@ EIGEN_DECLARE_TEST(array_cwise)
     CALL_SUBTEST_3( array_real(Array44d()) );
     CALL_SUBTEST_5( array_real(ArrayXXf(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
   }
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( casts(Array<float, 1, 1>()) );
+    CALL_SUBTEST_2( casts(Array22f()) );
+    CALL_SUBTEST_3( casts(Array44d()) );
+    CALL_SUBTEST_5( casts(ArrayXXf(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_5( casts(ArrayXXd(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+  }
   for(int i = 0; i < g_repeat; i++) {
     CALL_SUBTEST_4( array_complex(ArrayXXcf(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
   }
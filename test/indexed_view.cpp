@@ -415,6 +415,26 @@ void check_indexed_view()
     VERIFY_IS_EQUAL( A3(ind,ind).eval(), MatrixXi::Constant(5,5,A3(1,1)) );
   }
 
+  // Gathered and scattered packet accesses through index arrays
+  {
+    MatrixXd B = MatrixXd::Random(37,23), C(37,23), D = MatrixXd::Zero(37,23);
+    Matrix<double,Dynamic,Dynamic,RowMajor> Br = B;
+    VectorXf v = VectorXf::Random(37), w = VectorXf::Zero(37);
+    std::vector<int> perm(37);
+    for(int k=0; k<37; ++k) perm[k] = (k*11)%37;
+    ArrayXi cperm = ArrayXi::LinSpaced(23,22,0);
+    C = B(perm,all);
+    for(int k=0; k<37; ++k) VERIFY_IS_EQUAL( C.row(k), B.row(perm[k]) );
+    C = B(perm,cperm);
+    for(int k=0; k<37; ++k) VERIFY_IS_EQUAL( C.row(k), B.row(perm[k])(cperm) );
+    Matrix<double,Dynamic,Dynamic,RowMajor> Cr = Br(perm,cperm);
+    VERIFY_IS_EQUAL( MatrixXd(Cr), C );
+    D(perm,all) = B;
+    for(int k=0; k<37; ++k) VERIFY_IS_EQUAL( D.row(perm[k]), B.row(k) );
+    w(perm) = v;
+    VERIFY_IS_EQUAL( w(perm).eval(), v );
+  }
+
 }
 
 EIGEN_DECLARE_TEST(indexed_view)
@@ -48,6 +48,12 @@
 #ifdef EIGEN_USE_THREADS
 #include <future>
 #endif
+#ifdef EIGEN_PROFILING_HOOKS
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#endif
 #endif
 
 // Same for cuda_fp16.h
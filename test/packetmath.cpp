@@ -627,9 +627,66 @@ template<typename Scalar,typename Packet> void packetmath_scatter_gather()
   for (int i = 0; i < PacketSize; ++i) {
     VERIFY(isApproxAbs(data1[i], buffer[i*7], refvalue) && "pgather");
   }
+
+  // distinct indices in arbitrary order, within buffer[0..4*PacketSize)
+  int indices[PacketSize];
+  for (int i = 0; i < PacketSize; ++i) {
+    indices[i] = 4*(PacketSize-1-i) + internal::random<int>(0,3);
+  }
+  packet = internal::pgather_indexed<Scalar, Packet>(buffer, indices);
+  internal::pstore(data1, packet);
+  for (int i = 0; i < PacketSize; ++i) {
+    VERIFY(isApproxAbs(data1[i], buffer[indices[i]], refvalue) && "pgather_indexed");
+  }
+
+  memset(buffer, 0, 20*PacketSize*sizeof(Scalar));
+  internal::pscatter_indexed<Scalar, Packet>(buffer, packet, indices);
+  for (int i = 0; i < PacketSize; ++i) {
+    VERIFY(isApproxAbs(buffer[indices[i]], data1[i], refvalue) && "pscatter_indexed");
+    buffer[indices[i]] = Scalar(0);
+  }
+  for (int i = 0; i < PacketSize*20; ++i) {
+    VERIFY(isApproxAbs(buffer[i], Scalar(0), refvalue) && "pscatter_indexed");
+  }
 }
 
 
+// lane masks of the packet comparisons, blended by pselect and reduced by pmask_any/pmask_all
+template<typename Scalar,typename Packet,
+         bool HasCmp = internal::packet_traits<Scalar>::HasCmp && !internal::is_same<Scalar,Packet>::value>
+struct packetmath_masks {
+  static void run() {}
+};
+
+template<typename Scalar,typename Packet>
+struct packetmath_masks<Scalar,Packet,true> {
+  static void run()
+  {
+    const int PacketSize = internal::unpacket_traits<Packet>::size;
+    EIGEN_ALIGN_MAX Scalar a[PacketSize];
+    EIGEN_ALIGN_MAX Scalar b[PacketSize];
+    EIGEN_ALIGN_MAX Scalar res[PacketSize];
+    bool lt[PacketSize];
+    for (int k = 0; k < 20; ++k) {
+      // all lanes false, all lanes true, then random patterns
+      int count = 0;
+      for (int i = 0; i < PacketSize; ++i) {
+        lt[i] = k == 0 ? false : k == 1 ? true : internal::random<bool>();
+        count += lt[i];
+        a[i] = internal::random<Scalar>(-1,1);
+        b[i] = lt[i] ? a[i] + Scalar(1) : a[i] - internal::random<Scalar>(0,1);
+      }
+      Packet pa = internal::pload<Packet>(a), pb = internal::pload<Packet>(b);
+      Packet mask = internal::pcmp_lt(pa, pb);
+      internal::pstore(res, internal::pselect(mask, pa, pb));
+      for (int i = 0; i < PacketSize; ++i)
+        VERIFY(res[i] == (lt[i] ? a[i] : b[i]) && "pselect");
+      VERIFY(internal::pmask_any(mask) == (count > 0) && "pmask_any");
+      VERIFY(internal::pmask_all(mask) == (count == PacketSize) && "pmask_all");
+    }
+  }
+};
+
 template<
   typename Scalar,
   typename PacketType,
@@ -644,6 +701,7 @@ struct runall<Scalar,PacketType,false,false> { // i.e. float or double
     packetmath_scatter_gather<Scalar,PacketType>();
     packetmath_notcomplex<Scalar,PacketType>();
     packetmath_real<Scalar,PacketType>();
+    packetmath_masks<Scalar,PacketType>::run();
   }
 };
 
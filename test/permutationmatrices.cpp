@@ -162,6 +162,46 @@ void bug890()
   VERIFY_IS_APPROX(v1, (P.inverse() * rhs).eval());
 }
 
+// Large enough to be split among threads, along the rows when there are less columns than threads.
+template<typename MatrixType>
+void permutation_large()
+{
+  typedef PermutationMatrix<Dynamic> Perm;
+  typedef Matrix<int, Dynamic, 1> IndexVector;
+  const Index rows = internal::random<Index>(40000, 80000);
+  const Index cols = internal::random<Index>(1, 4);
+
+  MatrixType m_original = MatrixType::Random(rows, cols);
+  IndexVector lv;
+  randomPermutationVector(lv, rows);
+  Perm lp(lv);
+
+  MatrixType m_permuted = lp * m_original;
+  MatrixType m_expected(rows, cols);
+  for(Index i = 0; i < rows; ++i)
+    m_expected.row(lv(i)) = m_original.row(i);
+  VERIFY_IS_EQUAL(m_permuted, m_expected);
+
+  m_permuted = m_original;
+  m_permuted = lp * m_permuted;
+  VERIFY_IS_EQUAL(m_permuted, m_expected);
+
+  m_permuted = lp.inverse() * m_expected;
+  VERIFY_IS_EQUAL(m_permuted, m_original);
+
+  m_permuted = m_expected;
+  m_permuted = lp.inverse() * m_permuted;
+  VERIFY_IS_EQUAL(m_permuted, m_original);
+
+  // the columns of the transposed matrices are permuted the same way
+  typedef Matrix<typename MatrixType::Scalar, Dynamic, Dynamic, MatrixType::IsRowMajor ? ColMajor : RowMajor> TransposeType;
+  TransposeType t_permuted = m_original.transpose();
+  t_permuted = t_permuted * lp.transpose();
+  VERIFY_IS_EQUAL(t_permuted, m_expected.transpose());
+
+  VERIFY_IS_EQUAL((lp * m_original.col(0)).eval(), m_expected.col(0));
+}
+
 EIGEN_DECLARE_TEST(permutationmatrices)
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -174,4 +214,6 @@ EIGEN_DECLARE_TEST(permutationmatrices)
     CALL_SUBTEST_7( permutationmatrices(MatrixXcf(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
   }
   CALL_SUBTEST_5( bug890<double>() );
+  CALL_SUBTEST_5( permutation_large<MatrixXd>() );
+  CALL_SUBTEST_6( (permutation_large<Matrix<double,Dynamic,Dynamic,RowMajor> >()) );
 }
@@ -98,6 +98,101 @@ void bug_1622() {
   VERIFY_IS_APPROX(K1,K2);
 }
 
+// The 4M and 3M products of complex matrices, computed by the real product kernel.
+template<typename RealScalar>
+void product_large_complex_planes()
+{
+  typedef std::complex<RealScalar> Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> Mat;
+  typedef Matrix<Scalar,Dynamic,Dynamic,RowMajor> RowMat;
+  int rows = internal::random<int>(20,200), cols = internal::random<int>(20,200), depth = internal::random<int>(20,300);
+  Mat a = Mat::Random(rows,depth), b = Mat::Random(depth,cols);
+  Mat at = Mat::Random(depth,rows);
+  RowMat ra = a, rb = b;
+  Scalar alpha = internal::random<Scalar>();
+  Mat ref = a.lazyProduct(b);
+  Mat ref_adj = at.adjoint().lazyProduct(b.conjugate());
+
+  const ComplexProductAlgorithm algorithms[] = { ComplexProduct4M, ComplexProduct3M };
+  for(int k = 0; k < 2; ++k)
+  {
+    setComplexProductAlgorithm(algorithms[k]);
+    VERIFY(complexProductAlgorithm()==algorithms[k]);
+
+    Mat c(rows,cols);
+    c.noalias() = a*b;
+    VERIFY_IS_APPROX(c, ref);
+    RowMat r(rows,cols);
+    r.noalias() = ra*rb;
+    VERIFY_IS_APPROX(r, ref);
+    c.noalias() = ra*b;
+    VERIFY_IS_APPROX(c, ref);
+
+    c = ref;
+    c.noalias() += alpha * at.adjoint() * b.conjugate();
+    VERIFY_IS_APPROX(c, ref + alpha*ref_adj);
+    r.noalias() -= (at.adjoint()*alpha) * rb.conjugate();
+    VERIFY_IS_APPROX(r, ref - alpha*ref_adj);
+
+    Mat big = Mat::Zero(rows+3,cols+2);
+    big.block(2,1,rows,cols).noalias() = a*b;
+    VERIFY_IS_APPROX(big.block(2,1,rows,cols), ref);
+    VERIFY_IS_MUCH_SMALLER_THAN(big.topRows(2).norm() + big.leftCols(1).norm(), RealScalar(1));
+  }
+  setComplexProductAlgorithm(ComplexProductInterleaved);
+  VERIFY(complexProductAlgorithm()==ComplexProductInterleaved);
+}
+
+#if defined EIGEN_HAS_OPENMP
+// The tiles of a parallel product are scheduled dynamically and share their packed lhs panels,
+// check it for a depth spanning several panels and whatever the number of threads.
+template<int>
+void product_large_parallel()
+{
+  const int nb_threads = nbThreads();
+  for(int threads = 2; threads <= 5; ++threads)
+  {
+    setNbThreads(threads);
+    int rows = internal::random<int>(64,300), cols = internal::random<int>(64,300), depth = internal::random<int>(400,800);
+    MatrixXf a = MatrixXf::Random(rows,depth), b = MatrixXf::Random(depth,cols);
+    MatrixXf ref = a.lazyProduct(b);
+    MatrixXf c(rows,cols);
+    c.noalias() = a*b;
+    VERIFY_IS_APPROX(c, ref);
+    Matrix<float,Dynamic,Dynamic,RowMajor> r(rows,cols);
+    r.noalias() = a*b;
+    VERIFY_IS_APPROX(r, ref);
+    c.noalias() += a*b;
+    VERIFY_IS_APPROX(c, 2*ref);
+  }
+  setNbThreads(nb_threads);
+}
+
+// In deterministic mode, the result of a parallel product does not depend on the number of threads.
+template<int>
+void product_large_deterministic()
+{
+  const int nb_threads = nbThreads();
+  setDeterministicParallelism(true);
+  VERIFY(deterministicParallelism());
+  int rows = internal::random<int>(100,300), cols = internal::random<int>(100,300), depth = internal::random<int>(400,800);
+  MatrixXd a = MatrixXd::Random(rows,depth), b = MatrixXd::Random(depth,cols);
+  MatrixXd ref;
+  for(int threads = 1; threads <= 6; ++threads)
+  {
+    setNbThreads(threads);
+    MatrixXd c(rows,cols);
+    c.noalias() = a*b;
+    if(threads==1)
+      ref = c;
+    VERIFY(c==ref);
+  }
+  VERIFY_IS_APPROX(ref, a.lazyProduct(b));
+  setDeterministicParallelism(false);
+  setNbThreads(nb_threads);
+}
+#endif
+
 EIGEN_DECLARE_TEST(product_large)
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -110,6 +205,8 @@ EIGEN_DECLARE_TEST(product_large)
     CALL_SUBTEST_5( product(Matrix<float,Dynamic,Dynamic,RowMajor>(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
 
     CALL_SUBTEST_1( test_aliasing<float>() );
+    CALL_SUBTEST_4( product_large_complex_planes<float>() );
+    CALL_SUBTEST_4( product_large_complex_planes<double>() );
 
     CALL_SUBTEST_6( bug_1622<1>() );
   }
@@ -122,5 +219,8 @@ EIGEN_DECLARE_TEST(product_large)
   for(int i = 0; i < g_repeat; i++) {
     CALL_SUBTEST_6( product(Matrix<float,Dynamic,Dynamic>(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
   }
+  omp_set_dynamic(0);
+  CALL_SUBTEST_6( product_large_parallel<0>() );
+  CALL_SUBTEST_6( product_large_deterministic<0>() );
 #endif
 }
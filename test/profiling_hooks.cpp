@@ -0,0 +1,169 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// The profiling hooks require C++11, older standards only check that the instrumentation compiles away.
+#if __cplusplus >= 201103L
+#define EIGEN_PROFILING_HOOKS
+#endif
+
+#include "main.h"
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseLU>
+
+template<typename SparseMatrixType>
+void laplacian_1d(SparseMatrixType& a, Index n)
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  std::vector<Triplet<Scalar> > triplets;
+  for(Index i=0; i<n; ++i)
+  {
+    triplets.push_back(Triplet<Scalar>(i, i, 2));
+    if(i>0)   triplets.push_back(Triplet<Scalar>(i, i-1, -1));
+    if(i<n-1) triplets.push_back(Triplet<Scalar>(i, i+1, -1));
+  }
+  a.resize(n, n);
+  a.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+#ifdef EIGEN_PROFILING_HOOKS
+
+struct HookLog
+{
+  std::vector<ProfilingEvent> begins;
+  std::vector<ProfilingEvent> ends;
+};
+
+void log_begin(const ProfilingEvent& event, void* userData) { static_cast<HookLog*>(userData)->begins.push_back(event); }
+void log_end(const ProfilingEvent& event, void* userData) { static_cast<HookLog*>(userData)->ends.push_back(event); }
+
+const ProfilingCollector::Statistics* find_kernel(const std::vector<ProfilingCollector::Statistics>& stats, const std::string& kernel)
+{
+  for(std::size_t i=0; i<stats.size(); ++i)
+    if(stats[i].kernel==kernel)
+      return &stats[i];
+  return 0;
+}
+
+void profiling_hooks_callbacks()
+{
+  const Index n = 64;
+  MatrixXd a = MatrixXd::Random(n,n+1), b = MatrixXd::Random(n+1,n+2), c(n,n+2);
+  VectorXd x = VectorXd::Random(n+1), y(n);
+
+  HookLog log;
+  setProfilingHooks(&log_begin, &log_end, &log);
+  c.noalias() = a*b;
+  clearProfilingHooks();
+  VERIFY_IS_EQUAL(log.begins.size(), 1u);
+  VERIFY_IS_EQUAL(log.ends.size(), 1u);
+  const ProfilingEvent& e = log.ends[0];
+  VERIFY_IS_EQUAL(std::string(e.kernel), std::string("gemm"));
+  VERIFY_IS_EQUAL(e.rows, n);
+  VERIFY_IS_EQUAL(e.cols, n+2);
+  VERIFY_IS_EQUAL(e.depth, n+1);
+  VERIFY_IS_APPROX(e.flops, 2.*n*(n+1)*(n+2));
+  VERIFY(e.seconds>=0);
+  VERIFY_IS_EQUAL(log.begins[0].seconds, 0.);
+  VERIFY_IS_EQUAL(log.begins[0].line, e.line);
+  VERIFY_IS_EQUAL(e.threadId, std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+  // a single hook can be installed
+  log.begins.clear();
+  log.ends.clear();
+  setProfilingHooks(0, &log_end, &log);
+  y.noalias() = a*x;
+  y.noalias() += a.lazyProduct(x);
+  clearProfilingHooks();
+  VERIFY_IS_EQUAL(log.begins.size(), 0u);
+  VERIFY_IS_EQUAL(log.ends.size(), 1u);
+  VERIFY_IS_EQUAL(std::string(log.ends[0].kernel), std::string("gemv"));
+  VERIFY_IS_EQUAL(log.ends[0].rows, n);
+  VERIFY_IS_EQUAL(log.ends[0].cols, 1);
+  VERIFY_IS_EQUAL(log.ends[0].depth, n+1);
+
+  // nothing is reported once the hooks are removed
+  log.ends.clear();
+  c.noalias() = a*b;
+  VERIFY_IS_EQUAL(log.ends.size(), 0u);
+}
+
+void profiling_hooks_collector()
+{
+  const Index n = 50;
+  MatrixXd a = MatrixXd::Random(n,n), b = MatrixXd::Random(n,n), c(n,n);
+  VectorXd x = VectorXd::Random(n), y(n);
+  SparseMatrix<double> s;
+  laplacian_1d(s, 100);
+  VectorXd rhs = VectorXd::Ones(100);
+
+  ProfilingCollector collector;
+  collector.install();
+  for(int k=0; k<3; ++k)
+    c.noalias() = a*b;
+  y.noalias() = a.transpose()*x;
+  SimplicialLLT<SparseMatrix<double> > llt(s);
+  SparseLU<SparseMatrix<double> > lu(s);
+  collector.uninstall();
+  VERIFY_IS_APPROX(s*llt.solve(rhs), rhs);
+  VERIFY_IS_APPROX(s*lu.solve(rhs), rhs);
+
+  std::vector<ProfilingCollector::Statistics> stats = collector.statistics();
+  for(std::size_t i=1; i<stats.size(); ++i)
+    VERIFY(stats[i-1].totalSeconds>=stats[i].totalSeconds);
+
+  const ProfilingCollector::Statistics* gemm = find_kernel(stats, "gemm");
+  VERIFY(gemm!=0);
+  VERIFY_IS_EQUAL(gemm->calls, 3);
+  VERIFY_IS_APPROX(gemm->totalFlops, 3*2.*n*n*n);
+  VERIFY(gemm->minSeconds<=gemm->maxSeconds && gemm->maxSeconds<=gemm->totalSeconds);
+  VERIFY(gemm->site.find("Parallelizer.h:")==0);
+
+  const ProfilingCollector::Statistics* gemv = find_kernel(stats, "gemv");
+  VERIFY(gemv!=0);
+  VERIFY_IS_EQUAL(gemv->calls, 1);
+
+  const ProfilingCollector::Statistics* cholesky = find_kernel(stats, "simplicial_cholesky_factorize");
+  VERIFY(cholesky!=0);
+  VERIFY_IS_EQUAL(cholesky->calls, 1);
+  // each column of the factor of a tridiagonal matrix has one off-diagonal entry, except the last one
+  VERIFY_IS_APPROX(cholesky->totalFlops, 99.);
+
+  VERIFY(find_kernel(stats, "sparse_lu_factorize")!=0);
+
+  std::stringstream report;
+  collector.report(report);
+  VERIFY(report.str().find("gemm (Parallelizer.h:")!=std::string::npos);
+  VERIFY(report.str().find("3 calls")!=std::string::npos);
+
+  collector.reset();
+  VERIFY_IS_EQUAL(collector.statistics().size(), 0u);
+}
+
+#endif // EIGEN_PROFILING_HOOKS
+
+// Without EIGEN_PROFILING_HOOKS the instrumented kernels are unchanged.
+void profiling_hooks_disabled()
+{
+  MatrixXf a = MatrixXf::Random(40,40), b = MatrixXf::Random(40,40);
+  MatrixXf c = a*b;
+  VERIFY_IS_APPROX(c, a.lazyProduct(b));
+  SparseMatrix<float> s;
+  laplacian_1d(s, 30);
+  VectorXf rhs = VectorXf::Ones(30);
+  SimplicialLDLT<SparseMatrix<float> > ldlt(s);
+  VERIFY_IS_APPROX(s*ldlt.solve(rhs), rhs);
+}
+
+EIGEN_DECLARE_TEST(profiling_hooks)
+{
+#ifdef EIGEN_PROFILING_HOOKS
+  CALL_SUBTEST_1( profiling_hooks_callbacks() );
+  CALL_SUBTEST_1( profiling_hooks_collector() );
+#endif
+  CALL_SUBTEST_2( profiling_hooks_disabled() );
+}
@@ -117,12 +117,68 @@ template<typename Scalar> void test_sparseqr_scalar()
   dQ = solver.matrixQ();
   VERIFY_IS_APPROX(Q, dQ);
 }
+template<typename Scalar> void test_multifrontal_qr()
+{
+  typedef SparseMatrix<Scalar,ColMajor> MatrixType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMat;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+  MatrixType A;
+  DenseMat dA;
+  int cols = internal::random<int>(1,150);
+  int rows = internal::random<int>(cols,300);
+  double density = (std::max)(8./(rows*cols), 0.01);
+  A.resize(rows,cols);
+  dA.resize(rows,cols);
+  initSparse<Scalar>(density, dA, A, ForceNonZeroDiag);
+  A.makeCompressed();
+
+  SparseMultifrontalQR<MatrixType, COLAMDOrdering<int> > solver;
+  solver.setRelaxation(internal::random<int>(0,8));
+  solver.compute(A);
+  VERIFY_IS_EQUAL(solver.info(), Success);
+  VERIFY(solver.fronts() >= 1 && solver.fronts() <= cols);
+
+  // A*P = Q*R
+  DenseMat R = solver.matrixR();
+  VERIFY_IS_EQUAL(R.rows(), rows);
+  VERIFY(R.template triangularView<StrictlyLower>().toDenseMatrix().isZero());
+  DenseMat AP = dA * solver.colsPermutation();
+  DenseMat QR = solver.matrixQ() * R;
+  VERIFY_IS_APPROX(QR, AP);
+  VERIFY_IS_APPROX(DenseMat(solver.matrixQ().adjoint() * AP), R);
+
+  // Q is unitary
+  DenseMat Q;
+  Q = solver.matrixQ();
+  VERIFY_IS_APPROX(Q.adjoint() * Q, DenseMat::Identity(rows, rows));
+
+  // Least-squares solution, compared to the dense QR
+  DenseVector b = DenseVector::Random(rows);
+  DenseVector x = solver.solve(b);
+  if (solver.rank() == cols)
+  {
+    DenseVector refX = dA.colPivHouseholderQr().solve(b);
+    VERIFY_IS_APPROX(x, refX);
+  }
+
+  // Reuse the symbolic analysis with new values
+  MatrixType A2 = A;
+  for (Index k = 0; k < A2.nonZeros(); ++k)
+    A2.valuePtr()[k] = internal::random<Scalar>();
+  solver.factorize(A2);
+  DenseMat dA2 = A2;
+  QR = solver.matrixQ() * DenseMat(solver.matrixR());
+  VERIFY_IS_APPROX(QR, DenseMat(dA2 * solver.colsPermutation()));
+}
+
 EIGEN_DECLARE_TEST(sparseqr)
 {
   for(int i=0; i<g_repeat; ++i)
   {
     CALL_SUBTEST_1(test_sparseqr_scalar<double>());
     CALL_SUBTEST_2(test_sparseqr_scalar<std::complex<double> >());
+    CALL_SUBTEST_1(test_multifrontal_qr<double>());
+    CALL_SUBTEST_2(test_multifrontal_qr<std::complex<double> >());
   }
 }
 
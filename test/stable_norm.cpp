@@ -189,6 +189,58 @@ template<typename MatrixType> void stable_norm(const MatrixType& m)
   }
 }
 
+// Long vectors are reduced by packets, in several chunks when OpenMP is enabled.
+template<typename Scalar>
+void stable_norm_long()
+{
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  const Index n = internal::random<Index>(70000,150000);
+  const Scalar big = (std::numeric_limits<Scalar>::max)() * Scalar(1e-4);
+  const Scalar small = (std::numeric_limits<Scalar>::min)() * Scalar(1e4);
+  VectorType v = VectorType::Random(n);
+
+  // coefficients spanning all the ranges, in blocks and increasing, raising the scales of the lanes many times
+  v.segment(n/4, 1000) *= big;
+  v.segment(n/2, 1000) *= small;
+  for(Index i=3*n/4; i<3*n/4+1000; ++i)
+    v(i) = Scalar(i) * Scalar(1e-3);
+  const Scalar s = v.cwiseAbs().maxCoeff();
+  const Scalar ref = s * (v/s).norm();
+  VERIFY_IS_APPROX(v.stableNorm(), ref);
+  VERIFY_IS_APPROX(v.blueNorm(), ref);
+  VERIFY_IS_APPROX(v.segment(3,n-7).stableNorm(), s * (v.segment(3,n-7)/s).norm());
+  VERIFY_IS_APPROX(v.segment(3,n-7).blueNorm(), s * (v.segment(3,n-7)/s).norm());
+  VERIFY_IS_APPROX((Scalar(2)*v).stableNorm(), Scalar(2)*ref);
+  VERIFY_IS_APPROX((Scalar(2)*v).blueNorm(), Scalar(2)*ref);
+
+  // only small coefficients
+  VectorType w = VectorType::Random(n) * small;
+  VERIFY_IS_APPROX(w.stableNorm(), small * (w/small).norm());
+  VERIFY_IS_APPROX(w.blueNorm(), small * (w/small).norm());
+
+  // NaN and infinity far from the first chunk
+  w = v;
+  w(n-3) = std::numeric_limits<Scalar>::infinity();
+  VERIFY(isPlusInf(w.stableNorm()));
+  VERIFY(isPlusInf(w.blueNorm()));
+  w(n/3) = std::numeric_limits<Scalar>::quiet_NaN();
+  VERIFY((numext::isnan)(w.stableNorm()));
+  VERIFY((numext::isnan)(w.blueNorm()));
+
+  // the chunks are merged in order, and do not depend on the number of threads in deterministic mode
+  const int threads = nbThreads();
+  setDeterministicParallelism(true);
+  setNbThreads(1);
+  const Scalar stable1 = v.stableNorm(), blue1 = v.blueNorm();
+  setNbThreads(3);
+  VERIFY_IS_EQUAL(v.stableNorm(), stable1);
+  VERIFY_IS_EQUAL(v.blueNorm(), blue1);
+  setDeterministicParallelism(false);
+  VERIFY_IS_APPROX(v.stableNorm(), ref);
+  VERIFY_IS_APPROX(v.blueNorm(), ref);
+  setNbThreads(threads);
+}
+
 template<typename Scalar>
 void test_hypot()
 {
@@ -236,4 +288,7 @@ EIGEN_DECLARE_TEST(stable_norm)
     CALL_SUBTEST_5( stable_norm(VectorXcd(internal::random<int>(10,2000))) );
     CALL_SUBTEST_6( stable_norm(VectorXcf(internal::random<int>(10,2000))) );
   }
+
+  CALL_SUBTEST_3( stable_norm_long<double>() );
+  CALL_SUBTEST_4( stable_norm_long<float>() );
 }
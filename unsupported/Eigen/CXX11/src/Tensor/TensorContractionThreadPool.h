@@ -348,12 +348,11 @@ struct TensorEvaluator<const TensorContractionOp<Indices, LeftArgType, RightArgT
     void run() {
       // Kick off packing of the first slice.
       signal_switch(0, 1);
-      // Wait for overall completion.
-      // TODO(dvyukov): this wait can lead to deadlock.
-      // If nthreads contractions are concurrently submitted from worker
-      // threads, this wait will block all worker threads and the system will
-      // deadlock.
-      done_.Wait();
+      // Wait for overall completion. A worker thread submitting the
+      // contraction runs other tasks of the pool meanwhile, so that
+      // contractions concurrently submitted from all the worker threads do
+      // not deadlock.
+      device_.wait(&done_);
     }
 
    private:
@@ -824,7 +823,7 @@ struct TensorEvaluator<const TensorContractionOp<Indices, LeftArgType, RightArgT
           [=, &process_block]() { process_block(buf, start, end); });
       start = end;
     }
-    barrier.Wait();
+    this->m_device.wait(&barrier);
 
     // Add other partial results into first partial result.
     for (const auto& buf : block_buffers) {
@@ -52,8 +52,12 @@ class Allocator {
 // Build a thread pool device on top the an existing pool of threads.
 struct ThreadPoolDevice {
   // The ownership of the thread pool remains with the caller.
-  ThreadPoolDevice(ThreadPoolInterface* pool, int num_cores, Allocator* allocator = NULL)
-      : pool_(pool), num_threads_(num_cores), allocator_(allocator) { }
+  // All the tasks generated by the device, including the blocks of
+  // parallelFor, are scheduled with the given priority.
+  ThreadPoolDevice(ThreadPoolInterface* pool, int num_cores, Allocator* allocator = NULL,
+                   ThreadPoolInterface::Priority priority = ThreadPoolInterface::kNormalPriority)
+      : pool_(pool), num_threads_(num_cores), allocator_(allocator), priority_(priority),
+        deterministic_(false) { }
 
   EIGEN_STRONG_INLINE void* allocate(size_t num_bytes) const {
     return allocator_ ? allocator_->allocate(num_bytes)
@@ -103,7 +107,7 @@ struct ThreadPoolDevice {
       }
       // Launch the first block on the main thread.
       ::memcpy(dst_ptr, src_ptr, blocksize);
-      barrier.Wait();
+      wait(&barrier);
     }
 #endif
   }
@@ -140,7 +144,7 @@ struct ThreadPoolDevice {
   EIGEN_STRONG_INLINE Notification* enqueue(Function&& f,
                                             Args&&... args) const {
     Notification* n = new Notification();
-    pool_->Schedule(
+    schedule(
         std::bind(&FunctionWrapperWithNotification<Function, Args...>::run, n,
                   std::move(f), args...));
     return n;
@@ -149,7 +153,7 @@ struct ThreadPoolDevice {
   template <class Function, class... Args>
   EIGEN_STRONG_INLINE void enqueue_with_barrier(Barrier* b, Function&& f,
                                                 Args&&... args) const {
-    pool_->Schedule(
+    schedule(
         std::bind(&FunctionWrapperWithBarrier<Function, Args...>::run, b,
                   std::move(f), args...));
   }
@@ -158,9 +162,26 @@ struct ThreadPoolDevice {
   EIGEN_STRONG_INLINE void enqueueNoNotification(Function&& f,
                                                  Args&&... args) const {
     if (sizeof...(args) > 0) {
-      pool_->Schedule(std::bind(std::move(f), args...));
+      schedule(std::bind(std::move(f), args...));
     } else {
-      pool_->Schedule(std::move(f));
+      schedule(std::move(f));
+    }
+  }
+
+  // Waits until barrier has been notified. When called from a thread of the
+  // pool, for instance by an expression evaluated inside a task of the same
+  // pool, the thread runs pending tasks of the pool instead of blocking: it
+  // may be running the very tasks it waits for, and nested parallel
+  // evaluations can neither deadlock nor leave the worker idle.
+  void wait(Barrier* barrier) const {
+    if (currentThreadId() < 0) {
+      barrier->Wait();
+      return;
+    }
+    while (!barrier->Done()) {
+      if (!pool_->RunPendingTask()) {
+        std::this_thread::yield();
+      }
     }
   }
 
@@ -249,7 +270,7 @@ struct ThreadPoolDevice {
       while (lastIdx - firstIdx > block_size) {
         // Split into halves and schedule the second half on a different thread.
         const Index midIdx = firstIdx + divup((lastIdx - firstIdx) / 2, block_size) * block_size;
-        pool_->Schedule([=, &handleRange]() { handleRange(midIdx, lastIdx); });
+        schedule([=, &handleRange]() { handleRange(midIdx, lastIdx); });
         lastIdx = midIdx;
       }
       // Single block or less, execute directly.
@@ -263,9 +284,9 @@ struct ThreadPoolDevice {
     } else {
       // Execute the root in the thread pool to avoid running work on more than
       // numThreads() threads.
-      pool_->Schedule([=, &handleRange]() { handleRange(0, n); });
+      schedule([=, &handleRange]() { handleRange(0, n); });
     }
-    barrier.Wait();
+    wait(&barrier);
   }
 
   // Convenience wrapper for parallelFor that does not align blocks.
@@ -280,10 +301,29 @@ struct ThreadPoolDevice {
   // Allocator accessor.
   Allocator* allocator() const { return allocator_; }
 
+  // Priority of the tasks scheduled by the device.
+  ThreadPoolInterface::Priority priority() const { return priority_; }
+
+  // In deterministic mode, the algorithms whose result depends on how the
+  // work is partitioned, like full reductions, split it independently of the
+  // number of threads: their results are then bitwise reproducible.
+  void setDeterministic(bool deterministic) { deterministic_ = deterministic; }
+  bool deterministic() const { return deterministic_; }
+
  private:
+  EIGEN_STRONG_INLINE void schedule(std::function<void()> fn) const {
+    if (priority_ == ThreadPoolInterface::kNormalPriority) {
+      pool_->Schedule(std::move(fn));
+    } else {
+      pool_->ScheduleWithPriority(std::move(fn), priority_);
+    }
+  }
+
   ThreadPoolInterface* pool_;
   int num_threads_;
   Allocator* allocator_;
+  ThreadPoolInterface::Priority priority_;
+  bool deterministic_;
 };
 
 
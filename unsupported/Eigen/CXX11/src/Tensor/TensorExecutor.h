@@ -45,6 +45,7 @@ class TensorExecutor {
     const bool needs_assign = evaluator.evalSubExprsIfNeeded(NULL);
     if (needs_assign) {
       const StorageIndex size = array_prod(evaluator.dimensions());
+      EIGEN_PROFILE_KERNEL("tensor_executor", size, 1, 1, 0);
       for (StorageIndex i = 0; i < size; ++i) {
         evaluator.evalScalar(i);
       }
@@ -69,6 +70,7 @@ class TensorExecutor<Expression, DefaultDevice, /*Vectorizable*/ true,
     const bool needs_assign = evaluator.evalSubExprsIfNeeded(NULL);
     if (needs_assign) {
       const StorageIndex size = array_prod(evaluator.dimensions());
+      EIGEN_PROFILE_KERNEL("tensor_executor", size, 1, 1, 0);
       const int PacketSize = unpacket_traits<typename TensorEvaluator<
           Expression, DefaultDevice>::PacketReturnType>::size;
 
@@ -128,6 +130,7 @@ class TensorExecutor<Expression, DefaultDevice, Vectorizable,
                                /*Tileable*/ false>::run(expr, device);
       return;
     }
+    EIGEN_PROFILE_KERNEL("tensor_executor", total_size, 1, 1, 0);
 
     const bool needs_assign = evaluator.evalSubExprsIfNeeded(NULL);
     if (needs_assign) {
@@ -232,6 +235,7 @@ class TensorExecutor<Expression, ThreadPoolDevice, Vectorizable, Tileable> {
     const bool needs_assign = evaluator.evalSubExprsIfNeeded(NULL);
     if (needs_assign) {
       const StorageIndex size = array_prod(evaluator.dimensions());
+      EIGEN_PROFILE_KERNEL("tensor_executor", size, 1, 1, 0);
       device.parallelFor(size, evaluator.costPerCoeff(Vectorizable),
                          EvalRange::alignBlockSize,
                          [&evaluator](StorageIndex firstIdx, StorageIndex lastIdx) {
@@ -267,6 +271,7 @@ class TensorExecutor<Expression, ThreadPoolDevice, Vectorizable, /*Tileable*/ tr
       evaluator.cleanup();
       return;
     }
+    EIGEN_PROFILE_KERNEL("tensor_executor", total_size, 1, 1, 0);
 
     const bool needs_assign = evaluator.evalSubExprsIfNeeded(NULL);
     if (needs_assign) {
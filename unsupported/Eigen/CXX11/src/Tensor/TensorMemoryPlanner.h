@@ -0,0 +1,297 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#if defined(EIGEN_USE_THREADS) && !defined(EIGEN_CXX11_TENSOR_TENSOR_MEMORY_PLANNER_H)
+#define EIGEN_CXX11_TENSOR_TENSOR_MEMORY_PLANNER_H
+
+namespace Eigen {
+
+/** \class TensorMemoryPlanner
+  * \ingroup CXX11_Tensor_Module
+  *
+  * \brief Allocator serving the temporary buffers of tensor evaluations from a single preallocated arena.
+  *
+  * The evaluation of an expression allocates temporary buffers through its device: forced evaluations,
+  * reductions and contractions results, packed blocks of the contractions... A TensorMemoryPlanner installed
+  * as the allocator of a ThreadPoolDevice records the sizes and lifetimes of these buffers during a first
+  * evaluation, and then assigns them offsets into a single arena, the buffers whose lifetimes overlap never
+  * sharing memory. Once the caller provides the arena, the following evaluations of the same expression do
+  * not allocate any memory.
+  *
+  * \code
+  * TensorMemoryPlanner planner;
+  * Eigen::ThreadPoolDevice device(&pool, num_threads, &planner);
+  * planner.startPlanning();
+  * result.device(device) = expr;   // records the temporaries, allocated on the heap
+  * planner.finishPlanning();
+  * void* arena = internal::aligned_malloc(planner.arenaSize());
+  * planner.setArena(arena);
+  * result.device(device) = expr;   // no allocation
+  * \endcode
+  *
+  * The evaluations are expected to be launched from the thread calling startPlanning() and setArena(), the
+  * owner thread. Its allocations happen in the same order at each evaluation and are timed by a clock counting
+  * its allocations and deallocations. The buffers allocated by the worker threads of the pool, e.g., the packed
+  * blocks of a contraction sharded over the inner dimension, come in an arbitrary order and may run late: they
+  * are considered alive from the last event of the owner thread before their allocation to the first
+  * deallocation of the owner thread after their own, which normally follows the wait for their task.
+  *
+  * A request which cannot be served by a free planned buffer of the same size, e.g., because the expression
+  * or its sizes changed, falls back to the heap and is counted by heapAllocations(). The planner can be used
+  * from several threads at once.
+  */
+class TensorMemoryPlanner : public Allocator {
+ public:
+  // A temporary buffer recorded while planning. Its lifetime spans the events
+  // [first_use, last_use] of the owner thread, an event being an allocation
+  // or a deallocation.
+  struct Buffer {
+    size_t size;
+    size_t offset;
+    Index first_use;
+    Index last_use;
+  };
+
+  TensorMemoryPlanner()
+      : planning_(false), arena_(NULL), arena_size_(0), events_(0),
+        clock_(0), heap_allocations_(0) {}
+
+  ~TensorMemoryPlanner() EIGEN_OVERRIDE {}
+
+  // Starts recording the temporary buffers, forgetting the previous plan and
+  // arena, and makes the calling thread the owner thread. Until
+  // finishPlanning() is called, the buffers are allocated on the heap.
+  void startPlanning() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    eigen_assert(live_.empty() && "startPlanning() called while buffers of the arena are in use");
+    planning_ = true;
+    owner_ = std::this_thread::get_id();
+    arena_ = NULL;
+    arena_size_ = 0;
+    events_ = 0;
+    clock_ = 0;
+    heap_allocations_ = 0;
+    buffers_.clear();
+    conflicts_.clear();
+    in_use_.clear();
+    pending_.clear();
+  }
+
+  // Stops recording and computes the offsets of the buffers in the arena.
+  void finishPlanning() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    planning_ = false;
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+      // buffers still alive are released at the end of the evaluation
+      if (buffers_[i].last_use < 0) buffers_[i].last_use = events_ + 1;
+    }
+    pending_.clear();
+    assignOffsets();
+    in_use_.assign(buffers_.size(), false);
+    // the buffers allocated while planning are on the heap
+    live_.clear();
+  }
+
+  // Size in bytes of the arena required by the plan.
+  size_t arenaSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return arena_size_;
+  }
+
+  // The buffers recorded by the last planning, with their offsets.
+  std::vector<Buffer> buffers() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return buffers_;
+  }
+
+  // Serves the planned buffers from arena, which must hold at least
+  // arenaSize() bytes aligned on EIGEN_MAX_ALIGN_BYTES, and outlive the
+  // evaluations using it. The calling thread becomes the owner thread.
+  // Passing NULL reverts to heap allocations.
+  void setArena(void* arena) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    eigen_assert(!planning_ && "setArena() called while planning");
+    eigen_assert(live_.empty() && "setArena() called while buffers of the arena are in use");
+    owner_ = std::this_thread::get_id();
+    arena_ = static_cast<char*>(arena);
+    clock_ = 0;
+  }
+
+  // Number of buffers allocated on the heap since the last call to
+  // startPlanning(), planning excluded.
+  Index heapAllocations() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return heap_allocations_;
+  }
+
+  void* allocate(size_t num_bytes) const EIGEN_OVERRIDE {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const bool owner = std::this_thread::get_id() == owner_;
+    if (planning_) {
+      void* ptr = internal::aligned_malloc(num_bytes);
+      if (owner) ++events_;
+      Buffer buffer = { num_bytes, 0, events_, -1 };
+      live_[ptr] = static_cast<Index>(buffers_.size());
+      buffers_.push_back(buffer);
+      return ptr;
+    }
+    if (arena_ != NULL && !buffers_.empty()) {
+      if (owner) tick();
+      // The owner thread gets the buffer planned at the current time, a
+      // worker the free buffer of the same size planned last before it.
+      // Failing that, any free buffer of the same size will do.
+      Index match = -1;
+      Index fallback = -1;
+      for (size_t i = 0; i < buffers_.size(); ++i) {
+        const Buffer& b = buffers_[i];
+        if (b.size != num_bytes || !available(i)) continue;
+        if (owner ? b.first_use == clock_
+                  : b.first_use <= clock_ && (match < 0 || b.first_use > buffers_[match].first_use)) {
+          match = static_cast<Index>(i);
+        }
+        if (fallback < 0) fallback = static_cast<Index>(i);
+      }
+      if (match < 0) match = fallback;
+      if (match >= 0) {
+        in_use_[match] = true;
+        void* ptr = arena_ + buffers_[match].offset;
+        live_[ptr] = match;
+        return ptr;
+      }
+    }
+    ++heap_allocations_;
+    return internal::aligned_malloc(num_bytes);
+  }
+
+  void deallocate(void* buffer) const EIGEN_OVERRIDE {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const bool owner = std::this_thread::get_id() == owner_;
+    std::map<void*, Index>::iterator it = live_.find(buffer);
+    if (it != live_.end()) {
+      const Index i = it->second;
+      live_.erase(it);
+      if (!planning_) {
+        // a buffer of the arena
+        in_use_[i] = false;
+        if (owner) tick();
+        return;
+      }
+      if (owner) {
+        buffers_[i].last_use = ++events_;
+        for (size_t k = 0; k < pending_.size(); ++k) buffers_[pending_[k]].last_use = events_;
+        pending_.clear();
+      } else {
+        // ends with the next deallocation of the owner thread
+        pending_.push_back(i);
+      }
+    } else if (!planning_ && arena_ != NULL && owner && !buffers_.empty()) {
+      tick();
+    }
+    internal::aligned_free(buffer);
+  }
+
+ private:
+  enum { Alignment = EIGEN_MAX_ALIGN_BYTES > 16 ? EIGEN_MAX_ALIGN_BYTES : 16 };
+
+  static size_t alignedSize(size_t size) {
+    return divup<size_t>(size, Alignment) * Alignment;
+  }
+
+  // Advances the replay clock by one event of the owner thread, wrapping
+  // around at the end of each evaluation.
+  void tick() const {
+    clock_ = clock_ % numext::maxi<Index>(events_, 1) + 1;
+  }
+
+  static bool overlap(Index first1, Index last1, Index first2, Index last2) {
+    return first1 <= last2 && first2 <= last1;
+  }
+
+  // Whether the planned buffer i and all the buffers sharing memory with it
+  // are free.
+  bool available(size_t i) const {
+    if (in_use_[i]) return false;
+    for (size_t k = 0; k < conflicts_[i].size(); ++k) {
+      if (in_use_[conflicts_[i][k]]) return false;
+    }
+    return true;
+  }
+
+  // Greedy by size: the largest buffers are placed first, each one at the
+  // lowest offset where it does not overlap a placed buffer whose lifetime
+  // overlaps its own.
+  void assignOffsets() {
+    const Index n = static_cast<Index>(buffers_.size());
+    std::vector<Index> order(n);
+    for (Index i = 0; i < n; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), LargerBuffer(buffers_));
+
+    arena_size_ = 0;
+    std::vector<Index> placed;
+    for (Index k = 0; k < n; ++k) {
+      Buffer& b = buffers_[order[k]];
+      const size_t size = alignedSize(b.size);
+      size_t offset = 0;
+      for (bool moved = true; moved;) {
+        moved = false;
+        for (size_t p = 0; p < placed.size(); ++p) {
+          const Buffer& q = buffers_[placed[p]];
+          if (overlap(b.first_use, b.last_use, q.first_use, q.last_use) &&
+              offset < q.offset + alignedSize(q.size) && q.offset < offset + size) {
+            offset = q.offset + alignedSize(q.size);
+            moved = true;
+          }
+        }
+      }
+      b.offset = offset;
+      arena_size_ = numext::maxi(arena_size_, offset + size);
+      placed.push_back(order[k]);
+    }
+
+    // buffers sharing memory, which cannot be in use at the same time
+    conflicts_.assign(n, std::vector<Index>());
+    for (Index i = 0; i < n; ++i) {
+      for (Index j = i + 1; j < n; ++j) {
+        const Buffer& a = buffers_[i];
+        const Buffer& b = buffers_[j];
+        if (a.offset < b.offset + alignedSize(b.size) && b.offset < a.offset + alignedSize(a.size)) {
+          conflicts_[i].push_back(j);
+          conflicts_[j].push_back(i);
+        }
+      }
+    }
+  }
+
+  struct LargerBuffer {
+    explicit LargerBuffer(const std::vector<Buffer>& buffers) : buffers_(buffers) {}
+    bool operator()(Index i, Index j) const { return buffers_[i].size > buffers_[j].size; }
+    const std::vector<Buffer>& buffers_;
+  };
+
+  mutable std::mutex mutex_;
+  bool planning_;
+  char* arena_;
+  size_t arena_size_;
+  std::thread::id owner_;
+  // events of the owner thread while planning, and their replay
+  mutable Index events_;
+  mutable Index clock_;
+  mutable Index heap_allocations_;
+  mutable std::vector<Buffer> buffers_;
+  std::vector<std::vector<Index> > conflicts_;
+  mutable std::vector<bool> in_use_;
+  // buffers released by the workers while planning, whose lifetime ends
+  // with the next deallocation of the owner thread
+  mutable std::vector<Index> pending_;
+  // buffers currently allocated, with their index in buffers_
+  mutable std::map<void*, Index> live_;
+};
+
+}  // end namespace Eigen
+
+#endif  // EIGEN_CXX11_TENSOR_TENSOR_MEMORY_PLANNER_H
@@ -339,6 +339,10 @@ struct FullReducer<Self, Op, ThreadPoolDevice, Vectorizable> {
         self.m_impl.costPerCoeff(Vectorizable) +
         TensorOpCost(0, 0, internal::functor_traits<Op>::Cost, Vectorizable,
                      PacketSize);
+    if (device.deterministic()) {
+      runDeterministic(self, reducer, device, num_coeffs, cost, output);
+      return;
+    }
     const int num_threads = TensorCostModel<ThreadPoolDevice>::numThreads(
         num_coeffs, cost, device.numThreads());
     if (num_threads == 1) {
@@ -366,13 +370,44 @@ struct FullReducer<Self, Op, ThreadPoolDevice, Vectorizable> {
     } else {
       finalShard = reducer.initialize();
     }
-    barrier.Wait();
+    device.wait(&barrier);
 
     for (Index i = 0; i < numblocks; ++i) {
       reducer.reduce(shards[i], &finalShard);
     }
     *output = reducer.finalize(finalShard);
   }
+
+  // Deterministic mode: the coefficients are split into blocks of a fixed
+  // size, and the partial results of the blocks are combined by a fixed
+  // pairwise tree. Neither depends on the number of threads nor on the order
+  // the blocks are run in.
+  static void runDeterministic(const Self& self, Op& reducer,
+                               const ThreadPoolDevice& device,
+                               typename Self::Index num_coeffs,
+                               const TensorOpCost& cost,
+                               typename Self::CoeffReturnType* output) {
+    typedef typename Self::Index Index;
+    const Index blocksize = 16384;
+    const Index numblocks = divup<Index>(num_coeffs, blocksize);
+    MaxSizeVector<typename Self::CoeffReturnType> shards(numblocks, reducer.initialize());
+    device.parallelFor(numblocks, cost * blocksize,
+                       [&self, &reducer, &shards, num_coeffs, blocksize](Index first, Index last) {
+      Op shard_reducer(reducer);
+      for (Index i = first; i < last; ++i) {
+        const Index firstIndex = i * blocksize;
+        shards[i] = InnerMostDimReducer<Self, Op, Vectorizable>::reduce(
+            self, firstIndex, numext::mini<Index>(blocksize, num_coeffs - firstIndex),
+            shard_reducer);
+      }
+    });
+    for (Index stride = 1; stride < numblocks; stride *= 2) {
+      for (Index i = 0; i + stride < numblocks; i += 2 * stride) {
+        reducer.reduce(shards[i + stride], &shards[i]);
+      }
+    }
+    *output = reducer.finalize(shards[0]);
+  }
 };
 
 #endif
@@ -34,6 +34,10 @@ class Barrier {
     cv_.notify_all();
   }
 
+  // Returns whether Notify has been called the specified number of times,
+  // without blocking.
+  bool Done() const { return (state_.load(std::memory_order_acquire) >> 1) == 0; }
+
   void Wait() {
     unsigned int v = state_.fetch_or(1, std::memory_order_acq_rel);
     if ((v >> 1) == 0) return;
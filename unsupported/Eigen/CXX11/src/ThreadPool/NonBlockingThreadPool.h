@@ -18,6 +18,63 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
   typedef typename Environment::Task Task;
   typedef RunQueue<Task, 1024> Queue;
 
+  // How a worker that runs out of work looks for new tasks before blocking.
+  enum SpinPolicy {
+    // Block right away.
+    kNoSpinning,
+    // Retry a fixed number of times, proportional to 1 / NumThreads().
+    kFixedSpinning,
+    // Spin for about twice the recent mean interval between tasks scheduled
+    // from outside of the pool, and at most kMaxSpinNanoseconds. Pools receiving tasks less often than
+    // that block right away instead of burning CPU.
+    kAdaptiveSpinning
+  };
+
+  static const uint64_t kMaxSpinNanoseconds = 100000;
+
+  // Activity counters of a worker thread, see GetStatistics().
+  struct WorkerStatistics {
+    uint64_t tasks_executed = 0;
+    // Tasks taken from the queue of another thread of the steal partition.
+    uint64_t local_steals = 0;
+    // Tasks taken from the queue of any other thread, once the local steal
+    // and possibly the spinning failed, or right before parking.
+    uint64_t global_steals = 0;
+    // Attempts to find work while spinning.
+    uint64_t spin_iterations = 0;
+    // Number of times the thread blocked waiting for work, and total time
+    // spent blocked.
+    uint64_t parks = 0;
+    double park_seconds = 0;
+    // Largest number of tasks seen in the queue of the thread.
+    unsigned queue_high_water_mark = 0;
+  };
+
+  // Snapshot of the activity of the pool, see GetStatistics().
+  struct Statistics {
+    std::vector<WorkerStatistics> workers;
+    // Tasks executed by the scheduling thread because the target queue was
+    // full.
+    uint64_t tasks_run_inline = 0;
+
+    // Sum of the counters of all workers (the maximum of the high-water
+    // marks).
+    WorkerStatistics Total() const {
+      WorkerStatistics total;
+      for (const WorkerStatistics& w : workers) {
+        total.tasks_executed += w.tasks_executed;
+        total.local_steals += w.local_steals;
+        total.global_steals += w.global_steals;
+        total.spin_iterations += w.spin_iterations;
+        total.parks += w.parks;
+        total.park_seconds += w.park_seconds;
+        total.queue_high_water_mark =
+            numext::maxi(total.queue_high_water_mark, w.queue_high_water_mark);
+      }
+      return total;
+    }
+  };
+
   ThreadPoolTempl(int num_threads, Environment env = Environment())
       : ThreadPoolTempl(num_threads, true, env) {}
 
@@ -25,7 +82,16 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
                   Environment env = Environment())
       : env_(env),
         num_threads_(num_threads),
-        allow_spinning_(allow_spinning),
+        // TODO(dvyukov,rmlarsen): The time spent in NonEmptyQueueIndex() is
+        // proportional to num_threads_ and we assume that new work is
+        // scheduled at a constant rate, so we set spin_count to 5000 /
+        // num_threads_. The constant was picked based on a fair dice roll,
+        // tune it.
+        spin_count_(num_threads > 0 ? 5000 / num_threads : 0),
+        spin_policy_(allow_spinning ? kFixedSpinning : kNoSpinning),
+        quiesced_(false),
+        last_schedule_nanoseconds_(0),
+        mean_schedule_interval_nanoseconds_(kMaxSpinNanoseconds / 2),
         thread_data_(num_threads),
         all_coprimes_(num_threads),
         waiters_(num_threads),
@@ -33,6 +99,9 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
         spinning_(0),
         done_(false),
         cancelled_(false),
+        high_priority_tasks_(0),
+        statistics_enabled_(false),
+        tasks_run_inline_(0),
         ec_(waiters_) {
     waiters_.resize(num_threads_);
     // Calculate coprimes of all numbers [1, num_threads].
@@ -51,6 +120,7 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
     init_barrier_.reset(new Barrier(num_threads_));
 #endif
     thread_data_.resize(num_threads_);
+    statistics_baseline_.workers.resize(num_threads_);
     for (int i = 0; i < num_threads_; i++) {
       SetStealPartition(i, EncodePartition(0, num_threads_));
       thread_data_[i].thread.reset(
@@ -75,7 +145,9 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
       // Since we were cancelled, there might be entries in the queues.
       // Empty them to prevent their destructor from asserting.
       for (size_t i = 0; i < thread_data_.size(); i++) {
-        thread_data_[i].queue.Flush();
+        for (int p = 0; p < kNumPriorities; p++) {
+          thread_data_[i].queues[p].Flush();
+        }
       }
     }
     // Join threads explicitly (by destroying) to avoid destruction order within
@@ -98,40 +170,42 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
   }
 
   void Schedule(std::function<void()> fn) EIGEN_OVERRIDE {
-    ScheduleWithHint(std::move(fn), 0, num_threads_);
+    ScheduleImpl(std::move(fn), 0, num_threads_, kNormalPriority);
   }
 
   void ScheduleWithHint(std::function<void()> fn, int start,
                         int limit) override {
-    Task t = env_.CreateTask(std::move(fn));
+    ScheduleImpl(std::move(fn), start, limit, kNormalPriority);
+  }
+
+  // Each worker has one queue per priority. Idle workers look for high
+  // priority tasks first, in their own queue and then in the queues of the
+  // other workers, but a worker that has run kMaxHighPriorityStreak high
+  // priority tasks in a row runs a normal priority task next, if any, so that
+  // a steady flow of high priority work cannot starve the rest.
+  void ScheduleWithPriority(std::function<void()> fn,
+                            Priority priority) override {
+    ScheduleImpl(std::move(fn), 0, num_threads_, priority);
+  }
+
+  bool RunPendingTask() override {
     PerThread* pt = GetPerThread();
-    if (pt->pool == this) {
-      // Worker thread of this pool, push onto the thread's queue.
-      Queue& q = thread_data_[pt->thread_id].queue;
-      t = q.PushFront(std::move(t));
-    } else {
-      // A free-standing thread (or worker of another pool), push onto a random
-      // queue.
-      eigen_plain_assert(start < limit);
-      eigen_plain_assert(limit <= num_threads_);
-      int num_queues = limit - start;
-      int rnd = Rand(&pt->rand) % num_queues;
-      eigen_plain_assert(start + rnd < limit);
-      Queue& q = thread_data_[start + rnd].queue;
-      t = q.PushBack(std::move(t));
-    }
-    // Note: below we touch this after making w available to worker threads.
-    // Strictly speaking, this can lead to a racy-use-after-free. Consider that
-    // Schedule is called from a thread that is neither main thread nor a worker
-    // thread of this pool. Then, execution of w directly or indirectly
-    // completes overall computations, which in turn leads to destruction of
-    // this. We expect that such scenario is prevented by program, that is,
-    // this is kept alive while any threads can potentially be in Schedule.
+    if (pt->pool != this || cancelled_) return false;
+    ThreadData& td = thread_data_[pt->thread_id];
+    Task t = PopLocal(&td);
     if (!t.f) {
-      ec_.Notify(false);
-    } else {
-      env_.ExecuteTask(t);  // Push failed, execute directly.
+      t = LocalSteal();
+      if (t.f) {
+        if (StatisticsEnabled()) Increment(&td.local_steals);
+      } else {
+        t = GlobalSteal();
+        if (!t.f) return false;
+        if (StatisticsEnabled()) Increment(&td.global_steals);
+      }
     }
+    if (StatisticsEnabled()) Increment(&td.tasks_executed);
+    env_.ExecuteTask(t);
+    return true;
   }
 
   void Cancel() EIGEN_OVERRIDE {
@@ -160,7 +234,122 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
     }
   }
 
+  // Changes how idle workers look for new work, see SpinPolicy. Takes effect
+  // the next time a worker runs out of work.
+  void SetSpinPolicy(SpinPolicy policy) {
+    spin_policy_.store(policy, std::memory_order_relaxed);
+  }
+
+  SpinPolicy GetSpinPolicy() const {
+    return static_cast<SpinPolicy>(
+        spin_policy_.load(std::memory_order_relaxed));
+  }
+
+  // Quiesce() makes idle workers block immediately, whatever the spin policy,
+  // so that an idle pool does not use any CPU. Scheduled tasks still run
+  // normally. Wake() restores the spin policy and unblocks the workers, so
+  // that calling it ahead of a burst of work hides most of the wake-up
+  // latency.
+  void Quiesce() { quiesced_.store(true, std::memory_order_relaxed); }
+
+  void Wake() {
+    quiesced_.store(false, std::memory_order_relaxed);
+    ec_.Notify(true);
+  }
+
+  bool Quiesced() const { return quiesced_.load(std::memory_order_relaxed); }
+
+  // Starts or stops collecting the activity counters returned by
+  // GetStatistics(). Collection is disabled by default; when enabled the
+  // workers update thread-private counters and read the clock around each
+  // park, which does not measurably slow down scheduling.
+  void EnableStatistics(bool enable) {
+    statistics_enabled_.store(enable, std::memory_order_relaxed);
+  }
+
+  bool StatisticsEnabled() const {
+    return statistics_enabled_.load(std::memory_order_relaxed);
+  }
+
+  // Returns the counters accumulated since the construction of the pool or
+  // the last call to ResetStatistics(), while statistics were enabled.
+  // Can be called from any thread, the counters of running workers are
+  // read without synchronizing with them.
+  Statistics GetStatistics() const {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    Statistics stats = ReadStatistics();
+    for (int i = 0; i < num_threads_; i++) {
+      WorkerStatistics& w = stats.workers[i];
+      const WorkerStatistics& base = statistics_baseline_.workers[i];
+      w.tasks_executed -= base.tasks_executed;
+      w.local_steals -= base.local_steals;
+      w.global_steals -= base.global_steals;
+      w.spin_iterations -= base.spin_iterations;
+      w.parks -= base.parks;
+      w.park_seconds -= base.park_seconds;
+    }
+    stats.tasks_run_inline -= statistics_baseline_.tasks_run_inline;
+    return stats;
+  }
+
+  // Restarts the counters from zero.
+  void ResetStatistics() {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    // The counters are only written by their worker, so that they are never
+    // reset: the current values are recorded as the new origin instead.
+    statistics_baseline_ = ReadStatistics();
+    for (int i = 0; i < num_threads_; i++) {
+      thread_data_[i].queue_high_water_mark.store(0, std::memory_order_relaxed);
+    }
+  }
+
  private:
+  void ScheduleImpl(std::function<void()> fn, int start, int limit,
+                    Priority priority) {
+    Task t = env_.CreateTask(std::move(fn));
+    PerThread* pt = GetPerThread();
+    int target;
+    Queue* q;
+    if (pt->pool == this) {
+      // Worker thread of this pool, push onto the thread's queue.
+      target = pt->thread_id;
+      q = &thread_data_[target].queues[priority];
+      t = q->PushFront(std::move(t));
+    } else {
+      // A free-standing thread (or worker of another pool), push onto a random
+      // queue.
+      eigen_plain_assert(start < limit);
+      eigen_plain_assert(limit <= num_threads_);
+      if (GetSpinPolicy() == kAdaptiveSpinning) RecordScheduleTime();
+      int num_queues = limit - start;
+      int rnd = Rand(&pt->rand) % num_queues;
+      eigen_plain_assert(start + rnd < limit);
+      target = start + rnd;
+      q = &thread_data_[target].queues[priority];
+      t = q->PushBack(std::move(t));
+    }
+    if (priority == kHighPriority && !t.f) high_priority_tasks_++;
+    if (StatisticsEnabled()) {
+      if (t.f) {
+        tasks_run_inline_++;
+      } else {
+        UpdateHighWaterMark(&thread_data_[target], q->Size());
+      }
+    }
+    // Note: below we touch this after making w available to worker threads.
+    // Strictly speaking, this can lead to a racy-use-after-free. Consider that
+    // Schedule is called from a thread that is neither main thread nor a worker
+    // thread of this pool. Then, execution of w directly or indirectly
+    // completes overall computations, which in turn leads to destruction of
+    // this. We expect that such scenario is prevented by program, that is,
+    // this is kept alive while any threads can potentially be in Schedule.
+    if (!t.f) {
+      ec_.Notify(false);
+    } else {
+      env_.ExecuteTask(t);  // Push failed, execute directly.
+    }
+  }
+
   // Create a single atomic<int> that encodes start and limit information for
   // each thread.
   // We expect num_threads_ < 65536, so we can store them in a single
@@ -168,6 +357,9 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
   // Exposed publicly as static functions so that external callers can reuse
   // this encode/decode logic for maintaining their own thread-safe copies of
   // scheduling and steal domain(s).
+  static const int kNumPriorities = 2;
+  static const int kMaxHighPriorityStreak = 16;
+
   static const int kMaxPartitionBits = 16;
   static const int kMaxThreads = 1 << kMaxPartitionBits;
 
@@ -214,10 +406,12 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
   typedef typename Environment::EnvThread Thread;
 
   struct PerThread {
-    constexpr PerThread() : pool(NULL), rand(0), thread_id(-1) {}
+    constexpr PerThread()
+        : pool(NULL), rand(0), thread_id(-1), high_priority_streak(0) {}
     ThreadPoolTempl* pool;  // Parent pool, or null for normal threads.
     uint64_t rand;          // Random generator state.
     int thread_id;          // Worker thread index in pool.
+    int high_priority_streak;  // High priority tasks run in a row.
 #ifndef EIGEN_THREAD_LOCAL
     // Prevent false sharing.
     char pad_[128];
@@ -225,15 +419,44 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
   };
 
   struct ThreadData {
-    constexpr ThreadData() : thread(), steal_partition(0), queue() {}
+    constexpr ThreadData()
+        : thread(),
+          steal_partition(0),
+          queues(),
+          tasks_executed(0),
+          local_steals(0),
+          global_steals(0),
+          spin_iterations(0),
+          parks(0),
+          park_nanoseconds(0),
+          queue_high_water_mark(0) {}
     std::unique_ptr<Thread> thread;
     std::atomic<unsigned> steal_partition;
-    Queue queue;
+    Queue queues[kNumPriorities];  // Indexed by Priority.
+    // Statistics, only written by the worker thread, except for the high-water
+    // mark that is updated by the threads pushing to the queues.
+    std::atomic<uint64_t> tasks_executed;
+    std::atomic<uint64_t> local_steals;
+    std::atomic<uint64_t> global_steals;
+    std::atomic<uint64_t> spin_iterations;
+    std::atomic<uint64_t> parks;
+    std::atomic<uint64_t> park_nanoseconds;
+    std::atomic<unsigned> queue_high_water_mark;
+  };
+
+  // Bounds of the spinning phase of an idle worker.
+  struct SpinWindow {
+    int iterations;
+    uint64_t deadline_nanoseconds;  // 0 when only iterations are bounded.
   };
 
   Environment env_;
   const int num_threads_;
-  const bool allow_spinning_;
+  const int spin_count_;
+  std::atomic<int> spin_policy_;
+  std::atomic<bool> quiesced_;
+  std::atomic<uint64_t> last_schedule_nanoseconds_;
+  std::atomic<uint64_t> mean_schedule_interval_nanoseconds_;
   MaxSizeVector<ThreadData> thread_data_;
   MaxSizeVector<MaxSizeVector<unsigned>> all_coprimes_;
   MaxSizeVector<EventCount::Waiter> waiters_;
@@ -241,6 +464,14 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
   std::atomic<bool> spinning_;
   std::atomic<bool> done_;
   std::atomic<bool> cancelled_;
+  // Number of queued high priority tasks, which can be transiently off by the
+  // tasks being pushed or popped. Only used to skip looking for high priority
+  // tasks to steal when there are none.
+  std::atomic<int> high_priority_tasks_;
+  std::atomic<bool> statistics_enabled_;
+  std::atomic<uint64_t> tasks_run_inline_;
+  mutable std::mutex statistics_mutex_;  // Protects statistics_baseline_.
+  Statistics statistics_baseline_;
   EventCount ec_;
 #ifndef EIGEN_THREAD_LOCAL
   std::unique_ptr<Barrier> init_barrier_;
@@ -262,14 +493,8 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
     pt->pool = this;
     pt->rand = GlobalThreadIdHash();
     pt->thread_id = thread_id;
-    Queue& q = thread_data_[thread_id].queue;
+    ThreadData& td = thread_data_[thread_id];
     EventCount::Waiter* waiter = &waiters_[thread_id];
-    // TODO(dvyukov,rmlarsen): The time spent in NonEmptyQueueIndex() is
-    // proportional to num_threads_ and we assume that new work is scheduled at
-    // a constant rate, so we set spin_count to 5000 / num_threads_. The
-    // constant was picked based on a fair dice roll, tune it.
-    const int spin_count =
-        allow_spinning_ && num_threads_ > 0 ? 5000 / num_threads_ : 0;
     if (num_threads_ == 1) {
       // For num_threads_ == 1 there is no point in going through the expensive
       // steal loop. Moreover, since NonEmptyQueueIndex() calls PopBack() on the
@@ -278,11 +503,16 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
       // counter-productive for the types of I/O workloads the single thread
       // pools tend to be used for.
       while (!cancelled_) {
-        Task t = q.PopFront();
-        for (int i = 0; i < spin_count && !t.f; i++) {
-          if (!cancelled_.load(std::memory_order_relaxed)) {
-            t = q.PopFront();
+        Task t = PopLocal(&td);
+        SpinWindow window;
+        if (!t.f && BeginSpinning(&window)) {
+          int i = 0;
+          for (; !t.f && KeepSpinning(window, i); i++) {
+            if (!cancelled_.load(std::memory_order_relaxed)) {
+              t = PopLocal(&td);
+            }
           }
+          if (StatisticsEnabled()) Increment(&td.spin_iterations, i);
         }
         if (!t.f) {
           if (!WaitForWork(waiter, &t)) {
@@ -290,20 +520,24 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
           }
         }
         if (t.f) {
+          if (StatisticsEnabled()) Increment(&td.tasks_executed);
           env_.ExecuteTask(t);
         }
       }
     } else {
       while (!cancelled_) {
-        Task t = q.PopFront();
+        Task t = PopLocal(&td);
         if (!t.f) {
           t = LocalSteal();
           if (!t.f) {
             t = GlobalSteal();
             if (!t.f) {
               // Leave one thread spinning. This reduces latency.
-              if (allow_spinning_ && !spinning_ && !spinning_.exchange(true)) {
-                for (int i = 0; i < spin_count && !t.f; i++) {
+              SpinWindow window;
+              if (!spinning_ && BeginSpinning(&window) &&
+                  !spinning_.exchange(true)) {
+                int i = 0;
+                for (; !t.f && KeepSpinning(window, i); i++) {
                   if (!cancelled_.load(std::memory_order_relaxed)) {
                     t = GlobalSteal();
                   } else {
@@ -311,40 +545,88 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
                   }
                 }
                 spinning_ = false;
+                if (StatisticsEnabled()) {
+                  Increment(&td.spin_iterations, i);
+                  if (t.f) Increment(&td.global_steals);
+                }
               }
               if (!t.f) {
                 if (!WaitForWork(waiter, &t)) {
                   return;
                 }
               }
+            } else if (StatisticsEnabled()) {
+              Increment(&td.global_steals);
             }
+          } else if (StatisticsEnabled()) {
+            Increment(&td.local_steals);
           }
         }
         if (t.f) {
+          if (StatisticsEnabled()) Increment(&td.tasks_executed);
           env_.ExecuteTask(t);
         }
       }
     }
   }
 
+  // Returns the k-th priority class the calling worker should look at.
+  static EIGEN_STRONG_INLINE int PriorityToScan(const PerThread* pt, int k) {
+    return pt->high_priority_streak < kMaxHighPriorityStreak
+               ? k
+               : kNumPriorities - 1 - k;
+  }
+
+  // Must be called when the calling worker got a task of the given priority.
+  EIGEN_STRONG_INLINE void OnPop(PerThread* pt, int priority) {
+    if (priority == kHighPriority) {
+      high_priority_tasks_--;
+      pt->high_priority_streak++;
+    } else {
+      pt->high_priority_streak = 0;
+    }
+  }
+
+  // Pops a task from the front of the queues of the worker.
+  Task PopLocal(ThreadData* td) {
+    PerThread* pt = GetPerThread();
+    for (int k = 0; k < kNumPriorities; k++) {
+      const int p = PriorityToScan(pt, k);
+      Task t = td->queues[p].PopFront();
+      if (t.f) {
+        OnPop(pt, p);
+        return t;
+      }
+    }
+    return Task();
+  }
+
   // Steal tries to steal work from other worker threads in the range [start,
   // limit) in best-effort manner.
   Task Steal(unsigned start, unsigned limit) {
     PerThread* pt = GetPerThread();
     const size_t size = limit - start;
     unsigned r = Rand(&pt->rand);
-    unsigned victim = r % size;
     unsigned inc = all_coprimes_[size - 1][r % all_coprimes_[size - 1].size()];
 
-    for (unsigned i = 0; i < size; i++) {
-      eigen_plain_assert(start + victim < limit);
-      Task t = thread_data_[start + victim].queue.PopBack();
-      if (t.f) {
-        return t;
+    for (int k = 0; k < kNumPriorities; k++) {
+      const int p = PriorityToScan(pt, k);
+      if (p == kHighPriority &&
+          high_priority_tasks_.load(std::memory_order_relaxed) <= 0) {
+        continue;
       }
-      victim += inc;
-      if (victim >= size) {
-        victim -= size;
+      unsigned victim = r % size;
+      for (unsigned i = 0; i < size; i++) {
+        eigen_plain_assert(start + victim < limit);
+        Task t = thread_data_[start + victim].queues[p].PopBack();
+        if (t.f) {
+          OnPop(pt, p);
+          return t;
+        }
+        victim += inc;
+        if (victim >= size) {
+          victim -= size;
+        }
       }
     }
     return Task();
@@ -376,13 +658,22 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
     // blocking.
     ec_.Prewait(waiter);
     // Now do a reliable emptiness check.
-    int victim = NonEmptyQueueIndex();
-    if (victim != -1) {
+    int index = NonEmptyQueueIndex();
+    if (index != -1) {
       ec_.CancelWait(waiter);
       if (cancelled_) {
         return false;
       } else {
-        *t = thread_data_[victim].queue.PopBack();
+        const int victim = index / kNumPriorities;
+        const int priority = index % kNumPriorities;
+        *t = thread_data_[victim].queues[priority].PopBack();
+        if (t->f) {
+          PerThread* pt = GetPerThread();
+          OnPop(pt, priority);
+          if (StatisticsEnabled() && victim != pt->thread_id) {
+            Increment(&thread_data_[pt->thread_id].global_steals);
+          }
+        }
         return true;
       }
     }
@@ -412,11 +703,111 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
       ec_.Notify(true);
       return false;
     }
-    ec_.CommitWait(waiter);
+    if (StatisticsEnabled()) {
+      ThreadData& td = thread_data_[GetPerThread()->thread_id];
+      const auto start = std::chrono::steady_clock::now();
+      ec_.CommitWait(waiter);
+      const auto stop = std::chrono::steady_clock::now();
+      Increment(&td.parks);
+      Increment(&td.park_nanoseconds,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+    } else {
+      ec_.CommitWait(waiter);
+    }
     blocked_--;
     return true;
   }
 
+  static EIGEN_STRONG_INLINE uint64_t NowNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  // Updates the moving average of the intervals between tasks scheduled from
+  // outside of the pool used by kAdaptiveSpinning. Tasks scheduled by the
+  // workers are part of work already running and are not sampled. Concurrent updates may be lost, which only makes the
+  // average slightly less accurate.
+  void RecordScheduleTime() {
+    const uint64_t now = NowNanoseconds();
+    const uint64_t last =
+        last_schedule_nanoseconds_.exchange(now, std::memory_order_relaxed);
+    if (last == 0 || now <= last) return;
+    // Intervals longer than the spinning window all mean "do not spin".
+    const uint64_t interval = numext::mini(now - last, 2 * kMaxSpinNanoseconds);
+    const uint64_t mean =
+        mean_schedule_interval_nanoseconds_.load(std::memory_order_relaxed);
+    mean_schedule_interval_nanoseconds_.store(mean - mean / 8 + interval / 8,
+                                              std::memory_order_relaxed);
+  }
+
+  // Returns whether an idle worker should spin before blocking, and how long.
+  bool BeginSpinning(SpinWindow* window) {
+    if (quiesced_.load(std::memory_order_relaxed)) return false;
+    switch (GetSpinPolicy()) {
+      case kFixedSpinning:
+        window->iterations = spin_count_;
+        window->deadline_nanoseconds = 0;
+        return spin_count_ > 0;
+      case kAdaptiveSpinning: {
+        const uint64_t mean =
+            mean_schedule_interval_nanoseconds_.load(std::memory_order_relaxed);
+        if (mean > kMaxSpinNanoseconds) return false;
+        window->iterations = NumTraits<int>::highest();
+        window->deadline_nanoseconds =
+            NowNanoseconds() + numext::mini(2 * mean, kMaxSpinNanoseconds);
+        return true;
+      }
+      default:
+        return false;
+    }
+  }
+
+  bool KeepSpinning(const SpinWindow& window, int i) {
+    if (i >= window.iterations || quiesced_.load(std::memory_order_relaxed))
+      return false;
+    return window.deadline_nanoseconds == 0 ||
+           NowNanoseconds() < window.deadline_nanoseconds;
+  }
+
+  // Counters written by a single thread do not need an atomic
+  // read-modify-write.
+  static EIGEN_STRONG_INLINE void Increment(std::atomic<uint64_t>* counter,
+                                            uint64_t n = 1) {
+    counter->store(counter->load(std::memory_order_relaxed) + n,
+                   std::memory_order_relaxed);
+  }
+
+  void UpdateHighWaterMark(ThreadData* td, unsigned size) {
+    unsigned mark = td->queue_high_water_mark.load(std::memory_order_relaxed);
+    while (size > mark &&
+           !td->queue_high_water_mark.compare_exchange_weak(
+               mark, size, std::memory_order_relaxed)) {
+    }
+  }
+
+  Statistics ReadStatistics() const {
+    Statistics stats;
+    stats.workers.resize(num_threads_);
+    for (int i = 0; i < num_threads_; i++) {
+      const ThreadData& td = thread_data_[i];
+      WorkerStatistics& w = stats.workers[i];
+      w.tasks_executed = td.tasks_executed.load(std::memory_order_relaxed);
+      w.local_steals = td.local_steals.load(std::memory_order_relaxed);
+      w.global_steals = td.global_steals.load(std::memory_order_relaxed);
+      w.spin_iterations = td.spin_iterations.load(std::memory_order_relaxed);
+      w.parks = td.parks.load(std::memory_order_relaxed);
+      w.park_seconds =
+          1e-9 * double(td.park_nanoseconds.load(std::memory_order_relaxed));
+      w.queue_high_water_mark =
+          td.queue_high_water_mark.load(std::memory_order_relaxed);
+    }
+    stats.tasks_run_inline = tasks_run_inline_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+  // Returns victim * kNumPriorities + priority for a non-empty queue, or -1 if
+  // all the queues are empty.
   int NonEmptyQueueIndex() {
     PerThread* pt = GetPerThread();
     // We intentionally design NonEmptyQueueIndex to steal work from
@@ -427,8 +818,10 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
     unsigned inc = all_coprimes_[size - 1][r % all_coprimes_[size - 1].size()];
     unsigned victim = r % size;
     for (unsigned i = 0; i < size; i++) {
-      if (!thread_data_[victim].queue.Empty()) {
-        return victim;
+      for (int p = 0; p < kNumPriorities; p++) {
+        if (!thread_data_[victim].queues[p].Empty()) {
+          return victim * kNumPriorities + p;
+        }
       }
       victim += inc;
       if (victim >= size) {
@@ -468,6 +861,9 @@ class ThreadPoolTempl : public Eigen::ThreadPoolInterface {
   }
 };
 
+template <typename Environment>
+const uint64_t ThreadPoolTempl<Environment>::kMaxSpinNanoseconds;
+
 typedef ThreadPoolTempl<StlThreadEnvironment> ThreadPool;
 
 }  // namespace Eigen
@@ -16,6 +16,14 @@ namespace Eigen {
 // custom thread pools underneath.
 class ThreadPoolInterface {
  public:
+  // Scheduling classes. Pools supporting priorities run the pending high
+  // priority tasks before the normal priority ones, while making sure that
+  // normal priority tasks still make progress.
+  enum Priority {
+    kHighPriority = 0,
+    kNormalPriority = 1
+  };
+
   // Submits a closure to be run by a thread in the pool.
   virtual void Schedule(std::function<void()> fn) = 0;
 
@@ -28,6 +36,20 @@ class ThreadPoolInterface {
     Schedule(fn);
   }
 
+  // Submits a closure to be run with the given priority.
+  virtual void ScheduleWithPriority(std::function<void()> fn,
+                                    Priority /*priority*/) {
+    // Pools without priorities run all tasks in the same class.
+    Schedule(std::move(fn));
+  }
+
+  // Runs one pending task of the pool on the calling thread, if it is one of
+  // the threads of the pool, and returns whether a task was run. This lets a
+  // worker waiting for other tasks of the pool help with them instead of
+  // blocking, see ThreadPoolDevice. Pools that do not implement it always
+  // return false, and such waits poll until the tasks are done.
+  virtual bool RunPendingTask() { return false; }
+
   // If implemented, stop processing the closures that have been enqueued.
   // Currently running closures may still be processed.
   // If not implemented, does nothing.
@@ -0,0 +1,111 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef KRONECKER_PRODUCT_SOLVER_H
+#define KRONECKER_PRODUCT_SOLVER_H
+
+namespace Eigen {
+
+/*!
+ * \ingroup KroneckerProduct_Module
+ *
+ * \brief Solves linear systems with a Kronecker product of square matrices
+ *
+ * Since \f$ (A \otimes B)^{-1} = A^{-1} \otimes B^{-1} \f$, the system
+ * \f$ (A \otimes B)\,\mathrm{vec}(X) = \mathrm{vec}(C) \f$ is solved as \f$ X = B^{-1} C A^{-T} \f$,
+ * using one decomposition of each factor. The Kronecker product is never formed:
+ * for n x n factors, the decompositions cost \f$ O(n^3) \f$ and each solve \f$ O(n^3) \f$,
+ * instead of \f$ O(n^6) \f$ and \f$ O(n^4) \f$.
+ *
+ * \code
+ * KroneckerProductSolver<LLT<MatrixXd> > solver(A, B);
+ * VectorXd x = solver.solve(c);   // same as kroneckerProduct(A,B).eval().llt().solve(c)
+ * \endcode
+ *
+ * \tparam _DecompositionA  Type of the decomposition of the left factor A, for instance
+ *                          LLT<MatrixXd>, PartialPivLU<MatrixXd> or SimplicialLDLT<SparseMatrix<double> >.
+ *                          It must provide compute(), solve(), rows() and cols().
+ * \tparam _DecompositionB  Type of the decomposition of the right factor B, by default the same as for A.
+ *
+ * \sa kroneckerProduct()
+ */
+template<typename _DecompositionA, typename _DecompositionB = _DecompositionA>
+class KroneckerProductSolver
+{
+  public:
+    typedef _DecompositionA DecompositionA;
+    typedef _DecompositionB DecompositionB;
+    typedef typename DecompositionA::Scalar Scalar;
+    typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+
+    KroneckerProductSolver() : m_isInitialized(false) {}
+
+    /*! \brief Constructor computing the decompositions of \a a and \a b. */
+    template<typename MatrixA, typename MatrixB>
+    KroneckerProductSolver(const EigenBase<MatrixA>& a, const EigenBase<MatrixB>& b)
+      : m_isInitialized(false)
+    {
+      compute(a, b);
+    }
+
+    /*! \brief Computes the decompositions of the factors \a a and \a b of \f$ A \otimes B \f$. */
+    template<typename MatrixA, typename MatrixB>
+    KroneckerProductSolver& compute(const EigenBase<MatrixA>& a, const EigenBase<MatrixB>& b)
+    {
+      eigen_assert(a.rows() == a.cols() && b.rows() == b.cols() && "KroneckerProductSolver requires square factors");
+      m_decA.compute(a.derived());
+      m_decB.compute(b.derived());
+      m_isInitialized = true;
+      return *this;
+    }
+
+    inline Index rows() const { return m_decA.rows() * m_decB.rows(); }
+    inline Index cols() const { return m_decA.cols() * m_decB.cols(); }
+
+    /*! \returns the decomposition of the left factor A */
+    const DecompositionA& decompositionA() const { return m_decA; }
+    /*! \returns the decomposition of the right factor B */
+    const DecompositionB& decompositionB() const { return m_decB; }
+
+    /*!
+     * \returns the solution x of \f$ (A \otimes B) x = c \f$.
+     *
+     * The right factor is applied to all the columns of \a c at once, the left factor
+     * to each column separately.
+     */
+    template<typename Rhs>
+    DenseMatrix solve(const MatrixBase<Rhs>& c) const
+    {
+      eigen_assert(m_isInitialized && "KroneckerProductSolver is not initialized.");
+      eigen_assert(c.rows() == rows() && "KroneckerProductSolver::solve(): invalid number of rows of the right hand side matrix c");
+      const Index na = m_decA.rows(), nb = m_decB.rows();
+
+      // Y = B^{-1} C for the columns of all the right hand sides reshaped to nb x na
+      DenseMatrix y = c;
+      Map<DenseMatrix> ym(y.data(), nb, na * c.cols());
+      ym = m_decB.solve(ym).eval();
+
+      // X = Y A^{-T}, that is X^T = A^{-1} Y^T
+      DenseMatrix xt;
+      for (Index j = 0; j < c.cols(); ++j)
+      {
+        Map<DenseMatrix> yj(y.col(j).data(), nb, na);
+        xt = m_decA.solve(yj.transpose());
+        yj = xt.transpose();
+      }
+      return y;
+    }
+
+  protected:
+    DecompositionA m_decA;
+    DecompositionB m_decB;
+    bool m_isInitialized;
+};
+
+} // end namespace Eigen
+
+#endif // KRONECKER_PRODUCT_SOLVER_H
@@ -14,6 +14,8 @@
 
 namespace Eigen {
 
+template<typename KroneckerType, typename Rhs> class KroneckerProductTimesDense;
+
 /*!
  * \ingroup KroneckerProduct_Module
  *
@@ -61,6 +63,25 @@ class KroneckerProductBase : public ReturnByValue<Derived>
       return m_A.coeff(i / m_A.size()) * m_B.coeff(i % m_A.size());
     }
 
+    /*! \returns the left factor of the Kronecker product */
+    const typename internal::remove_all<typename Lhs::Nested>::type& lhs() const { return m_A; }
+    /*! \returns the right factor of the Kronecker product */
+    const typename internal::remove_all<typename Rhs::Nested>::type& rhs() const { return m_B; }
+
+    /*!
+     * \returns an expression of the product of this Kronecker product with the dense matrix \a x.
+     *
+     * The Kronecker product is never formed. Each column of \a x is reshaped into a matrix
+     * \f$ X \f$ and multiplied using \f$ (A \otimes B)\,\mathrm{vec}(X) = \mathrm{vec}(B X A^T) \f$,
+     * that is with two matrix products. For n x n factors, this costs \f$ O(n^3) \f$ operations
+     * per column instead of \f$ O(n^4) \f$, and no memory beyond a n x n temporary.
+     */
+    template<typename OtherDerived>
+    const KroneckerProductTimesDense<Derived,OtherDerived> operator*(const MatrixBase<OtherDerived>& x) const
+    {
+      return KroneckerProductTimesDense<Derived,OtherDerived>(static_cast<const Derived&>(*this), x.derived());
+    }
+
   protected:
     typename Lhs::Nested m_A;
     typename Rhs::Nested m_B;
@@ -129,6 +150,76 @@ class KroneckerProductSparse : public KroneckerProductBase<KroneckerProductSpars
     template<typename Dest> void evalTo(Dest& dst) const;
 };
 
+/*!
+ * \ingroup KroneckerProduct_Module
+ *
+ * \brief Expression of the product of a Kronecker product with a dense matrix
+ *
+ * This class is the return value of KroneckerProductBase::operator*(). It is evaluated
+ * without forming the Kronecker product.
+ *
+ * \tparam KroneckerType  Type of the Kronecker product, dense or sparse.
+ * \tparam Rhs  Type of the right-hand side, a dense matrix expression.
+ */
+template<typename KroneckerType, typename Rhs>
+class KroneckerProductTimesDense : public ReturnByValue<KroneckerProductTimesDense<KroneckerType,Rhs> >
+{
+  public:
+    typedef typename internal::traits<KroneckerProductTimesDense>::Scalar Scalar;
+
+    KroneckerProductTimesDense(const KroneckerType& kron, const Rhs& x)
+      : m_kron(kron), m_x(x)
+    {
+      eigen_assert(kron.cols() == x.rows() && "invalid matrix product");
+    }
+
+    inline Index rows() const { return m_kron.rows(); }
+    inline Index cols() const { return m_x.cols(); }
+
+    template<typename Dest> void evalTo(Dest& dst) const;
+
+  protected:
+    const KroneckerType m_kron;
+    typename Rhs::Nested m_x;
+};
+
+template<typename KroneckerType, typename Rhs>
+template<typename Dest>
+void KroneckerProductTimesDense<KroneckerType,Rhs>::evalTo(Dest& dst) const
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+  const Index Ar = m_kron.lhs().rows(), Ac = m_kron.lhs().cols(),
+              Br = m_kron.rhs().rows(), Bc = m_kron.rhs().cols();
+  dst.resize(rows(), cols());
+
+  // evaluate the operands if needed
+  typedef typename internal::traits<KroneckerType>::Lhs KronLhs;
+  typedef typename internal::traits<KroneckerType>::Rhs KronRhs;
+  const typename internal::nested_eval<KronLhs,Dynamic>::type a(m_kron.lhs());
+  const typename internal::nested_eval<KronRhs,Dynamic>::type b(m_kron.rhs());
+  const Ref<const DenseMatrix> x(m_x);
+
+  // B X A^T can be computed as (B X) A^T or B (X A^T), pick the cheapest
+  const bool leftFirst = Br*Bc*Ac + Br*Ac*Ar <= Bc*Ac*Ar + Br*Bc*Ar;
+  DenseMatrix tmp, y(Br, Ar);
+  for (Index j=0; j < x.cols(); ++j)
+  {
+    Map<const DenseMatrix> X(x.col(j).data(), Bc, Ac);
+    if (leftFirst)
+    {
+      tmp.noalias() = b * X;
+      y.noalias() = tmp * a.transpose();
+    }
+    else
+    {
+      tmp.noalias() = X * a.transpose();
+      y.noalias() = b * tmp;
+    }
+    dst.col(j) = Map<const DenseVector>(y.data(), y.size());
+  }
+}
+
 template<typename Lhs, typename Rhs>
 template<typename Dest>
 void KroneckerProduct<Lhs,Rhs>::evalTo(Dest& dst) const
@@ -246,6 +337,13 @@ struct traits<KroneckerProductSparse<_Lhs,_Rhs> >
   typedef SparseMatrix<Scalar, 0, StorageIndex> ReturnType;
 };
 
+template<typename KroneckerType, typename Rhs>
+struct traits<KroneckerProductTimesDense<KroneckerType,Rhs> >
+{
+  typedef typename ScalarBinaryOpTraits<typename traits<KroneckerType>::Scalar, typename Rhs::Scalar>::ReturnType Scalar;
+  typedef Matrix<Scalar, Dynamic, Rhs::ColsAtCompileTime, ColMajor, Dynamic, Rhs::MaxColsAtCompileTime> ReturnType;
+};
+
 } // end namespace internal
 
 /*!
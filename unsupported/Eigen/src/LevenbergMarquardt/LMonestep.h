@@ -37,17 +37,14 @@ LevenbergMarquardt<FunctorType>::minimizeOneStep(FVectorType  &x)
       m_nfev += df_ret;
   else m_njev++;
 
-  /* compute the qr factorization of the jacobian. */
+  /* compute the qr factorization of the jacobian, */
+  /* (q transpose)*m_fvec and the norm of the scaled gradient. */
   for (int j = 0; j < x.size(); ++j)
     m_wa2(j) = m_fjac.col(j).blueNorm();
-  QRSolver qrfac(m_fjac);
-  if(qrfac.info() != Success) {
+  if (!factorizeJacobian(UsesNormalEquations())) {
     m_info = NumericalIssue;
     return LevenbergMarquardtSpace::ImproperInputParameters;
   }
-  // Make a copy of the first factor with the associated permutation
-  m_rfactor = qrfac.matrixR();
-  m_permutation = (qrfac.colsPermutation());
 
   /* on the first iteration and if external scaling is not used, scale according */
   /* to the norms of the columns of the initial jacobian. */
@@ -64,19 +61,6 @@ LevenbergMarquardt<FunctorType>::minimizeOneStep(FVectorType  &x)
           m_delta = m_factor;
   }
 
-  /* form (q transpose)*m_fvec and store the first n components in */
-  /* m_qtf. */
-  m_wa4 = m_fvec;
-  m_wa4 = qrfac.matrixQ().adjoint() * m_fvec; 
-  m_qtf = m_wa4.head(n);
-
-  /* compute the norm of the scaled gradient. */
-  m_gnorm = 0.;
-  if (m_fnorm != 0.)
-      for (Index j = 0; j < n; ++j)
-          if (m_wa2[m_permutation.indices()[j]] != 0.)
-              m_gnorm = (std::max)(m_gnorm, abs( m_rfactor.col(j).head(j+1).dot(m_qtf.head(j+1)/m_fnorm) / m_wa2[m_permutation.indices()[j]]));
-
   /* test for convergence of the gradient norm. */
   if (m_gnorm <= m_gtol) {
     m_info = Success;
@@ -89,7 +73,7 @@ LevenbergMarquardt<FunctorType>::minimizeOneStep(FVectorType  &x)
 
   do {
     /* determine the levenberg-marquardt parameter. */
-    internal::lmpar2(qrfac, m_diag, m_qtf, m_delta, m_par, m_wa1);
+    computeDirection(UsesNormalEquations());
 
     /* store the direction p and x + p. calculate the norm of p. */
     m_wa1 = -m_wa1;
@@ -113,8 +97,7 @@ LevenbergMarquardt<FunctorType>::minimizeOneStep(FVectorType  &x)
 
     /* compute the scaled predicted reduction and */
     /* the scaled directional derivative. */
-    m_wa3 = m_rfactor.template triangularView<Upper>() * (m_permutation.inverse() *m_wa1);
-    temp1 = numext::abs2(m_wa3.stableNorm() / m_fnorm);
+    temp1 = numext::abs2(predictedNorm(UsesNormalEquations()) / m_fnorm);
     temp2 = numext::abs2(sqrt(m_par) * pnorm / m_fnorm);
     prered = temp1 + temp2 / Scalar(.5);
     dirder = -(temp1 + temp2);
@@ -196,6 +179,78 @@ LevenbergMarquardt<FunctorType>::minimizeOneStep(FVectorType  &x)
   return LevenbergMarquardtSpace::Running;
 }
 
+template<typename FunctorType>
+bool LevenbergMarquardt<FunctorType>::factorizeJacobian(internal::false_type)
+{
+  using std::abs;
+  m_patternCache.compute(m_solver, m_fjac);
+  if(m_solver.info() != Success)
+    return false;
+  // Make a copy of the first factor with the associated permutation
+  m_rfactor = m_solver.matrixR();
+  m_permutation = (m_solver.colsPermutation());
+
+  /* form (q transpose)*m_fvec and store the first n components in */
+  /* m_qtf. */
+  m_wa4 = m_solver.matrixQ().adjoint() * m_fvec; 
+  m_qtf = m_wa4.head(n);
+
+  /* compute the norm of the scaled gradient. */
+  m_gnorm = 0.;
+  if (m_fnorm != 0.)
+      for (Index j = 0; j < n; ++j)
+          if (m_wa2[m_permutation.indices()[j]] != 0.)
+              m_gnorm = (std::max)(m_gnorm, abs( m_rfactor.col(j).head(j+1).dot(m_qtf.head(j+1)/m_fnorm) / m_wa2[m_permutation.indices()[j]]));
+  return true;
+}
+
+template<typename FunctorType>
+bool LevenbergMarquardt<FunctorType>::factorizeJacobian(internal::true_type)
+{
+  using std::abs;
+  /* form the normal equations. the factorization is done by lmpar */
+  /* since the shifted matrix changes with the parameter. */
+  m_jtj = m_fjac.adjoint() * m_fjac;
+  m_qtf = m_fjac.adjoint() * m_fvec;
+
+  /* compute the norm of the scaled gradient. */
+  m_gnorm = 0.;
+  if (m_fnorm != 0.)
+      for (Index j = 0; j < n; ++j)
+          if (m_wa2[j] != 0.)
+              m_gnorm = (std::max)(m_gnorm, abs(m_qtf[j] / m_fnorm) / m_wa2[j]);
+  return true;
+}
+
+template<typename FunctorType>
+void LevenbergMarquardt<FunctorType>::computeDirection(internal::false_type)
+{
+  internal::lmpar2(m_solver, m_diag, m_qtf, m_delta, m_par, m_wa1);
+}
+
+template<typename FunctorType>
+void LevenbergMarquardt<FunctorType>::computeDirection(internal::true_type)
+{
+  internal::lmpar_normal(m_solver, m_patternCache, m_jtj, m_diag, m_qtf, m_delta, m_par, m_wa1);
+}
+
+template<typename FunctorType>
+typename LevenbergMarquardt<FunctorType>::RealScalar
+LevenbergMarquardt<FunctorType>::predictedNorm(internal::false_type)
+{
+  m_wa3 = m_rfactor.template triangularView<Upper>() * (m_permutation.inverse() *m_wa1);
+  return m_wa3.stableNorm();
+}
+
+template<typename FunctorType>
+typename LevenbergMarquardt<FunctorType>::RealScalar
+LevenbergMarquardt<FunctorType>::predictedNorm(internal::true_type)
+{
+  // |R P^T p| = |J p| since Q is orthogonal
+  m_wa3 = m_fjac * m_wa1;
+  return m_wa3.stableNorm();
+}
+
   
 } // end namespace Eigen
 
@@ -153,6 +153,121 @@ namespace internal {
       par = 0.;
     return;
   }
+
+  /* Same as lmpar2, but working on the normal equations (J^T J + par D^T D) x = J^T f. */
+  /* Each trial value of par requires a new numerical factorization of the shifted */
+  /* matrix, whose symbolic analysis is shared through the pattern cache. */
+  template <typename Solver, typename PatternCache, typename MatrixType, typename VectorType>
+    void lmpar_normal(
+    Solver &solver,
+    PatternCache &cache,
+    const MatrixType &jtj,
+    const VectorType  &diag,
+    const VectorType  &jtf,
+    typename VectorType::Scalar m_delta,
+    typename VectorType::Scalar &par,
+    VectorType  &x)
+
+  {
+    using std::abs;
+    typedef typename VectorType::Scalar Scalar;
+
+    /* Local variables */
+    Index iter;
+    Scalar fp, temp;
+    Scalar parc, parl, paru;
+    Scalar gnorm;
+    Scalar dxnorm = 0;
+
+    /* Function Body */
+    const Scalar dwarf = (std::numeric_limits<Scalar>::min)();
+    const Index n = jtj.cols();
+    eigen_assert(n==diag.size());
+    eigen_assert(n==jtf.size());
+
+    MatrixType a, shift;
+    VectorType wa1, wa2;
+
+    /* compute the gauss-newton direction. if the jacobian is rank */
+    /* deficient, J^T J is singular and the direction is skipped. */
+    iter = 0;
+    parl = 0.;
+    fp = NumTraits<Scalar>::highest();
+    /* the diagonal is always added, even with a zero shift, so that */
+    /* every factorized matrix shares the same sparsity pattern. */
+    shift = VectorType::Zero(n).asDiagonal();
+    a = jtj + shift;
+    cache.compute(solver, a);
+    const bool fullRank = solver.info() == Success;
+    if (fullRank) {
+      x = solver.solve(jtf);
+      wa2 = diag.cwiseProduct(x);
+      dxnorm = wa2.blueNorm();
+      fp = dxnorm - m_delta;
+      if (fp <= Scalar(0.1) * m_delta) {
+        par = 0;
+        return;
+      }
+
+      /* the newton step provides a lower bound, parl, for the zero */
+      /* of the function. */
+      wa1 = diag.cwiseProduct(wa2)/dxnorm;
+      temp = wa1.dot(solver.solve(wa1));
+      parl = fp / m_delta / temp;
+    }
+
+    /* calculate an upper bound, paru, for the zero of the function. */
+    gnorm = jtf.cwiseQuotient(diag).stableNorm();
+    paru = gnorm / m_delta;
+    if (paru == 0.)
+      paru = dwarf / (std::min)(m_delta,Scalar(0.1));
+
+    /* if the input par lies outside of the interval (parl,paru), */
+    /* set par to the closer endpoint. */
+    par = (std::max)(par,parl);
+    par = (std::min)(par,paru);
+    if (par == 0. && fullRank)
+      par = gnorm / dxnorm;
+
+    /* beginning of an iteration. */
+    while (true) {
+      ++iter;
+
+      /* evaluate the function at the current value of par. */
+      if (par == 0.)
+        par = (std::max)(dwarf,Scalar(.001) * paru); /* Computing MAX */
+      shift = (par * diag.cwiseAbs2()).asDiagonal();
+      a = jtj + shift;
+      cache.compute(solver, a);
+      x = solver.solve(jtf);
+
+      wa2 = diag.cwiseProduct(x);
+      dxnorm = wa2.blueNorm();
+      temp = fp;
+      fp = dxnorm - m_delta;
+
+      /* if the function is small enough, accept the current value */
+      /* of par. also test for the exceptional cases where parl */
+      /* is zero or the number of iterations has reached 10. */
+      if (abs(fp) <= Scalar(0.1) * m_delta || (parl == 0. && fp <= temp && temp < 0.) || iter == 10)
+        break;
+
+      /* compute the newton correction. */
+      wa1 = diag.cwiseProduct(wa2)/dxnorm;
+      temp = wa1.dot(solver.solve(wa1));
+      parc = fp / m_delta / temp;
+
+      /* depending on the sign of the function, update parl or paru. */
+      if (fp > 0.)
+        parl = (std::max)(parl,par);
+      if (fp < 0.)
+        paru = (std::min)(paru,par);
+
+      /* compute an improved estimate for par. */
+      par = (std::max)(parl,par+parc);
+    }
+    return;
+  }
 } // end namespace internal
 
 } // end namespace Eigen
@@ -21,6 +21,9 @@
 
 
 namespace Eigen {
+
+template<typename _MatrixType, int _UpLo> class CholmodSupernodalLLT;
+
 namespace LevenbergMarquardtSpace {
     enum Status {
         NotStarted = -2,
@@ -65,6 +68,19 @@ struct DenseFunctor
   // should be defined in derived classes
 };
 
+/** \brief Base class for functors with a sparse jacobian
+  *
+  * By default, the jacobian is factorized with a SparseQR at each iteration. A derived functor
+  * may redefine \c QRSolver to a sparse Cholesky solver (SimplicialLDLT, SimplicialLLT or
+  * CholmodSupernodalLLT), in which case LevenbergMarquardt works on the normal equations
+  * \f$ (J^T J + \lambda D^T D) p = -J^T f \f$ instead. This is much cheaper for large problems
+  * with few unknowns per residual, at the price of squaring the condition number of \f$ J \f$.
+  *
+  * In both cases, the symbolic analysis of the solver is computed once and reused as long as
+  * the sparsity pattern of the jacobian does not change between iterations.
+  *
+  * \sa SparseBlockJacobian
+  */
 template <typename _Scalar, typename _Index>
 struct SparseFunctor
 {
@@ -97,7 +113,64 @@ template <typename QRSolver, typename VectorType>
 void lmpar2(const QRSolver &qr, const VectorType  &diag, const VectorType  &qtb,
 	    typename VectorType::Scalar m_delta, typename VectorType::Scalar &par,
 	    VectorType  &x);
+
+// Tells whether the solver factorizes the normal equations J^T J rather than J itself
+template<typename Solver> struct lm_uses_normal_equations : false_type {};
+template<typename MatrixType, int UpLo, typename Ordering>
+struct lm_uses_normal_equations<SimplicialLLT<MatrixType,UpLo,Ordering> > : true_type {};
+template<typename MatrixType, int UpLo, typename Ordering>
+struct lm_uses_normal_equations<SimplicialLDLT<MatrixType,UpLo,Ordering> > : true_type {};
+template<typename MatrixType, int UpLo>
+struct lm_uses_normal_equations<CholmodSupernodalLLT<MatrixType,UpLo> > : true_type {};
+
+/** \internal Factorizes matrices through a solver, recomputing the symbolic analysis of
+  * sparse matrices only when their sparsity pattern differs from the previous call. */
+template<typename MatrixType, typename StorageKind = typename traits<MatrixType>::StorageKind>
+struct lm_pattern_cache
+{
+  // Dense decompositions have no symbolic step
+  template<typename Solver>
+  void compute(Solver &solver, const MatrixType &mat) { solver.compute(mat); }
+};
+
+template<typename MatrixType>
+struct lm_pattern_cache<MatrixType,Sparse>
+{
+  typedef typename MatrixType::StorageIndex StorageIndex;
+  typedef Matrix<StorageIndex,Dynamic,1> IndexVector;
+
+  lm_pattern_cache() : m_rows(-1) {}
+
+  template<typename Solver>
+  void compute(Solver &solver, const MatrixType &mat)
+  {
+    eigen_assert(mat.isCompressed() && "The jacobian must be in compressed mode");
+    if (!samePattern(mat))
+    {
+      solver.analyzePattern(mat);
+      m_rows = mat.rows();
+      m_outer = IndexVector::Map(mat.outerIndexPtr(), mat.outerSize()+1);
+      m_inner = IndexVector::Map(mat.innerIndexPtr(), mat.nonZeros());
     }
+    solver.factorize(mat);
+  }
+
+  bool samePattern(const MatrixType &mat) const
+  {
+    return m_rows == mat.rows() && m_outer.size() == mat.outerSize()+1 && m_inner.size() == mat.nonZeros()
+        && m_outer == IndexVector::Map(mat.outerIndexPtr(), mat.outerSize()+1)
+        && m_inner == IndexVector::Map(mat.innerIndexPtr(), mat.nonZeros());
+  }
+
+  Index m_rows;
+  IndexVector m_outer, m_inner;
+};
+
+template <typename Solver, typename PatternCache, typename MatrixType, typename VectorType>
+void lmpar_normal(Solver &solver, PatternCache &cache, const MatrixType &jtj, const VectorType &diag,
+                  const VectorType &jtf, typename VectorType::Scalar m_delta,
+                  typename VectorType::Scalar &par, VectorType &x);
+}
 /**
   * \ingroup NonLinearOptimization_Module
   * \brief Performs non linear optimization over a non-linear function,
@@ -223,6 +296,7 @@ class LevenbergMarquardt : internal::no_assignment_operator
     JacobianType& jacobian() {return m_fjac; }
     
     /** \returns a reference to the triangular matrix R from the QR of the jacobian matrix.
+     * This matrix is empty when the normal equations are solved instead.
      * \sa jacobian()
      */
     JacobianType& matrixR() {return m_rfactor; }
@@ -246,10 +320,22 @@ class LevenbergMarquardt : internal::no_assignment_operator
       return m_info;
     }
   private:
+    typedef internal::lm_uses_normal_equations<QRSolver> UsesNormalEquations;
+
+    bool factorizeJacobian(internal::false_type);
+    bool factorizeJacobian(internal::true_type);
+    void computeDirection(internal::false_type);
+    void computeDirection(internal::true_type);
+    RealScalar predictedNorm(internal::false_type);
+    RealScalar predictedNorm(internal::true_type);
+
     JacobianType m_fjac; 
     JacobianType m_rfactor; // The triangular matrix R from the QR of the jacobian matrix m_fjac
+    JacobianType m_jtj; // The matrix J^T J of the normal equations
+    QRSolver m_solver; // Kept across iterations to reuse its symbolic analysis
+    internal::lm_pattern_cache<JacobianType> m_patternCache;
     FunctorType &m_functor;
-    FVectorType m_fvec, m_qtf, m_diag; 
+    FVectorType m_fvec, m_qtf, m_diag; // m_qtf holds J^T fvec when solving the normal equations
     Index n;
     Index m; 
     Index m_nfev;
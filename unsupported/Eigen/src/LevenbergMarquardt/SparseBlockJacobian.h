@@ -0,0 +1,204 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SPARSE_BLOCK_JACOBIAN_H
+#define EIGEN_SPARSE_BLOCK_JACOBIAN_H
+
+namespace Eigen {
+
+/**
+  * \ingroup LevenbergMarquardt_Module
+  * \brief Assembles a sparse jacobian made of dense residual blocks
+  *
+  * Large least-squares problems such as bundle adjustment are naturally split into residual
+  * blocks: a few consecutive rows of the residual vector depending on a few columns of the
+  * parameter vector (typically one camera and one point). This class records the structure of
+  * such blocks once, builds the sparsity pattern of the jacobian from it, and then fills the
+  * jacobian by evaluating every block independently, in parallel when OpenMP is enabled.
+  *
+  * Since the pattern is built once and kept, LevenbergMarquardt reuses the symbolic analysis of
+  * its solver across iterations. Typical usage in the \c df() method of a SparseFunctor:
+  * \code
+  * struct MyFunctor : SparseFunctor<double,int>
+  * {
+  *   SparseBlockJacobian<double,int> blocks; // residual blocks added in the constructor
+  *   struct BlockEval {
+  *     const VectorXd &x;
+  *     BlockEval(const VectorXd &x) : x(x) {}
+  *     int operator()(Index block, MatrixXd &jac) const; // fills the rows x cols dense block
+  *   };
+  *   int df(const VectorXd &x, JacobianType &fjac) { BlockEval eval(x); return blocks.assemble(eval, fjac); }
+  * };
+  * \endcode
+  *
+  * Two residual blocks must not share a coefficient of the jacobian, so that blocks can be
+  * written concurrently.
+  *
+  * \tparam _Scalar the scalar type of the jacobian
+  * \tparam _StorageIndex the index type of the jacobian
+  */
+template<typename _Scalar, typename _StorageIndex = int>
+class SparseBlockJacobian
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef _StorageIndex StorageIndex;
+    typedef SparseMatrix<Scalar,ColMajor,StorageIndex> JacobianType;
+    typedef Matrix<Scalar,Dynamic,Dynamic> BlockType;
+
+    SparseBlockJacobian(Index values, Index inputs)
+      : m_values(values), m_inputs(inputs), m_isFinalized(false)
+    {
+      m_blockOffsets.push_back(0);
+      m_slotOffsets.push_back(0);
+    }
+
+    /** Adds a residual block made of the rows \a firstRow to \a firstRow+rows-1,
+      * depending on the parameters whose indices are given by \a cols.
+      * The k-th column of the dense block passed to assemble() corresponds to column \a cols[k]
+      * of the jacobian.
+      * \returns the index of the new block */
+    Index addResidualBlock(Index firstRow, Index rows, const std::vector<StorageIndex> &cols)
+    {
+      eigen_assert(firstRow >= 0 && rows > 0 && firstRow+rows <= m_values);
+      m_isFinalized = false;
+      m_firstRows.push_back(StorageIndex(firstRow));
+      m_rows.push_back(StorageIndex(rows));
+      for (size_t k = 0; k < cols.size(); ++k)
+      {
+        eigen_assert(cols[k] >= 0 && cols[k] < m_inputs);
+        m_cols.push_back(cols[k]);
+      }
+      m_blockOffsets.push_back(StorageIndex(m_cols.size()));
+      m_slotOffsets.push_back(m_slotOffsets.back() + StorageIndex(rows*cols.size()));
+      return blocks()-1;
+    }
+
+    /** Convenience overload for a block depending on the two parameter ranges
+      * [\a firstCol1, \a firstCol1+cols1) and [\a firstCol2, \a firstCol2+cols2). */
+    Index addResidualBlock(Index firstRow, Index rows, Index firstCol1, Index cols1, Index firstCol2 = 0, Index cols2 = 0)
+    {
+      std::vector<StorageIndex> cols;
+      cols.reserve(cols1+cols2);
+      for (Index k = 0; k < cols1; ++k) cols.push_back(StorageIndex(firstCol1+k));
+      for (Index k = 0; k < cols2; ++k) cols.push_back(StorageIndex(firstCol2+k));
+      return addResidualBlock(firstRow, rows, cols);
+    }
+
+    /** \returns the number of residual blocks */
+    Index blocks() const { return Index(m_firstRows.size()); }
+
+    /** \returns the number of rows of the block \a b */
+    Index blockRows(Index b) const { return m_rows[b]; }
+
+    /** \returns the number of columns of the block \a b */
+    Index blockCols(Index b) const { return m_blockOffsets[b+1] - m_blockOffsets[b]; }
+
+    /** Builds the sparsity pattern of the jacobian and the position of each block
+      * coefficient in its value array. This is done automatically by the first call to assemble(). */
+    void finalize()
+    {
+      typedef Triplet<Scalar,StorageIndex> T;
+      std::vector<T> triplets;
+      triplets.reserve(m_slotOffsets.back());
+      for (Index b = 0; b < blocks(); ++b)
+        for (StorageIndex k = m_blockOffsets[b]; k < m_blockOffsets[b+1]; ++k)
+          for (StorageIndex i = 0; i < m_rows[b]; ++i)
+            triplets.push_back(T(m_firstRows[b]+i, m_cols[k], Scalar(0)));
+      m_pattern.resize(m_values, m_inputs);
+      m_pattern.setFromTriplets(triplets.begin(), triplets.end());
+      m_pattern.makeCompressed();
+      eigen_assert(m_pattern.nonZeros() == Index(triplets.size()) && "Residual blocks must not share coefficients");
+
+      // For each block coefficient, find its position in the compressed storage.
+      // Rows are sorted within each column, so a binary search suffices.
+      m_slots.resize(m_slotOffsets.back());
+      const StorageIndex *outer = m_pattern.outerIndexPtr();
+      const StorageIndex *inner = m_pattern.innerIndexPtr();
+      for (Index b = 0; b < blocks(); ++b)
+      {
+        StorageIndex *slot = &m_slots[m_slotOffsets[b]];
+        for (StorageIndex k = m_blockOffsets[b]; k < m_blockOffsets[b+1]; ++k)
+        {
+          const StorageIndex c = m_cols[k];
+          const StorageIndex *first = std::lower_bound(inner+outer[c], inner+outer[c+1], m_firstRows[b]);
+          for (StorageIndex i = 0; i < m_rows[b]; ++i)
+            *slot++ = StorageIndex(first - inner) + i;
+        }
+      }
+      m_isFinalized = true;
+    }
+
+    /** \returns the sparsity pattern of the jacobian, with zero values */
+    const JacobianType& pattern()
+    {
+      if (!m_isFinalized) finalize();
+      return m_pattern;
+    }
+
+    /** Fills \a fjac by calling \a func(b, block) for every residual block \a b, where \a block
+      * is a dense matrix already resized to blockRows(b) x blockCols(b).
+      * The blocks are evaluated in parallel using Eigen::nbThreads() threads when OpenMP is
+      * enabled, so \a func must be safe to call concurrently.
+      * \returns 0, or -1 if any call of \a func returned a negative value. */
+    template<typename BlockFunctor>
+    int assemble(BlockFunctor &func, JacobianType &fjac)
+    {
+      if (!m_isFinalized) finalize();
+      if (!samePattern(fjac))
+        fjac = m_pattern;
+
+      Scalar *values = fjac.valuePtr();
+      const Index nblocks = blocks();
+      int ret = 0;
+#ifdef EIGEN_HAS_OPENMP
+      #pragma omp parallel num_threads(Eigen::nbThreads())
+#endif
+      {
+        BlockType block;
+#ifdef EIGEN_HAS_OPENMP
+        #pragma omp for schedule(dynamic,16)
+#endif
+        for (Index b = 0; b < nblocks; ++b)
+        {
+          block.resize(blockRows(b), blockCols(b));
+          if (func(b, block) < 0)
+          {
+#ifdef EIGEN_HAS_OPENMP
+            #pragma omp critical
+#endif
+            ret = -1;
+            continue;
+          }
+          const StorageIndex *slot = &m_slots[m_slotOffsets[b]];
+          for (Index j = 0; j < block.cols(); ++j)
+            for (Index i = 0; i < block.rows(); ++i)
+              values[*slot++] = block(i,j);
+        }
+      }
+      return ret;
+    }
+
+  protected:
+    bool samePattern(const JacobianType &fjac) const
+    {
+      return fjac.isCompressed() && fjac.rows() == m_pattern.rows() && fjac.cols() == m_pattern.cols()
+          && fjac.nonZeros() == m_pattern.nonZeros()
+          && std::equal(m_pattern.outerIndexPtr(), m_pattern.outerIndexPtr()+m_pattern.outerSize()+1, fjac.outerIndexPtr());
+    }
+
+    Index m_values, m_inputs;
+    std::vector<StorageIndex> m_firstRows, m_rows; // first row and number of rows of each block
+    std::vector<StorageIndex> m_cols, m_blockOffsets; // columns of each block, concatenated
+    std::vector<StorageIndex> m_slots, m_slotOffsets; // positions of the block coefficients in the value array
+    JacobianType m_pattern;
+    bool m_isFinalized;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_SPARSE_BLOCK_JACOBIAN_H
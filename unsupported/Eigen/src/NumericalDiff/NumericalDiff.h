@@ -20,6 +20,121 @@ enum NumericalDiffMode {
     Central
 };
 
+namespace internal {
+
+struct numdiff_degree_greater
+{
+    numdiff_degree_greater(const std::vector<Index> &degree) : m_degree(degree) {}
+    bool operator()(Index a, Index b) const { return m_degree[a] > m_degree[b]; }
+    const std::vector<Index> &m_degree;
+};
+
+/** \internal Greedy Curtis-Powell-Reid coloring of the columns of a sparsity pattern:
+  * two columns get the same color only if they have no row in common, so that all the
+  * columns of a color can be perturbed at once. Columns are visited by decreasing number
+  * of nonzeros (largest-first ordering), which usually needs close to the maximal row
+  * degree colors. \returns the number of colors. */
+template<typename PatternType>
+Index numdiff_color_columns(const PatternType &pattern, std::vector<Index> &colors)
+{
+    typedef typename PatternType::StorageIndex StorageIndex;
+    typedef SparseMatrix<typename PatternType::Scalar,RowMajor,StorageIndex> RowPatternType;
+    const Index n = pattern.cols();
+    RowPatternType rows(pattern);
+
+    std::vector<Index> order(n);
+    for (Index j = 0; j < n; ++j)
+        order[j] = j;
+    std::vector<Index> degree(n);
+    for (Index j = 0; j < n; ++j)
+        degree[j] = pattern.outerIndexPtr()[j+1] - pattern.outerIndexPtr()[j];
+    std::stable_sort(order.begin(), order.end(), numdiff_degree_greater(degree));
+
+    colors.assign(n, -1);
+    // forbidden[c] == j means color c is already used by a neighbor of column j
+    std::vector<Index> forbidden;
+    Index ncolors = 0;
+    for (Index o = 0; o < n; ++o)
+    {
+        const Index j = order[o];
+        for (typename PatternType::InnerIterator it(pattern, j); it; ++it)
+            for (typename RowPatternType::InnerIterator rit(rows, it.index()); rit; ++rit)
+                if (colors[rit.index()] >= 0)
+                    forbidden[colors[rit.index()]] = j;
+        Index c = 0;
+        while (c < ncolors && forbidden[c] == j)
+            ++c;
+        if (c == ncolors)
+        {
+            ++ncolors;
+            forbidden.push_back(-1);
+        }
+        colors[j] = c;
+    }
+    return ncolors;
+}
+
+// Writes the finite differences of a column restricted to the sparsity pattern
+template<typename JacobianType, typename StorageKind = typename traits<JacobianType>::StorageKind>
+struct numdiff_pattern_assign
+{
+    enum { ParallelColumns = 1 };
+
+    template<typename PatternType>
+    static void init(JacobianType &jac, const PatternType &) { jac.setZero(); }
+
+    template<typename ValueType, typename Scalar>
+    static void column(JacobianType &jac, Index j, const ValueType &val2, const ValueType &val1, Scalar h)
+    {
+        jac.col(j) = (val2-val1)/h;
+    }
+
+    template<typename PatternType, typename ValueType, typename Scalar>
+    static void run(JacobianType &jac, const PatternType &pattern, Index j,
+                    const ValueType &val2, const ValueType &val1, Scalar h)
+    {
+        for (typename PatternType::InnerIterator it(pattern, j); it; ++it)
+            jac(it.index(), j) = (val2[it.index()] - val1[it.index()]) / h;
+    }
+};
+
+template<typename JacobianType>
+struct numdiff_pattern_assign<JacobianType,Sparse>
+{
+    // column() may reallocate the storage, while run() only writes existing values
+    enum { ParallelColumns = 0 };
+
+    // The jacobian gets the same storage as the pattern, so that they share value positions
+    template<typename PatternType>
+    static void init(JacobianType &jac, const PatternType &pattern)
+    {
+        bool same = jac.isCompressed() && jac.rows() == pattern.rows() && jac.cols() == pattern.cols()
+                 && jac.nonZeros() == pattern.nonZeros();
+        for (Index j = 0; same && j <= pattern.cols(); ++j)
+            same = jac.outerIndexPtr()[j] == pattern.outerIndexPtr()[j];
+        if (!same)
+            jac = pattern.template cast<typename JacobianType::Scalar>();
+    }
+
+    template<typename ValueType, typename Scalar>
+    static void column(JacobianType &jac, Index j, const ValueType &val2, const ValueType &val1, Scalar h)
+    {
+        jac.col(j) = ((val2-val1)/h).sparseView();
+    }
+
+    template<typename PatternType, typename ValueType, typename Scalar>
+    static void run(JacobianType &jac, const PatternType &pattern, Index j,
+                    const ValueType &val2, const ValueType &val1, Scalar h)
+    {
+        for (Index k = pattern.outerIndexPtr()[j]; k < pattern.outerIndexPtr()[j+1]; ++k)
+        {
+            const Index i = pattern.innerIndexPtr()[k];
+            jac.valuePtr()[k] = (val2[i] - val1[i]) / h;
+        }
+    }
+};
+
+} // end namespace internal
 
 /**
   * This class allows you to add a method df() to your functor, which will 
@@ -31,6 +146,14 @@ enum NumericalDiffMode {
   * http://en.wikipedia.org/wiki/Numerical_differentiation
   *
   * Currently only "Forward" and "Central" scheme are implemented.
+  *
+  * When the sparsity pattern of the jacobian is known, pass it to setSparsityPattern():
+  * the columns are then grouped by a Curtis-Powell-Reid coloring and all the columns of a
+  * group are perturbed together, which brings the number of function evaluations from
+  * the number of inputs down to about the maximal number of nonzeros per row.
+  *
+  * If the functor can safely be called concurrently, setParallel() distributes the
+  * function evaluations over Eigen::nbThreads() OpenMP threads.
   */
 template<typename _Functor, NumericalDiffMode mode=Forward>
 class NumericalDiff : public _Functor
@@ -41,46 +164,72 @@ public:
     typedef typename Functor::InputType InputType;
     typedef typename Functor::ValueType ValueType;
     typedef typename Functor::JacobianType JacobianType;
+    typedef SparseMatrix<Scalar> PatternType;
 
-    NumericalDiff(Scalar _epsfcn=0.) : Functor(), epsfcn(_epsfcn) {}
-    NumericalDiff(const Functor& f, Scalar _epsfcn=0.) : Functor(f), epsfcn(_epsfcn) {}
+    NumericalDiff(Scalar _epsfcn=0.) : Functor(), epsfcn(_epsfcn), m_ncolors(0), m_parallel(false) {}
+    NumericalDiff(const Functor& f, Scalar _epsfcn=0.) : Functor(f), epsfcn(_epsfcn), m_ncolors(0), m_parallel(false) {}
 
     // forward constructors
     template<typename T0>
-        NumericalDiff(const T0& a0) : Functor(a0), epsfcn(0) {}
+        NumericalDiff(const T0& a0) : Functor(a0), epsfcn(0), m_ncolors(0), m_parallel(false) {}
     template<typename T0, typename T1>
-        NumericalDiff(const T0& a0, const T1& a1) : Functor(a0, a1), epsfcn(0) {}
+        NumericalDiff(const T0& a0, const T1& a1) : Functor(a0, a1), epsfcn(0), m_ncolors(0), m_parallel(false) {}
     template<typename T0, typename T1, typename T2>
-        NumericalDiff(const T0& a0, const T1& a1, const T2& a2) : Functor(a0, a1, a2), epsfcn(0) {}
+        NumericalDiff(const T0& a0, const T1& a1, const T2& a2) : Functor(a0, a1, a2), epsfcn(0), m_ncolors(0), m_parallel(false) {}
 
     enum {
         InputsAtCompileTime = Functor::InputsAtCompileTime,
         ValuesAtCompileTime = Functor::ValuesAtCompileTime
     };
 
+    /** Sets the structure of the jacobian: only the positions of the nonzeros of
+      * \a pattern are used. df() then only computes these entries and sets the others to zero.
+      * Pass an empty matrix to go back to the column-by-column scheme. */
+    template<typename Derived>
+    void setSparsityPattern(const SparseMatrixBase<Derived> &pattern)
+    {
+        m_pattern = pattern.template cast<Scalar>();
+        m_pattern.makeCompressed();
+        m_colors.clear();
+        m_ncolors = m_pattern.nonZeros() ? internal::numdiff_color_columns(m_pattern, m_colors) : 0;
+        m_groupStart.assign(m_ncolors+1, 0);
+        m_groupCols.resize(m_colors.size());
+        for (size_t j = 0; j < m_colors.size(); ++j)
+            ++m_groupStart[m_colors[j]+1];
+        for (Index c = 0; c < m_ncolors; ++c)
+            m_groupStart[c+1] += m_groupStart[c];
+        std::vector<Index> pos(m_groupStart.begin(), m_groupStart.end()-1);
+        for (size_t j = 0; j < m_colors.size(); ++j)
+            m_groupCols[pos[m_colors[j]]++] = Index(j);
+    }
+
+    /** \returns the number of groups of columns perturbed together, 0 if no sparsity pattern is set */
+    Index colors() const { return m_ncolors; }
+
+    /** Enables the evaluation of the functor from several threads at once. */
+    void setParallel(bool parallel) { m_parallel = parallel; }
+
     /**
       * return the number of evaluation of functor
      */
     int df(const InputType& _x, JacobianType &jac) const
     {
         using std::sqrt;
-        using std::abs;
         /* Local variables */
-        Scalar h;
         int nfev=0;
-        const typename InputType::Index n = _x.size();
         const Scalar eps = sqrt(((std::max)(epsfcn,NumTraits<Scalar>::epsilon() )));
-        ValueType val1, val2;
-        InputType x = _x;
-        // TODO : we should do this only if the size is not already known
-        val1.resize(Functor::values());
-        val2.resize(Functor::values());
+        ValueType val0;
+        const bool useGroups = m_ncolors > 0;
+        const Index ngroups = useGroups ? m_ncolors : _x.size();
+        const bool parallel = m_parallel && (useGroups || internal::numdiff_pattern_assign<JacobianType>::ParallelColumns);
 
         // initialization
         switch(mode) {
             case Forward:
                 // compute f(x)
-                Functor::operator()(x, val1); nfev++;
+                // TODO : we should do this only if the size is not already known
+                val0.resize(Functor::values());
+                Functor::operator()(_x, val0); nfev++;
                 break;
             case Central:
                 // do nothing
@@ -88,37 +237,80 @@ public:
             default:
                 eigen_assert(false);
         };
+        if (useGroups)
+        {
+            eigen_assert(m_pattern.rows() == Functor::values() && m_pattern.cols() == _x.size());
+            internal::numdiff_pattern_assign<JacobianType>::init(jac, m_pattern);
+        }
 
         // Function Body
-        for (int j = 0; j < n; ++j) {
-            h = eps * abs(x[j]);
-            if (h == 0.) {
-                h = eps;
+#ifdef EIGEN_HAS_OPENMP
+        #pragma omp parallel if(parallel) num_threads(Eigen::nbThreads())
+#endif
+        {
+            InputType x = _x;
+            ValueType val1, val2;
+            val1.resize(Functor::values());
+            val2.resize(Functor::values());
+#ifdef EIGEN_HAS_OPENMP
+            #pragma omp for schedule(dynamic)
+#endif
+            for (Index g = 0; g < ngroups; ++g) {
+                const Index *first = useGroups ? &m_groupCols[m_groupStart[g]] : &g;
+                const Index *last = useGroups ? &m_groupCols[0] + m_groupStart[g+1] : &g + 1;
+                for (const Index *j = first; j != last; ++j)
+                    x[*j] += step(_x[*j], eps);
+                switch(mode) {
+                    case Forward:
+                        Functor::operator()(x, val2);
+                        for (const Index *j = first; j != last; ++j) {
+                            x[*j] = _x[*j];
+                            setColumn(jac, *j, useGroups, val2, val0, step(_x[*j], eps));
+                        }
+                        break;
+                    case Central:
+                        Functor::operator()(x, val2);
+                        for (const Index *j = first; j != last; ++j)
+                            x[*j] -= 2*step(_x[*j], eps);
+                        Functor::operator()(x, val1);
+                        for (const Index *j = first; j != last; ++j) {
+                            x[*j] = _x[*j];
+                            setColumn(jac, *j, useGroups, val2, val1, 2*step(_x[*j], eps));
+                        }
+                        break;
+                    default:
+                        eigen_assert(false);
+                };
             }
-            switch(mode) {
-                case Forward:
-                    x[j] += h;
-                    Functor::operator()(x, val2);
-                    nfev++;
-                    x[j] = _x[j];
-                    jac.col(j) = (val2-val1)/h;
-                    break;
-                case Central:
-                    x[j] += h;
-                    Functor::operator()(x, val2); nfev++;
-                    x[j] -= 2*h;
-                    Functor::operator()(x, val1); nfev++;
-                    x[j] = _x[j];
-                    jac.col(j) = (val2-val1)/(2*h);
-                    break;
-                default:
-                    eigen_assert(false);
-            };
         }
+        nfev += int(mode == Central ? 2*ngroups : ngroups);
         return nfev;
     }
 private:
     Scalar epsfcn;
+    PatternType m_pattern;
+    Index m_ncolors;
+    std::vector<Index> m_colors; // color of each column
+    std::vector<Index> m_groupStart, m_groupCols; // columns of each color, concatenated
+    bool m_parallel;
+
+    static Scalar step(const Scalar &xj, const Scalar &eps)
+    {
+        using std::abs;
+        Scalar h = eps * abs(xj);
+        if (h == 0.) {
+            h = eps;
+        }
+        return h;
+    }
+
+    void setColumn(JacobianType &jac, Index j, bool useGroups, const ValueType &val2, const ValueType &val1, const Scalar &h) const
+    {
+        if (useGroups)
+            internal::numdiff_pattern_assign<JacobianType>::run(jac, m_pattern, j, val2, val1, h);
+        else
+            internal::numdiff_pattern_assign<JacobianType>::column(jac, j, val2, val1, h);
+    }
 
     NumericalDiff& operator=(const NumericalDiff&);
 };
@@ -28,6 +28,7 @@ protected:
     typedef typename MatrixType::Index Index;
     
     typedef typename NumTraits<typename MatrixType::Scalar>::Real RealScalar;
+    typedef Map<const Matrix<Scalar, Dynamic, 1> > EnvelopeMap;
 
 public:
 
@@ -35,7 +36,7 @@ public:
      * flags \a flags. */
     SkylineInplaceLU(MatrixType& matrix, int flags = 0)
     : /*m_matrix(matrix.rows(), matrix.cols()),*/ m_flags(flags), m_status(0), m_lu(matrix) {
-        m_precision = RealScalar(0.1) * Eigen::dummy_precision<RealScalar > ();
+        m_precision = RealScalar(0.1) * NumTraits<RealScalar>::dummy_precision();
         m_lu.IsRowMajor ? computeRowMajor() : compute();
     }
 
@@ -99,6 +100,16 @@ public:
     bool solve(const MatrixBase<BDerived> &b, MatrixBase<XDerived>* x,
             const int transposed = 0) const;
 
+    /** \returns the solution x of \f$ A x = b \f$ using the current factorization.
+     *
+     * The columns of \a b are solved independently, in parallel when OpenMP is enabled. */
+    template<typename BDerived>
+    Matrix<Scalar, Dynamic, BDerived::ColsAtCompileTime> solve(const MatrixBase<BDerived> &b) const {
+        Matrix<Scalar, Dynamic, BDerived::ColsAtCompileTime> x(b.rows(), b.cols());
+        solve(b, &x);
+        return x;
+    }
+
     /** \returns true if the factorization succeeded */
     inline bool succeeded(void) const {
         return m_succeeded;
@@ -182,116 +193,49 @@ void SkylineInplaceLU<MatrixType>::compute() {
 
 template<typename MatrixType>
 void SkylineInplaceLU<MatrixType>::computeRowMajor() {
-    const size_t rows = m_lu.rows();
-    const size_t cols = m_lu.cols();
+    const Index rows = m_lu.rows();
+    const Index cols = m_lu.cols();
 
     eigen_assert(rows == cols && "We do not (yet) support rectangular LU.");
     eigen_assert(m_lu.IsRowMajor && "You're trying to apply rowMajor decomposition on a ColMajor matrix !");
 
+    // Crout variant: the lower envelope of each row and the upper envelope of each column are contiguous,
+    // so every update is a dense dot product between the overlapping parts of two envelopes.
     for (Index row = 0; row < rows; row++) {
         typename MatrixType::InnerLowerIterator llIt(m_lu, row);
+        Scalar* lower = llIt.valuePtr();
+        const Index lowerStart = llIt.col();
 
-
-        for (Index col = llIt.col(); col < row; col++) {
-            if (m_lu.coeffExistLower(row, col)) {
-                const double diag = m_lu.coeffDiag(col);
-
-                typename MatrixType::InnerLowerIterator lIt(m_lu, row);
-                typename MatrixType::InnerUpperIterator uIt(m_lu, col);
-
-
-                const Index offset = lIt.col() - uIt.row();
-
-
-                Index stop = offset > 0 ? col - lIt.col() : col - uIt.row();
-
-                //#define VECTORIZE
-#ifdef VECTORIZE
-                Map<VectorXd > rowVal(lIt.valuePtr() + (offset > 0 ? 0 : -offset), stop);
-                Map<VectorXd > colVal(uIt.valuePtr() + (offset > 0 ? offset : 0), stop);
-
-
-                Scalar newCoeff = m_lu.coeffLower(row, col) - rowVal.dot(colVal);
-#else
-                if (offset > 0) //Skip zero value of lIt
-                    uIt += offset;
-                else //Skip zero values of uIt
-                    lIt += -offset;
-                Scalar newCoeff = m_lu.coeffLower(row, col);
-
-                for (Index k = 0; k < stop; ++k) {
-                    const Scalar tmp = newCoeff;
-                    newCoeff = tmp - lIt.value() * uIt.value();
-                    ++lIt;
-                    ++uIt;
-                }
-#endif
-
-                m_lu.coeffRefLower(row, col) = newCoeff / diag;
-            }
+        for (Index col = lowerStart; col < row; col++) {
+            typename MatrixType::InnerUpperIterator uIt(m_lu, col);
+            const Index start = (std::max)(lowerStart, uIt.row());
+            const Index stop = col - start;
+            Scalar newCoeff = lower[col - lowerStart];
+            if (stop > 0)
+                newCoeff -= EnvelopeMap(lower + start - lowerStart, stop).dot(EnvelopeMap(uIt.valuePtr() + start - uIt.row(), stop));
+            lower[col - lowerStart] = newCoeff / m_lu.coeffDiag(col);
         }
 
         //Upper matrix update
         const Index col = row;
         typename MatrixType::InnerUpperIterator uuIt(m_lu, col);
-        for (Index rrow = uuIt.row(); rrow < col; rrow++) {
-
+        Scalar* upper = uuIt.valuePtr();
+        const Index upperStart = uuIt.row();
+        for (Index rrow = upperStart; rrow < col; rrow++) {
             typename MatrixType::InnerLowerIterator lIt(m_lu, rrow);
-            typename MatrixType::InnerUpperIterator uIt(m_lu, col);
-            const Index offset = lIt.col() - uIt.row();
-
-            Index stop = offset > 0 ? rrow - lIt.col() : rrow - uIt.row();
-
-#ifdef VECTORIZE
-            Map<VectorXd > rowVal(lIt.valuePtr() + (offset > 0 ? 0 : -offset), stop);
-            Map<VectorXd > colVal(uIt.valuePtr() + (offset > 0 ? offset : 0), stop);
-
-            Scalar newCoeff = m_lu.coeffUpper(rrow, col) - rowVal.dot(colVal);
-#else
-            if (offset > 0) //Skip zero value of lIt
-                uIt += offset;
-            else //Skip zero values of uIt
-                lIt += -offset;
-            Scalar newCoeff = m_lu.coeffUpper(rrow, col);
-            for (Index k = 0; k < stop; ++k) {
-                const Scalar tmp = newCoeff;
-                newCoeff = tmp - lIt.value() * uIt.value();
-
-                ++lIt;
-                ++uIt;
-            }
-#endif
-            m_lu.coeffRefUpper(rrow, col) = newCoeff;
+            const Index start = (std::max)(upperStart, lIt.col());
+            const Index stop = rrow - start;
+            if (stop > 0)
+                upper[rrow - upperStart] -= EnvelopeMap(lIt.valuePtr() + start - lIt.col(), stop).dot(EnvelopeMap(upper + start - upperStart, stop));
         }
 
-
         //Diag matrix update
-        typename MatrixType::InnerLowerIterator lIt(m_lu, row);
-        typename MatrixType::InnerUpperIterator uIt(m_lu, row);
-
-        const Index offset = lIt.col() - uIt.row();
-
-
-        Index stop = offset > 0 ? lIt.size() : uIt.size();
-#ifdef VECTORIZE
-        Map<VectorXd > rowVal(lIt.valuePtr() + (offset > 0 ? 0 : -offset), stop);
-        Map<VectorXd > colVal(uIt.valuePtr() + (offset > 0 ? offset : 0), stop);
-        Scalar newCoeff = m_lu.coeffDiag(row) - rowVal.dot(colVal);
-#else
-        if (offset > 0) //Skip zero value of lIt
-            uIt += offset;
-        else //Skip zero values of uIt
-            lIt += -offset;
-        Scalar newCoeff = m_lu.coeffDiag(row);
-        for (Index k = 0; k < stop; ++k) {
-            const Scalar tmp = newCoeff;
-            newCoeff = tmp - lIt.value() * uIt.value();
-            ++lIt;
-            ++uIt;
-        }
-#endif
-        m_lu.coeffRefDiag(row) = newCoeff;
+        const Index start = (std::max)(lowerStart, upperStart);
+        const Index stop = row - start;
+        if (stop > 0)
+            m_lu.coeffRefDiag(row) -= EnvelopeMap(lower + start - lowerStart, stop).dot(EnvelopeMap(upper + start - upperStart, stop));
     }
+    m_succeeded = true;
 }
 
 /** Computes *x = U^-1 L^-1 b
@@ -305,44 +249,38 @@ void SkylineInplaceLU<MatrixType>::computeRowMajor() {
 template<typename MatrixType>
 template<typename BDerived, typename XDerived>
 bool SkylineInplaceLU<MatrixType>::solve(const MatrixBase<BDerived> &b, MatrixBase<XDerived>* x, const int transposed) const {
-    const size_t rows = m_lu.rows();
-    const size_t cols = m_lu.cols();
-
-
-    for (Index row = 0; row < rows; row++) {
-        x->coeffRef(row) = b.coeff(row);
-        Scalar newVal = x->coeff(row);
-        typename MatrixType::InnerLowerIterator lIt(m_lu, row);
-
-        Index col = lIt.col();
-        while (lIt.col() < row) {
-
-            newVal -= x->coeff(col++) * lIt.value();
-            ++lIt;
+    eigen_assert(m_lu.IsRowMajor && "The triangular solves require rowMajor Storage");
+    eigen_assert(!transposed && "Transposed solves are not supported");
+    EIGEN_UNUSED_VARIABLE(transposed);
+
+    const Index rows = m_lu.rows();
+    const Index nrhs = b.cols();
+    *x = b;
+
+    // Each column of the right hand side is independent. The forward substitution uses the row
+    // envelopes of L as dot products, the backward substitution the column envelopes of U as axpys.
+#ifdef EIGEN_HAS_OPENMP
+    Eigen::initParallel();
+    Index threads = Eigen::nbThreads();
+    #pragma omp parallel for num_threads(threads) if(threads > 1 && nrhs > 1)
+#endif
+    for (Index k = 0; k < nrhs; k++) {
+        typename XDerived::ColXpr xk = x->col(k);
+        for (Index row = 0; row < rows; row++) {
+            typename MatrixType::InnerLowerIterator lIt(m_lu, row);
+            const Index size = lIt.size();
+            if (size > 0)
+                xk.coeffRef(row) -= EnvelopeMap(lIt.valuePtr(), size).dot(xk.segment(lIt.col(), size));
         }
 
-        x->coeffRef(row) = newVal;
-    }
-
-
-    for (Index col = rows - 1; col > 0; col--) {
-        x->coeffRef(col) = x->coeff(col) / m_lu.coeffDiag(col);
-
-        const Scalar x_col = x->coeff(col);
-
-        typename MatrixType::InnerUpperIterator uIt(m_lu, col);
-        uIt += uIt.size()-1;
-
-
-        while (uIt) {
-            x->coeffRef(uIt.row()) -= x_col * uIt.value();
-            //TODO : introduce --operator
-            uIt += -1;
+        for (Index col = rows - 1; col >= 0; col--) {
+            xk.coeffRef(col) /= m_lu.coeffDiag(col);
+            typename MatrixType::InnerUpperIterator uIt(m_lu, col);
+            const Index size = uIt.size();
+            if (size > 0)
+                xk.segment(uIt.row(), size) -= xk.coeff(col) * EnvelopeMap(uIt.valuePtr(), size);
         }
-
-
     }
-    x->coeffRef(0) = x->coeff(0) / m_lu.coeffDiag(0);
 
     return true;
 }
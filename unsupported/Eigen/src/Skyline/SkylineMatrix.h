@@ -579,7 +579,7 @@ public:
         m_data.squeeze();
     }
 
-    void prune(Scalar reference, RealScalar epsilon = dummy_precision<RealScalar > ()) {
+    void prune(Scalar reference, RealScalar epsilon = NumTraits<RealScalar>::dummy_precision()) {
         //TODO
     }
 
@@ -658,7 +658,6 @@ public:
     }
 
     inline SkylineMatrix & operator=(const SkylineMatrix & other) {
-        std::cout << "SkylineMatrix& operator=(const SkylineMatrix& other)\n";
         if (other.isRValue()) {
             swap(other.const_cast_derived());
         } else {
@@ -28,7 +28,7 @@ public:
 
     typedef typename internal::traits<Derived>::Scalar Scalar;
     typedef typename internal::traits<Derived>::StorageKind StorageKind;
-    typedef typename internal::index<StorageKind>::type Index;
+    typedef Eigen::Index Index;
 
     enum {
         RowsAtCompileTime = internal::traits<Derived>::RowsAtCompileTime,
@@ -169,16 +169,13 @@ public:
         //TODO
     }
 
-    template<typename Lhs, typename Rhs>
-            inline Derived & operator=(const SkylineProduct<Lhs, Rhs, SkylineTimeSkylineProduct>& product);
-
     friend std::ostream & operator <<(std::ostream & s, const SkylineMatrixBase& m) {
         s << m.derived();
         return s;
     }
 
     template<typename OtherDerived>
-    const typename SkylineProductReturnType<Derived, OtherDerived>::Type
+    const SkylineTimeDenseProduct<Derived, OtherDerived>
     operator*(const MatrixBase<OtherDerived> &other) const;
 
     /** \internal use operator= */
@@ -199,8 +196,8 @@ public:
      * Notice that in the case of a plain matrix or vector (not an expression) this function just returns
      * a const reference, in order to avoid a useless copy.
      */
-    EIGEN_STRONG_INLINE const typename internal::eval<Derived, IsSkyline>::type eval() const {
-        return typename internal::eval<Derived>::type(derived());
+    EIGEN_STRONG_INLINE const typename internal::skyline_eval<Derived>::type eval() const {
+        return typename internal::skyline_eval<Derived>::type(derived());
     }
 
 protected:
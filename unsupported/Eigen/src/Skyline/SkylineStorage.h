@@ -21,7 +21,7 @@ namespace Eigen {
 template<typename Scalar>
 class SkylineStorage {
     typedef typename NumTraits<Scalar>::Real RealScalar;
-    typedef SparseIndex Index;
+    typedef Eigen::Index Index;
 public:
 
     SkylineStorage()
@@ -194,7 +194,7 @@ public:
         memset(m_lowerProfile, 0, m_diagSize * sizeof (Index));
     }
 
-    void prune(Scalar reference, RealScalar epsilon = dummy_precision<RealScalar>()) {
+    void prune(Scalar reference, RealScalar epsilon = NumTraits<RealScalar>::dummy_precision()) {
         //TODO
     }
 
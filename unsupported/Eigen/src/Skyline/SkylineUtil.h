@@ -19,8 +19,6 @@ namespace Eigen {
 #endif
 
 const unsigned int SkylineBit = 0x1200;
-template<typename Lhs, typename Rhs, int ProductMode> class SkylineProduct;
-enum AdditionalProductEvaluationMode {SkylineTimeDenseProduct, SkylineTimeSkylineProduct, DenseTimeSkylineProduct};
 enum {IsSkyline = SkylineBit};
 
 
@@ -54,7 +52,7 @@ EIGEN_STRONG_INLINE Derived& operator Op(const Other& scalar) \
   typedef typename Eigen::internal::traits<Derived>::Scalar Scalar; \
   typedef typename Eigen::NumTraits<Scalar>::Real RealScalar; \
   typedef typename Eigen::internal::traits<Derived>::StorageKind StorageKind; \
-  typedef typename Eigen::internal::index<StorageKind>::type Index; \
+  typedef Eigen::Index Index; \
   enum {  Flags = Eigen::internal::traits<Derived>::Flags, };
 
 #define EIGEN_SKYLINE_GENERIC_PUBLIC_INTERFACE(Derived) \
@@ -68,22 +66,20 @@ template<typename _Scalar, int _Flags = 0> class MappedSkylineMatrix;
 
 namespace internal {
 
-template<typename Lhs, typename Rhs> struct skyline_product_mode;
-template<typename Lhs, typename Rhs, int ProductMode = skyline_product_mode<Lhs,Rhs>::value> struct SkylineProductReturnType;
-
-template<typename T> class eval<T,IsSkyline>
+template<typename T> struct skyline_eval
 {
     typedef typename traits<T>::Scalar _Scalar;
     enum {
-          _Flags = traits<T>::Flags
+          _Flags = traits<T>::Flags & RowMajorBit
     };
 
-  public:
     typedef SkylineMatrix<_Scalar, _Flags> type;
 };
 
 } // end namespace internal
 
+template<typename Lhs, typename Rhs> class SkylineTimeDenseProduct;
+
 } // end namespace Eigen
 
 #endif // EIGEN_SKYLINEUTIL_H
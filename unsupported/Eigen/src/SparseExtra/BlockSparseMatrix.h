@@ -46,6 +46,10 @@ namespace Eigen {
   * It is obviously required to describe the block layout beforehand by calling either
   * setBlockSize() for fixed-size blocks or setBlockLayout for variable-size blocks.
   *
+  * The products with dense matrices use specialized kernels when all blocks are 2x2, 3x3, 4x4, 6x6 or 8x8,
+  * either at compile time or through setBlockSize(). With OpenMP, row-major matrices are processed in
+  * parallel over the block rows.
+  *
   * \tparam _Scalar The Scalar type
   * \tparam _BlockAtCompileTime The block layout option. It takes the following values
   * Dynamic : block size known at runtime
@@ -60,7 +64,7 @@ template<typename _Scalar, int _BlockAtCompileTime, int _Options, typename _Inde
 struct traits<BlockSparseMatrix<_Scalar,_BlockAtCompileTime,_Options, _Index> >
 {
   typedef _Scalar Scalar;
-  typedef _Index Index;
+  typedef _Index StorageIndex;
   typedef Sparse StorageKind; // FIXME Where is it used ??
   typedef MatrixXpr XprKind;
   enum {
@@ -153,131 +157,210 @@ class BlockSparseMatrixView : public SparseMatrixBase<BlockSparseMatrixT>
     const BlockSparseMatrixT& m_spblockmat;
 };
 
-// Proxy to view a regular vector as a block vector
-template<typename BlockSparseMatrixT, typename VectorType>
-class BlockVectorView
+// Block version of the sparse dense product
+template<typename Lhs, typename Rhs>
+class BlockSparseTimeDenseProduct;
+
+namespace internal {
+
+template<typename BlockSparseMatrixT, typename VecType>
+struct traits<BlockSparseTimeDenseProduct<BlockSparseMatrixT, VecType> >
 {
-  public:
-    enum {
-      BlockSize = BlockSparseMatrixT::BlockSize,
-      ColsAtCompileTime = VectorType::ColsAtCompileTime,
-      RowsAtCompileTime = VectorType::RowsAtCompileTime,
-      Flags = VectorType::Flags
-    };
-    typedef Ref<const Matrix<typename BlockSparseMatrixT::Scalar, (RowsAtCompileTime==1)? 1 : BlockSize, (ColsAtCompileTime==1)? 1 : BlockSize> >Scalar;
-    typedef typename BlockSparseMatrixT::Index Index;
-  public:
-    BlockVectorView(const BlockSparseMatrixT& spblockmat, const VectorType& vec)
-    : m_spblockmat(spblockmat),m_vec(vec)
-    { }
-    inline Index cols() const
+  typedef Matrix<typename BlockSparseMatrixT::Scalar, Dynamic, VecType::ColsAtCompileTime, ColMajor,
+                 Dynamic, VecType::MaxColsAtCompileTime> ReturnType;
+};
+
+/* Kernels for res += alpha * lhs * rhs where all the blocks of lhs are BS x BS matrices, BS being known
+ * at compile time. Each block is multiplied by panels of up to 4 columns of rhs, so that both the
+ * block and the partial results stay in registers. Only one inner index is read per block.
+ */
+template<int BS, typename Lhs, typename Rhs, typename Dest,
+         int LhsStorageOrder = Lhs::IsColMajor ? ColMajor : RowMajor>
+struct bsr_time_dense_product_fixed;
+
+// Block rows are stored contiguously: accumulate each block row of the result, in parallel
+template<int BS, typename Lhs, typename Rhs, typename Dest>
+struct bsr_time_dense_product_fixed<BS, Lhs, Rhs, Dest, RowMajor>
+{
+  typedef typename Dest::Scalar Scalar;
+  typedef typename Lhs::StorageIndex StorageIndex;
+  typedef Map<const Matrix<Scalar,BS,BS,RowMajor> > BlockMap;
+
+  static void run(const Lhs& lhs, const Rhs& rhs, Dest& res, const Scalar& alpha)
+  {
+    const Index n = lhs.outerBlocks();
+#ifdef EIGEN_HAS_OPENMP
+    Eigen::initParallel();
+    Index threads = Eigen::nbThreads();
+    // Same threshold as for the scalar sparse * dense product
+    if(threads>1 && lhs.nonZeros() * rhs.cols() > 20000)
     {
-      return m_vec.cols();
+      #pragma omp parallel for schedule(dynamic,(n+threads*4-1)/(threads*4)) num_threads(threads)
+      for(Index bi=0; bi<n; ++bi)
+        processBlockRow(lhs,rhs,res,alpha,bi);
     }
-    inline Index size() const
+    else
+#endif
     {
-      return m_spblockmat.blockRows();
+      for(Index bi=0; bi<n; ++bi)
+        processBlockRow(lhs,rhs,res,alpha,bi);
     }
-    inline Scalar coeff(Index bi) const
+  }
+
+  static void processBlockRow(const Lhs& lhs, const Rhs& rhs, Dest& res, const Scalar& alpha, Index bi)
+  {
+    const StorageIndex* indices = lhs.innerIndexPtr();
+    const Scalar* values = lhs.valuePtr();
+    const Index start = lhs.outerIndexPtr()[bi], end = lhs.outerIndexPtr()[bi+1];
+    Index c = 0;
+    for(; c+4<=rhs.cols(); c+=4)
     {
-      Index startRow = m_spblockmat.blockRowsIndex(bi);
-      Index rowSize = m_spblockmat.blockRowsIndex(bi+1) - startRow;
-      return m_vec.middleRows(startRow, rowSize);
+      Matrix<Scalar,BS,4> tmp = Matrix<Scalar,BS,4>::Zero();
+      for(Index k=start; k<end; ++k)
+        tmp.noalias() += BlockMap(values + k*BS*BS) * rhs.template block<BS,4>(indices[k]*BS, c);
+      res.template block<BS,4>(bi*BS, c) += alpha * tmp;
     }
-    inline Scalar coeff(Index bi, Index j) const
+    for(; c<rhs.cols(); ++c)
     {
-      Index startRow = m_spblockmat.blockRowsIndex(bi);
-      Index rowSize = m_spblockmat.blockRowsIndex(bi+1) - startRow;
-      return m_vec.block(startRow, j, rowSize, 1);
+      Matrix<Scalar,BS,1> tmp = Matrix<Scalar,BS,1>::Zero();
+      for(Index k=start; k<end; ++k)
+        tmp.noalias() += BlockMap(values + k*BS*BS) * rhs.col(c).template segment<BS>(indices[k]*BS);
+      res.col(c).template segment<BS>(bi*BS) += alpha * tmp;
     }
-  protected:
-    const BlockSparseMatrixT& m_spblockmat;
-    const VectorType& m_vec;
+  }
 };
 
-template<typename VectorType, typename Index> class BlockVectorReturn;
-
-
-// Proxy to view a regular vector as a block vector
-template<typename BlockSparseMatrixT, typename VectorType>
-class BlockVectorReturn
+// Block columns are stored contiguously: scatter the contributions of each block column,
+// only the panels of the right hand side are processed in parallel
+template<int BS, typename Lhs, typename Rhs, typename Dest>
+struct bsr_time_dense_product_fixed<BS, Lhs, Rhs, Dest, ColMajor>
 {
-  public:
-    enum {
-      ColsAtCompileTime = VectorType::ColsAtCompileTime,
-      RowsAtCompileTime = VectorType::RowsAtCompileTime,
-      Flags = VectorType::Flags
-    };
-    typedef Ref<Matrix<typename VectorType::Scalar, RowsAtCompileTime, ColsAtCompileTime> > Scalar;
-    typedef typename BlockSparseMatrixT::Index Index;
-  public:
-    BlockVectorReturn(const BlockSparseMatrixT& spblockmat, VectorType& vec)
-    : m_spblockmat(spblockmat),m_vec(vec)
-    { }
-    inline Index size() const
+  typedef typename Dest::Scalar Scalar;
+  typedef typename Lhs::StorageIndex StorageIndex;
+  typedef Map<const Matrix<Scalar,BS,BS,ColMajor> > BlockMap;
+
+  static void run(const Lhs& lhs, const Rhs& rhs, Dest& res, const Scalar& alpha)
+  {
+    const Index panels = (rhs.cols()+3)/4;
+#ifdef EIGEN_HAS_OPENMP
+    Eigen::initParallel();
+    Index threads = Eigen::nbThreads();
+    if(threads>1 && panels>1 && lhs.nonZeros() * rhs.cols() > 20000)
     {
-      return m_spblockmat.blockRows();
+      #pragma omp parallel for schedule(dynamic,1) num_threads(threads)
+      for(Index p=0; p<panels; ++p)
+        processPanel(lhs,rhs,res,alpha,p);
     }
-    inline Scalar coeffRef(Index bi)
+    else
+#endif
     {
-      Index startRow = m_spblockmat.blockRowsIndex(bi);
-      Index rowSize = m_spblockmat.blockRowsIndex(bi+1) - startRow;
-      return m_vec.middleRows(startRow, rowSize);
+      for(Index p=0; p<panels; ++p)
+        processPanel(lhs,rhs,res,alpha,p);
     }
-    inline Scalar coeffRef(Index bi, Index j)
+  }
+
+  static void processPanel(const Lhs& lhs, const Rhs& rhs, Dest& res, const Scalar& alpha, Index p)
+  {
+    const StorageIndex* indices = lhs.innerIndexPtr();
+    const Scalar* values = lhs.valuePtr();
+    const Index c = 4*p;
+    for(Index bj=0; bj<lhs.outerBlocks(); ++bj)
     {
-      Index startRow = m_spblockmat.blockRowsIndex(bi);
-      Index rowSize = m_spblockmat.blockRowsIndex(bi+1) - startRow;
-      return m_vec.block(startRow, j, rowSize, 1);
+      const Index start = lhs.outerIndexPtr()[bj], end = lhs.outerIndexPtr()[bj+1];
+      if(c+4<=rhs.cols())
+      {
+        const Matrix<Scalar,BS,4> x = alpha * rhs.template block<BS,4>(bj*BS, c);
+        for(Index k=start; k<end; ++k)
+          res.template block<BS,4>(indices[k]*BS, c).noalias() += BlockMap(values + k*BS*BS) * x;
+      }
+      else
+      {
+        for(Index j=c; j<rhs.cols(); ++j)
+        {
+          const Matrix<Scalar,BS,1> x = alpha * rhs.col(j).template segment<BS>(bj*BS);
+          for(Index k=start; k<end; ++k)
+            res.col(j).template segment<BS>(indices[k]*BS).noalias() += BlockMap(values + k*BS*BS) * x;
+        }
+      }
     }
-
-  protected:
-    const BlockSparseMatrixT& m_spblockmat;
-    VectorType& m_vec;
+  }
 };
 
-// Block version of the sparse dense product
-template<typename Lhs, typename Rhs>
-class BlockSparseTimeDenseProduct;
+// Fallback for variable-size blocks and uncommon runtime block sizes
+template<typename Lhs, typename Rhs, typename Dest>
+void bsr_time_dense_product_generic(const Lhs& lhs, const Rhs& rhs, Dest& res, const typename Dest::Scalar& alpha)
+{
+  for(Index bj=0; bj<lhs.outerBlocks(); ++bj)
+  {
+    for(typename Lhs::BlockInnerIterator it(lhs, bj); it; ++it)
+    {
+      const Index row = lhs.blockRowsIndex(it.row()), col = lhs.blockColsIndex(it.col());
+      res.middleRows(row, it.value().rows()).noalias() += alpha * it.value() * rhs.middleRows(col, it.value().cols());
+    }
+  }
+}
 
-namespace internal {
+template<typename Lhs, typename Rhs, typename Dest, int BlockSize = Lhs::BlockSize>
+struct bsr_time_dense_product
+{
+  static void run(const Lhs& lhs, const Rhs& rhs, Dest& res, const typename Dest::Scalar& alpha)
+  {
+    bsr_time_dense_product_fixed<BlockSize,Lhs,Rhs,Dest>::run(lhs, rhs, res, alpha);
+  }
+};
 
-template<typename BlockSparseMatrixT, typename VecType>
-struct traits<BlockSparseTimeDenseProduct<BlockSparseMatrixT, VecType> >
+// Select a fixed-size kernel from the block size given at runtime
+template<typename Lhs, typename Rhs, typename Dest>
+struct bsr_time_dense_product<Lhs, Rhs, Dest, Dynamic>
 {
-  typedef Dense StorageKind;
-  typedef MatrixXpr XprKind;
-  typedef typename BlockSparseMatrixT::Scalar Scalar;
-  typedef typename BlockSparseMatrixT::Index Index;
-  enum {
-    RowsAtCompileTime = Dynamic,
-    ColsAtCompileTime = Dynamic,
-    MaxRowsAtCompileTime = Dynamic,
-    MaxColsAtCompileTime = Dynamic,
-    Flags = 0,
-    CoeffReadCost = internal::traits<BlockSparseMatrixT>::CoeffReadCost
-  };
+  static void run(const Lhs& lhs, const Rhs& rhs, Dest& res, const typename Dest::Scalar& alpha)
+  {
+    switch(lhs.blockSize())
+    {
+      case 2: bsr_time_dense_product_fixed<2,Lhs,Rhs,Dest>::run(lhs, rhs, res, alpha); break;
+      case 3: bsr_time_dense_product_fixed<3,Lhs,Rhs,Dest>::run(lhs, rhs, res, alpha); break;
+      case 4: bsr_time_dense_product_fixed<4,Lhs,Rhs,Dest>::run(lhs, rhs, res, alpha); break;
+      case 6: bsr_time_dense_product_fixed<6,Lhs,Rhs,Dest>::run(lhs, rhs, res, alpha); break;
+      case 8: bsr_time_dense_product_fixed<8,Lhs,Rhs,Dest>::run(lhs, rhs, res, alpha); break;
+      default: bsr_time_dense_product_generic(lhs, rhs, res, alpha);
+    }
+  }
 };
+
 } // end namespace internal
 
 template<typename Lhs, typename Rhs>
 class BlockSparseTimeDenseProduct
-  : public ProductBase<BlockSparseTimeDenseProduct<Lhs,Rhs>, Lhs, Rhs>
+  : public ReturnByValue<BlockSparseTimeDenseProduct<Lhs,Rhs> >
 {
   public:
-    EIGEN_PRODUCT_PUBLIC_INTERFACE(BlockSparseTimeDenseProduct)
+    typedef typename Lhs::Scalar Scalar;
+    typedef typename internal::nested_eval<Rhs,Dynamic>::type RhsNested;
 
-    BlockSparseTimeDenseProduct(const Lhs& lhs, const Rhs& rhs) : Base(lhs,rhs)
-    {}
+    BlockSparseTimeDenseProduct(const Lhs& lhs, const Rhs& rhs) : m_lhs(lhs), m_rhs(rhs)
+    {
+      eigen_assert(lhs.cols() == rhs.rows() && "invalid matrix product");
+    }
+
+    inline Index rows() const { return m_lhs.rows(); }
+    inline Index cols() const { return m_rhs.cols(); }
 
-    template<typename Dest> void scaleAndAddTo(Dest& dest, const typename Rhs::Scalar& alpha) const
+    template<typename Dest> void evalTo(Dest& dest) const
     {
-      BlockVectorReturn<Lhs,Dest> tmpDest(m_lhs, dest);
-      internal::sparse_time_dense_product( BlockSparseMatrixView<Lhs>(m_lhs),  BlockVectorView<Lhs, Rhs>(m_lhs, m_rhs), tmpDest, alpha);
+      dest.setZero(rows(), cols());
+      scaleAndAddTo(dest, Scalar(1));
+    }
+
+    /** Adds \a alpha times the product to \a dest */
+    template<typename Dest> void scaleAndAddTo(Dest& dest, const Scalar& alpha) const
+    {
+      eigen_assert(dest.rows() == rows() && dest.cols() == cols());
+      internal::bsr_time_dense_product<Lhs, typename internal::remove_all<RhsNested>::type, Dest>::run(m_lhs, m_rhs, dest, alpha);
     }
 
   private:
-    BlockSparseTimeDenseProduct& operator=(const BlockSparseTimeDenseProduct&);
+    const Lhs& m_lhs;
+    RhsNested m_rhs;
 };
 
 template<typename _Scalar, int _BlockAtCompileTime, int _Options, typename _StorageIndex>
@@ -330,21 +413,31 @@ class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_Blo
      */
     BlockSparseMatrix(const BlockSparseMatrix& other)
       : m_innerBSize(other.m_innerBSize),m_outerBSize(other.m_outerBSize),
+        m_innerOffset(0),m_outerOffset(0),
         m_nonzerosblocks(other.m_nonzerosblocks),m_nonzeros(other.m_nonzeros),
-        m_blockPtr(0),m_blockSize(other.m_blockSize)
+        m_values(0),m_blockPtr(0),m_indices(0),m_outerIndex(0),m_blockSize(other.m_blockSize)
     {
-      // should we allow copying between variable-size blocks and fixed-size blocks ??
-      eigen_assert(m_blockSize == BlockSize && " CAN NOT COPY BETWEEN FIXED-SIZE AND VARIABLE-SIZE BLOCKS");
-
-      std::copy(other.m_innerOffset, other.m_innerOffset+m_innerBSize+1, m_innerOffset);
-      std::copy(other.m_outerOffset, other.m_outerOffset+m_outerBSize+1, m_outerOffset);
-      std::copy(other.m_values, other.m_values+m_nonzeros, m_values);
-
-      if(m_blockSize != Dynamic)
-        std::copy(other.m_blockPtr, other.m_blockPtr+m_nonzerosblocks, m_blockPtr);
-
-      std::copy(other.m_indices, other.m_indices+m_nonzerosblocks, m_indices);
-      std::copy(other.m_outerIndex, other.m_outerIndex+m_outerBSize, m_outerIndex);
+      if(other.m_innerOffset)
+      {
+        m_innerOffset = new StorageIndex[m_innerBSize+1];
+        m_outerOffset = new StorageIndex[m_outerBSize+1];
+        std::copy(other.m_innerOffset, other.m_innerOffset+m_innerBSize+1, m_innerOffset);
+        std::copy(other.m_outerOffset, other.m_outerOffset+m_outerBSize+1, m_outerOffset);
+      }
+      if(other.m_outerIndex)
+      {
+        m_outerIndex = new StorageIndex[m_outerBSize+1];
+        m_indices = new StorageIndex[m_nonzerosblocks+1];
+        m_values = new Scalar[m_nonzeros];
+        std::copy(other.m_outerIndex, other.m_outerIndex+m_outerBSize+1, m_outerIndex);
+        std::copy(other.m_indices, other.m_indices+m_nonzerosblocks, m_indices);
+        std::copy(other.m_values, other.m_values+m_nonzeros, m_values);
+      }
+      if(other.m_blockPtr)
+      {
+        m_blockPtr = new StorageIndex[m_nonzerosblocks+1];
+        std::copy(other.m_blockPtr, other.m_blockPtr+m_nonzerosblocks+1, m_blockPtr);
+      }
     }
 
     friend void swap(BlockSparseMatrix& first, BlockSparseMatrix& second)
@@ -359,7 +452,7 @@ class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_Blo
       std::swap(first.m_blockPtr, second.m_blockPtr);
       std::swap(first.m_indices, second.m_indices);
       std::swap(first.m_outerIndex, second.m_outerIndex);
-      std::swap(first.m_BlockSize, second.m_blockSize);
+      std::swap(first.m_blockSize, second.m_blockSize);
     }
 
     BlockSparseMatrix& operator=(BlockSparseMatrix other)
@@ -386,10 +479,15 @@ class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_Blo
       *
       */
     template<typename MatrixType>
-    inline BlockSparseMatrix(const MatrixType& spmat) : m_blockSize(BlockSize)
+    inline BlockSparseMatrix(const MatrixType& spmat)
+      : m_innerOffset(0),m_outerOffset(0),m_nonzerosblocks(0),
+        m_values(0),m_blockPtr(0),m_indices(0),
+        m_outerIndex(0),m_blockSize(BlockSize)
     {
-      EIGEN_STATIC_ASSERT((m_blockSize != Dynamic), THIS_METHOD_IS_ONLY_FOR_FIXED_SIZE);
-
+      EIGEN_STATIC_ASSERT((BlockSize != Dynamic), THIS_METHOD_IS_ONLY_FOR_FIXED_SIZE);
+      eigen_assert(spmat.rows() % BlockSize == 0 && spmat.cols() % BlockSize == 0
+                   && "The dimensions must be multiples of the block size");
+      resize(spmat.rows() / BlockSize, spmat.cols() / BlockSize);
       *this = spmat;
     }
 
@@ -459,7 +557,7 @@ class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_Blo
               // Offset from all blocks before ...
               idxVal =  m_blockPtr[m_outerIndex[bj]+idx];
               // ... and offset inside the block
-              idxVal += (j - blockOuterIndex(bj)) * blockOuterSize(bj) + it_spmat.index() - m_innerOffset[bi];
+              idxVal += (j - blockOuterIndex(bj)) * blockInnerSize(bi) + it_spmat.index() - m_innerOffset[bi];
             }
             else
             {
@@ -477,6 +575,35 @@ class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_Blo
       return *this;
     }
 
+    /**
+      * \brief Conversion to a regular sparse matrix with the same storage order
+      *
+      * All the coefficients of the nonzero blocks are stored, including the explicit zeros.
+      * Call SparseMatrix::prune() on the result to remove them.
+      */
+    SparseMatrix<Scalar, IsColMajor ? ColMajor : RowMajor, StorageIndex> toSparseMatrix() const
+    {
+      SparseMatrix<Scalar, IsColMajor ? ColMajor : RowMajor, StorageIndex> res(rows(), cols());
+      res.reserve(m_nonzeros);
+      for(Index bj = 0; bj < m_outerBSize; ++bj)
+      {
+        for(Index j = blockOuterIndex(bj); j < blockOuterIndex(bj+1); ++j)
+        {
+          res.startVec(j);
+          for(BlockInnerIterator itb(*this, bj); itb; ++itb)
+          {
+            const Index start = blockInnerIndex(itb.index());
+            // Blocks are stored in the storage order of the matrix
+            const Scalar* values = m_values + blockPtr(itb.id()) + (j-blockOuterIndex(bj)) * blockInnerSize(itb.index());
+            for(Index i = 0; i < blockInnerSize(itb.index()); ++i)
+              res.insertBack(IsColMajor ? start+i : j, IsColMajor ? j : start+i) = values[i];
+          }
+        }
+      }
+      res.finalize();
+      return res;
+    }
+
     /**
       * \brief Set the nonzero block pattern of the matrix
       *
@@ -524,7 +651,7 @@ class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_Blo
           StorageIndex offset = m_outerIndex[bj]+idx; // offset in m_indices
           m_indices[offset] = nzBlockIdx[idx];
           if(m_blockSize == Dynamic)
-            m_blockPtr[offset] = m_blockPtr[offset-1] + blockInnerSize(nzBlockIdx[idx]) * blockOuterSize(bj);
+            m_blockPtr[offset+1] = m_blockPtr[offset] + blockInnerSize(nzBlockIdx[idx]) * blockOuterSize(bj);
           // There is no blockPtr for fixed-size blocks... not needed !???
         }
         // Save the pointer to the next outer block
@@ -551,6 +678,9 @@ class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_Blo
       m_blockSize = blockSize;
     }
 
+    /** \returns the size of the blocks for fixed-size block layouts, Dynamic for variable-size blocks */
+    inline Index blockSize() const { return m_blockSize; }
+
     /**
       * \brief Set the row and column block layouts,
       *
@@ -598,7 +728,10 @@ class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_Blo
       eigen_assert((m_innerBSize != 0 && m_outerBSize != 0) &&
           "TRYING TO RESERVE ZERO-SIZE MATRICES, CALL resize() first");
 
-      //FIXME Should free if already allocated
+      delete[] m_outerIndex;
+      delete[] m_blockPtr;
+      delete[] m_indices;
+      delete[] m_values;
       m_outerIndex = new StorageIndex[m_outerBSize+1];
 
       m_nonzerosblocks = nonzerosblocks;
@@ -642,8 +775,8 @@ class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_Blo
       /* Count the number of rows and column blocks,
        * and the number of nonzero blocks per outer dimension
        */
-      VectorXi rowBlocks(m_innerBSize); // Size of each block row
-      VectorXi colBlocks(m_outerBSize); // Size of each block column
+      VectorXi rowBlocks(blockRows()); // Size of each block row
+      VectorXi colBlocks(blockCols()); // Size of each block column
       rowBlocks.setZero(); colBlocks.setZero();
       VectorXi nzblock_outer(m_outerBSize); // Number of nz blocks per outer vector
       VectorXi nz_outer(m_outerBSize); // Number of nz per outer vector...for variable-size blocks
@@ -696,7 +829,7 @@ class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_Blo
         m_indices[block_id(outer)] = inner;
         StorageIndex block_size = it->value().rows()*it->value().cols();
         StorageIndex nz_marker = blockPtr(block_id[outer]);
-        memcpy(&(m_values[nz_marker]), it->value().data(), block_size * sizeof(Scalar));
+        Map<BlockScalar>(&(m_values[nz_marker]), it->value().rows(), it->value().cols()) = it->value();
         if(m_blockSize == Dynamic)
         {
           m_blockPtr[block_id(outer)+1] = m_blockPtr[block_id(outer)] + block_size;
@@ -861,8 +994,9 @@ class BlockSparseMatrix : public SparseMatrixBase<BlockSparseMatrix<_Scalar,_Blo
     /** \returns the total number of nonzero elements, including eventual explicit zeros in blocks */
     inline Index nonZeros() const { return m_nonzeros; }
 
-    inline BlockScalarReturnType *valuePtr() {return static_cast<BlockScalarReturnType *>(m_values);}
-//    inline Scalar *valuePtr(){ return m_values; }
+    /** \returns a pointer to the values, stored block after block, each block being in the storage order of the matrix */
+    inline Scalar *valuePtr() { return m_values; }
+    inline const Scalar *valuePtr() const { return m_values; }
     inline StorageIndex *innerIndexPtr() {return m_indices; }
     inline const StorageIndex *innerIndexPtr() const {return m_indices; }
     inline StorageIndex *outerIndexPtr() {return m_outerIndex; }
@@ -998,15 +1132,17 @@ class BlockSparseMatrix<_Scalar, _BlockAtCompileTime, _Options, _StorageIndex>::
     }
     // Block inner index
     inline Index index() const {return m_mat.m_indices[m_id]; }
+    // Position of the block in the arrays of indices
+    inline Index id() const { return m_id; }
     inline Index outer() const { return m_outer; }
     // block row index
-    inline Index row() const  {return index(); }
+    inline Index row() const  {return IsColMajor ? index() : outer(); }
     // block column index
-    inline Index col() const {return outer(); }
-    // FIXME Number of rows in the current block
-    inline Index rows() const { return (m_mat.m_blockSize==Dynamic) ? (m_mat.m_innerOffset[index()+1] - m_mat.m_innerOffset[index()]) : m_mat.m_blockSize; }
-    // Number of columns in the current block ...
-    inline Index cols() const { return (m_mat.m_blockSize==Dynamic) ? (m_mat.m_outerOffset[m_outer+1]-m_mat.m_outerOffset[m_outer]) : m_mat.m_blockSize;}
+    inline Index col() const {return IsColMajor ? outer() : index(); }
+    // Number of rows in the current block
+    inline Index rows() const { return IsColMajor ? m_mat.blockInnerSize(index()) : m_mat.blockOuterSize(m_outer); }
+    // Number of columns in the current block
+    inline Index cols() const { return IsColMajor ? m_mat.blockOuterSize(m_outer) : m_mat.blockInnerSize(index()); }
     inline operator bool() const { return (m_id < m_end); }
 
   protected:
@@ -1049,16 +1185,16 @@ class BlockSparseMatrix<_Scalar, _BlockAtCompileTime, _Options, _StorageIndex>::
     }
     inline const Scalar& value() const
     {
-      return itb.value().coeff(m_id - m_start, m_offset);
+      return IsColMajor ? itb.value().coeff(m_id - m_start, m_offset) : itb.value().coeff(m_offset, m_id - m_start);
     }
     inline Scalar& valueRef()
     {
-      return itb.valueRef().coeff(m_id - m_start, m_offset);
+      return IsColMajor ? itb.valueRef().coeffRef(m_id - m_start, m_offset) : itb.valueRef().coeffRef(m_offset, m_id - m_start);
     }
     inline Index index() const { return m_id; }
     inline Index outer() const {return m_outer; }
-    inline Index col() const {return outer(); }
-    inline Index row() const { return index();}
+    inline Index col() const { return IsColMajor ? outer() : index(); }
+    inline Index row() const { return IsColMajor ? index() : outer(); }
     inline operator bool() const
     {
       return itb;
@@ -0,0 +1,379 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_CONCURRENT_SPARSE_BUILDER_H
+#define EIGEN_CONCURRENT_SPARSE_BUILDER_H
+
+namespace Eigen {
+
+namespace internal {
+
+template<typename Scalar, typename StorageIndex>
+struct sparse_builder_entry
+{
+  StorageIndex outer;
+  StorageIndex inner;
+  Scalar value;
+
+  bool operator<(const sparse_builder_entry& other) const
+  { return outer < other.outer || (outer == other.outer && inner < other.inner); }
+};
+
+/** \internal
+  * Open addressing hash table with linear probing mapping (outer,inner) pairs to coefficients.
+  * Keys and values are interleaved in a flat array, so that a lookup usually touches a single cache line
+  * and insertions do not allocate unless the table grows.
+  */
+template<typename Scalar, typename StorageIndex>
+class sparse_coeff_accumulator
+{
+  public:
+    typedef sparse_builder_entry<Scalar,StorageIndex> Entry;
+
+    sparse_coeff_accumulator() : m_size(0) {}
+
+    Scalar& coeffRef(StorageIndex outer, StorageIndex inner)
+    {
+      if (2*(m_size+1) > capacity())
+        grow();
+      const Index mask = capacity()-1;
+      Index h = hash(outer, inner) & mask;
+      while (m_table[h].outer != StorageIndex(-1))
+      {
+        if (m_table[h].outer==outer && m_table[h].inner==inner)
+          return m_table[h].value;
+        h = (h+1) & mask;
+      }
+      m_table[h].outer = outer;
+      m_table[h].inner = inner;
+      m_table[h].value = Scalar(0);
+      ++m_size;
+      return m_table[h].value;
+    }
+
+    Index size() const { return m_size; }
+
+    void reserve(Index size)
+    {
+      Index newCapacity = 64;
+      while (newCapacity < 2*size)
+        newCapacity *= 2;
+      if (newCapacity > capacity())
+      {
+        std::vector<Entry> table;
+        table.swap(m_table);
+        rehash(table, newCapacity);
+      }
+    }
+
+    /** Stores the coefficients in \a entries, sorted by outer then inner index, and empties the table.
+      * This is a two pass radix sort: the entries are bucketed by inner index, then stably by outer index. */
+    void extractSorted(std::vector<Entry>& entries, Index outerSize, Index innerSize)
+    {
+      std::vector<Entry> tmp(m_size);
+      std::vector<Index> positions(innerSize+1, 0);
+      for (Index h=0; h<capacity(); ++h)
+        if (m_table[h].outer != StorageIndex(-1))
+          ++positions[m_table[h].inner+1];
+      for (Index i=0; i<innerSize; ++i)
+        positions[i+1] += positions[i];
+      for (Index h=0; h<capacity(); ++h)
+        if (m_table[h].outer != StorageIndex(-1))
+          tmp[positions[m_table[h].inner]++] = m_table[h];
+      clear();
+
+      positions.assign(outerSize+1, 0);
+      for (Index k=0; k<Index(tmp.size()); ++k)
+        ++positions[tmp[k].outer+1];
+      for (Index j=0; j<outerSize; ++j)
+        positions[j+1] += positions[j];
+      entries.resize(tmp.size());
+      for (Index k=0; k<Index(tmp.size()); ++k)
+        entries[positions[tmp[k].outer]++] = tmp[k];
+    }
+
+    void clear()
+    {
+      std::vector<Entry>().swap(m_table);
+      m_size = 0;
+    }
+
+  protected:
+    Index capacity() const { return static_cast<Index>(m_table.size()); }
+
+    static Index hash(StorageIndex outer, StorageIndex inner)
+    {
+      std::size_t h = std::size_t(outer) * 2654435761u + std::size_t(inner);
+      h ^= h >> 15;
+      h *= 2246822519u;
+      h ^= h >> 13;
+      return static_cast<Index>(h & (std::size_t(-1) >> 1));
+    }
+
+    void grow()
+    {
+      std::vector<Entry> table;
+      table.swap(m_table);
+      rehash(table, (std::max)(Index(64), 2*static_cast<Index>(table.size())));
+    }
+
+    void rehash(const std::vector<Entry>& table, Index newCapacity)
+    {
+      Entry empty;
+      empty.outer = StorageIndex(-1);
+      empty.inner = StorageIndex(-1);
+      empty.value = Scalar(0);
+      m_table.assign(newCapacity, empty);
+      m_size = 0;
+      for (std::size_t h=0; h<table.size(); ++h)
+        if (table[h].outer != StorageIndex(-1))
+          coeffRef(table[h].outer, table[h].inner) = table[h].value;
+    }
+
+    std::vector<Entry> m_table;
+    Index m_size;
+};
+
+} // end namespace internal
+
+/** \class ConcurrentSparseBuilder
+  *
+  * \brief Assembles a sparse matrix from coefficients accumulated concurrently in random order
+  *
+  * \tparam SparseMatrixType the type of the compressed sparse matrix to build
+  *
+  * Each thread accumulates its coefficients into its own hash table, indexed by the slot of the
+  * calling thread, so that no synchronization is needed during the assembly. Coefficients
+  * added several times, possibly from different threads, are summed up. The tables are then merged
+  * into \a SparseMatrixType by finalize(), in parallel over ranges of inner vectors:
+  *
+  * \code
+  * ConcurrentSparseBuilder<SparseMatrix<double> > builder(rows,cols);
+  * #pragma omp parallel for
+  * for(int e=0; e<elements; ++e)
+  *   for(...)
+  *     builder.add(i,j,v);
+  * SparseMatrix<double> m;
+  * builder.finalize(m);
+  * \endcode
+  *
+  * Without OpenMP, or outside of a parallel region, all coefficients go to the first slot. The slot can
+  * also be given explicitly, e.g., when the assembly is driven by another threading library.
+  *
+  * Compared to RandomSetter, the target matrix is not read back and the hash tables are keyed by (outer,inner)
+  * pairs rather than by packets of inner vectors.
+  *
+  * \sa RandomSetter, SparseMatrix::setFromTriplets()
+  */
+template<typename SparseMatrixType>
+class ConcurrentSparseBuilder
+{
+    typedef typename SparseMatrixType::Scalar Scalar;
+    typedef typename SparseMatrixType::StorageIndex StorageIndex;
+    typedef internal::sparse_coeff_accumulator<Scalar,StorageIndex> Accumulator;
+    typedef typename Accumulator::Entry Entry;
+    enum {
+      IsRowMajor = (SparseMatrixType::Flags & RowMajorBit) ? 1 : 0
+    };
+
+  public:
+
+    /** Constructs a builder for a \a rows x \a cols matrix with \a slots independent accumulators.
+      * The number of slots must be larger than the number of threads adding coefficients. */
+    ConcurrentSparseBuilder(Index rows, Index cols, Index slots = Eigen::nbThreads())
+      : m_rows(rows), m_cols(cols), m_locals(slots)
+    {
+      eigen_assert(slots > 0);
+    }
+
+    /** \returns a reference to the coefficient (\a row,\a col) in the accumulator of the calling thread.
+      *
+      * \warning The reference is invalidated by the next insertion from the same thread. */
+    Scalar& coeffRef(Index row, Index col)
+    {
+      return coeffRef(row, col, currentSlot());
+    }
+
+    /** \returns a reference to the coefficient (\a row,\a col) in the accumulator \a slot */
+    Scalar& coeffRef(Index row, Index col, Index slot)
+    {
+      eigen_assert(row>=0 && row<m_rows && col>=0 && col<m_cols);
+      eigen_assert(slot>=0 && slot<slots() && "the number of slots is smaller than the number of threads");
+      return m_locals[slot].coeffRef(internal::convert_index<StorageIndex>(IsRowMajor ? row : col),
+                                     internal::convert_index<StorageIndex>(IsRowMajor ? col : row));
+    }
+
+    /** Adds \a value to the coefficient (\a row,\a col) */
+    void add(Index row, Index col, const Scalar& value)
+    {
+      coeffRef(row, col) += value;
+    }
+
+    /** Preallocates room for \a reserveSize coefficients in each slot */
+    void reserve(Index reserveSize)
+    {
+      for (Index k=0; k<slots(); ++k)
+        m_locals[k].reserve(reserveSize);
+    }
+
+    Index rows() const { return m_rows; }
+    Index cols() const { return m_cols; }
+    Index slots() const { return static_cast<Index>(m_locals.size()); }
+
+    /** \returns the number of accumulated coefficients. Coefficients accumulated in several slots
+      * are counted several times, so this is an upper bound of the number of non zeros of the result. */
+    Index nonZeros() const
+    {
+      Index nz = 0;
+      for (Index k=0; k<slots(); ++k)
+        nz += m_locals[k].size();
+      return nz;
+    }
+
+    /** Merges the accumulated coefficients into \a dst, and resets the builder. */
+    void finalize(SparseMatrixType& dst);
+
+  protected:
+    static Index currentSlot()
+    {
+#ifdef EIGEN_HAS_OPENMP
+      return omp_get_thread_num();
+#else
+      return 0;
+#endif
+    }
+
+    /** \internal \returns the first entry of the sorted range [first,last) whose outer index is not less than \a outer */
+    static const Entry* lowerBound(const Entry* first, const Entry* last, StorageIndex outer)
+    {
+      Index count = last - first;
+      while (count > 0)
+      {
+        Index step = count / 2;
+        if (first[step].outer < outer)
+        {
+          first += step + 1;
+          count -= step + 1;
+        }
+        else
+          count = step;
+      }
+      return first;
+    }
+
+    Index m_rows;
+    Index m_cols;
+    std::vector<Accumulator> m_locals;
+};
+
+template<typename SparseMatrixType>
+void ConcurrentSparseBuilder<SparseMatrixType>::finalize(SparseMatrixType& dst)
+{
+  const Index outerSize = IsRowMajor ? m_rows : m_cols;
+  const Index nbSlots = slots();
+
+  // 1 - sort the content of each slot by outer then inner index
+  std::vector<std::vector<Entry> > sorted(nbSlots);
+#ifdef EIGEN_HAS_OPENMP
+  Eigen::initParallel();
+  Index threads = Eigen::nbThreads();
+  #pragma omp parallel for schedule(dynamic,1) num_threads(threads) if(threads>1 && nbSlots>1)
+#endif
+  for (Index k=0; k<nbSlots; ++k)
+    m_locals[k].extractSorted(sorted[k], outerSize, IsRowMajor ? m_cols : m_rows);
+
+  // 2 - merge the slots independently over ranges of inner vectors, summing up the duplicates
+  Index nbChunks = 1;
+#ifdef EIGEN_HAS_OPENMP
+  Index totalSize = 0;
+  for (Index k=0; k<nbSlots; ++k)
+    totalSize += static_cast<Index>(sorted[k].size());
+  if (threads>1 && totalSize > 20000)
+    nbChunks = (std::min)(outerSize, 4*threads);
+#endif
+  nbChunks = (std::max)(nbChunks, Index(1));
+  std::vector<std::vector<StorageIndex> > chunkInner(nbChunks);
+  std::vector<std::vector<Scalar> > chunkValues(nbChunks);
+  std::vector<StorageIndex> counts(outerSize+1, 0);
+
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for schedule(dynamic,1) num_threads(threads) if(nbChunks>1)
+#endif
+  for (Index c=0; c<nbChunks; ++c)
+  {
+    const StorageIndex begin = internal::convert_index<StorageIndex>((outerSize * c) / nbChunks);
+    const StorageIndex end = internal::convert_index<StorageIndex>((outerSize * (c+1)) / nbChunks);
+    std::vector<const Entry*> cursors(nbSlots), stops(nbSlots);
+    for (Index k=0; k<nbSlots; ++k)
+    {
+      const Entry* first = sorted[k].empty() ? 0 : &sorted[k][0];
+      const Entry* last = first + sorted[k].size();
+      cursors[k] = lowerBound(first, last, begin);
+      stops[k] = lowerBound(cursors[k], last, end);
+    }
+
+    std::vector<Entry> column;
+    for (StorageIndex j=begin; j<end; ++j)
+    {
+      column.clear();
+      Index nbSources = 0;
+      for (Index k=0; k<nbSlots; ++k)
+      {
+        const Entry* start = cursors[k];
+        while (cursors[k]!=stops[k] && cursors[k]->outer==j)
+          column.push_back(*cursors[k]++);
+        nbSources += (cursors[k]!=start) ? 1 : 0;
+      }
+      if (nbSources>1)
+        std::sort(column.begin(), column.end());
+
+      Index nnz = 0;
+      for (std::size_t i=0; i<column.size(); ++i)
+      {
+        if (nnz>0 && chunkInner[c].back()==column[i].inner)
+        {
+          chunkValues[c].back() += column[i].value;
+          continue;
+        }
+        chunkInner[c].push_back(column[i].inner);
+        chunkValues[c].push_back(column[i].value);
+        ++nnz;
+      }
+      counts[j] = internal::convert_index<StorageIndex>(nnz);
+    }
+  }
+  std::vector<std::vector<Entry> >().swap(sorted);
+
+  // 3 - build the outer index and copy the merged chunks to their final place
+  dst.resize(m_rows, m_cols);
+  dst.makeCompressed();
+  StorageIndex count = 0;
+  for (Index j=0; j<outerSize; ++j)
+  {
+    StorageIndex tmp = counts[j];
+    dst.outerIndexPtr()[j] = count;
+    count += tmp;
+  }
+  dst.outerIndexPtr()[outerSize] = count;
+  dst.resizeNonZeros(count);
+
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for schedule(dynamic,1) num_threads(threads) if(nbChunks>1)
+#endif
+  for (Index c=0; c<nbChunks; ++c)
+  {
+    const Index begin = (outerSize * c) / nbChunks;
+    const Index offset = dst.outerIndexPtr()[begin];
+    std::copy(chunkInner[c].begin(), chunkInner[c].end(), dst.innerIndexPtr()+offset);
+    std::copy(chunkValues[c].begin(), chunkValues[c].end(), dst.valuePtr()+offset);
+  }
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_CONCURRENT_SPARSE_BUILDER_H
@@ -0,0 +1,204 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SPARSE_SCATTER_MAP_H
+#define EIGEN_SPARSE_SCATTER_MAP_H
+
+namespace Eigen {
+
+/** \class SparseScatterMap
+  *
+  * \brief Precomputed scatter map from element-local coefficients to the values of a sparse matrix with a fixed pattern
+  *
+  * \tparam SparseMatrixType the type of the sparse matrix being re-assembled
+  *
+  * Finite element like assemblies repeatedly add small dense matrices, whose rows and columns are given by lists
+  * of global indices, into a matrix whose sparsity pattern does not change. Using coeffRef() for that costs a binary
+  * search per coefficient. This class performs the searches once: each element registered with addElement()
+  * stores the offsets of its coefficients in the value array of the pattern, so that scatterAdd() is a single
+  * pass over the element values.
+  *
+  * The elements are also greedily colored so that two elements of the same color never write to the same
+  * coefficient. Elements of one color can thus be scattered concurrently without atomics:
+  *
+  * \code
+  * SparseScatterMap<SparseMatrix<double> > map(A);
+  * for(int e=0; e<nbElements; ++e)
+  *   map.addElement(dofs[e], dofs[e]);
+  * map.computeColoring();
+  * // at each time step:
+  * A.coeffs().setZero();
+  * for(Index c=0; c<map.colors(); ++c)
+  * {
+  *   const std::vector<Index>& elements = map.elementsOfColor(c);
+  *   #pragma omp parallel for
+  *   for(int k=0; k<int(elements.size()); ++k)
+  *     map.scatterAdd(elements[k], localMatrix(elements[k]), A);
+  * }
+  * \endcode
+  *
+  * assemble() implements this loop for a functor computing the element matrices.
+  *
+  * \warning The matrix passed to scatterAdd() must have the same sparsity pattern and storage layout as the one
+  * given to the constructor: neither insertions nor makeCompressed() are allowed in between.
+  */
+template<typename SparseMatrixType>
+class SparseScatterMap
+{
+  public:
+    typedef typename SparseMatrixType::Scalar Scalar;
+    typedef typename SparseMatrixType::StorageIndex StorageIndex;
+    typedef Matrix<Scalar,Dynamic,Dynamic> ElementMatrixType;
+
+    /** Creates an empty scatter map for the pattern of \a pattern */
+    explicit SparseScatterMap(const SparseMatrixType& pattern)
+      : m_pattern(pattern), m_colorsComputed(false)
+    {
+      m_elementStart.push_back(0);
+    }
+
+    /** Registers an element whose local matrix maps to the rows \a rows and the columns \a cols.
+      * The local coefficient (i,j) is added to the coefficient (rows[i],cols[j]) of the matrix.
+      * All these coefficients must be part of the pattern.
+      * \returns the index of the new element */
+    template<typename RowIndices, typename ColIndices>
+    Index addElement(const RowIndices& rows, const ColIndices& cols)
+    {
+      const Index nbRows = static_cast<Index>(rows.size());
+      const Index nbCols = static_cast<Index>(cols.size());
+      m_elementRows.push_back(internal::convert_index<StorageIndex>(nbRows));
+      for (Index j=0; j<nbCols; ++j)
+        for (Index i=0; i<nbRows; ++i)
+          m_offsets.push_back(findOffset(rows[i], cols[j]));
+      m_elementStart.push_back(static_cast<Index>(m_offsets.size()));
+      m_colorsComputed = false;
+      return elements()-1;
+    }
+
+    /** \returns the number of registered elements */
+    Index elements() const { return static_cast<Index>(m_elementRows.size()); }
+
+    /** Adds the coefficients of \a local to \a dst, according to the indices of the element \a element */
+    template<typename Derived>
+    void scatterAdd(Index element, const MatrixBase<Derived>& local, SparseMatrixType& dst) const
+    {
+      eigen_assert(element>=0 && element<elements());
+      eigen_assert(local.rows()==m_elementRows[element] && local.size()==m_elementStart[element+1]-m_elementStart[element]);
+      const StorageIndex* offsets = &m_offsets[0] + m_elementStart[element];
+      Scalar* values = dst.valuePtr();
+      const Index nbRows = local.rows();
+      for (Index j=0; j<local.cols(); ++j)
+        for (Index i=0; i<nbRows; ++i)
+          values[offsets[i+j*nbRows]] += local.coeff(i,j);
+    }
+
+    /** Partitions the elements into colors, such that the elements of a given color do not share any coefficient. */
+    void computeColoring()
+    {
+      const Index nbElements = elements();
+      const Index nnz = m_pattern.outerIndexPtr()[m_pattern.outerSize()];
+      std::vector<Index> lastColor(nnz, -1);
+      std::vector<bool> colored(nbElements, false);
+      m_colors.clear();
+      Index remaining = nbElements;
+      // One pass per color: an element gets the current color if none of its coefficients has already been
+      // taken by this color.
+      for (Index c=0; remaining>0; ++c)
+      {
+        m_colors.push_back(std::vector<Index>());
+        for (Index e=0; e<nbElements; ++e)
+        {
+          if (colored[e])
+            continue;
+          bool conflict = false;
+          for (Index k=m_elementStart[e]; k<m_elementStart[e+1] && !conflict; ++k)
+            conflict = lastColor[m_offsets[k]]==c;
+          if (conflict)
+            continue;
+          for (Index k=m_elementStart[e]; k<m_elementStart[e+1]; ++k)
+            lastColor[m_offsets[k]] = c;
+          colored[e] = true;
+          m_colors.back().push_back(e);
+          --remaining;
+        }
+      }
+      m_colorsComputed = true;
+    }
+
+    /** \returns the number of colors computed by computeColoring() */
+    Index colors() const
+    {
+      eigen_assert(m_colorsComputed && "computeColoring() must be called first");
+      return static_cast<Index>(m_colors.size());
+    }
+
+    /** \returns the elements of color \a color */
+    const std::vector<Index>& elementsOfColor(Index color) const
+    {
+      eigen_assert(m_colorsComputed && "computeColoring() must be called first");
+      return m_colors[color];
+    }
+
+    /** Re-assembles \a dst from scratch: its values are set to zero, then the element matrices are added.
+      *
+      * \a func(e, local) must fill \a local, of type ElementMatrixType, with the matrix of the element \a e.
+      * It is called concurrently for the elements of the same color when OpenMP is enabled. */
+    template<typename ElementFunctor>
+    void assemble(SparseMatrixType& dst, const ElementFunctor& func) const
+    {
+      eigen_assert(m_colorsComputed && "computeColoring() must be called first");
+      std::fill(dst.valuePtr(), dst.valuePtr() + m_pattern.outerIndexPtr()[m_pattern.outerSize()], Scalar(0));
+#ifdef EIGEN_HAS_OPENMP
+      Eigen::initParallel();
+      Index threads = Eigen::nbThreads();
+#endif
+      for (std::size_t c=0; c<m_colors.size(); ++c)
+      {
+        const std::vector<Index>& colorElements = m_colors[c];
+        const Index nbElements = static_cast<Index>(colorElements.size());
+#ifdef EIGEN_HAS_OPENMP
+        #pragma omp parallel num_threads(threads) if(threads>1 && nbElements>1)
+#endif
+        {
+          ElementMatrixType local;
+#ifdef EIGEN_HAS_OPENMP
+          #pragma omp for schedule(dynamic,16)
+#endif
+          for (Index k=0; k<nbElements; ++k)
+          {
+            func(colorElements[k], local);
+            scatterAdd(colorElements[k], local, dst);
+          }
+        }
+      }
+    }
+
+  protected:
+    StorageIndex findOffset(Index row, Index col) const
+    {
+      const Index outer = SparseMatrixType::IsRowMajor ? row : col;
+      const Index inner = SparseMatrixType::IsRowMajor ? col : row;
+      const StorageIndex* start = m_pattern.innerIndexPtr() + m_pattern.outerIndexPtr()[outer];
+      const StorageIndex* end = m_pattern.isCompressed() ? m_pattern.innerIndexPtr() + m_pattern.outerIndexPtr()[outer+1]
+                                                          : start + m_pattern.innerNonZeroPtr()[outer];
+      const StorageIndex* it = std::lower_bound(start, end, internal::convert_index<StorageIndex>(inner));
+      eigen_assert(it!=end && *it==inner && "the coefficient is not part of the pattern");
+      return internal::convert_index<StorageIndex>(it - m_pattern.innerIndexPtr());
+    }
+
+    const SparseMatrixType& m_pattern;
+    std::vector<StorageIndex> m_offsets;
+    std::vector<Index> m_elementStart;
+    std::vector<StorageIndex> m_elementRows;
+    std::vector<std::vector<Index> > m_colors;
+    bool m_colorsComputed;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_SPARSE_SCATTER_MAP_H
@@ -0,0 +1,478 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_GENERIC_SPECIALFUNCTIONS_H
+#define EIGEN_GENERIC_SPECIALFUNCTIONS_H
+
+/* Packet (SIMD) versions of some of the special functions implemented in
+ * SpecialFunctionsImpl.h. The approximations are the same Cephes ones as the
+ * scalar versions, but all branches are evaluated and blended with bit masks,
+ * and the data dependent loops of the scalar code are replaced by a fixed
+ * number of masked iterations.
+ *
+ * The functions in this file are generic: they only require the usual packet
+ * primitives (arithmetic, pcmp_*, pselect, pfloor, plog, psqrt). Each
+ * architecture opts in by specializing plgamma, pdigamma, pi0e and pi1e for its
+ * packet types, and by setting the corresponding Has* packet traits.
+ */
+
+namespace Eigen {
+namespace internal {
+
+/** \internal Evaluates the polynomial of degree N whose coefficients are stored
+  * in decreasing order in \a coef, see cephes::polevl. */
+template <typename Packet, int N>
+struct ppolevl {
+  static EIGEN_STRONG_INLINE Packet run(const Packet& x, const typename unpacket_traits<Packet>::type coef[]) {
+    EIGEN_STATIC_ASSERT((N > 0), YOU_MADE_A_PROGRAMMING_MISTAKE);
+    return pmadd(ppolevl<Packet, N-1>::run(x, coef), x, pset1<Packet>(coef[N]));
+  }
+};
+
+template <typename Packet>
+struct ppolevl<Packet, 0> {
+  static EIGEN_STRONG_INLINE Packet run(const Packet&, const typename unpacket_traits<Packet>::type coef[]) {
+    return pset1<Packet>(coef[0]);
+  }
+};
+
+/** \internal Evaluates the Chebyshev series with N coefficients \a coef at
+  * \a x, see cephes::chebevl. */
+template <typename Packet, int N>
+struct pchebevl {
+  static EIGEN_STRONG_INLINE Packet run(const Packet& x, const typename unpacket_traits<Packet>::type coef[]) {
+    typedef typename unpacket_traits<Packet>::type Scalar;
+    Packet b0 = pset1<Packet>(coef[0]);
+    Packet b1 = pset1<Packet>(Scalar(0));
+    Packet b2 = b1;
+
+    for (int i = 1; i < N; i++) {
+      b2 = b1;
+      b1 = b0;
+      b0 = padd(psub(pmul(x, b1), b2), pset1<Packet>(coef[i]));
+    }
+
+    return pmul(pset1<Packet>(Scalar(0.5)), psub(b0, b2));
+  }
+};
+
+// floor(x) which is also valid for large inputs, for which some pfloor
+// implementations (e.g., SSE2) overflow their integer conversion. Floats of
+// magnitude 2^23 or more are integers already.
+template <typename Packet>
+EIGEN_STRONG_INLINE Packet pfloor_large_float(const Packet& x) {
+  const Packet cst_2p23 = pset1<Packet>(8388608.0f);
+  return pselect(pcmp_lt(pabs(x), cst_2p23), pfloor(x), x);
+}
+
+// \returns whether any coefficient of the bit mask \a mask is set. This is
+// used to skip the evaluation of rarely taken branches.
+template <typename Packet>
+EIGEN_STRONG_INLINE bool pany_float(const Packet& mask) {
+  return predux_max(pand(mask, pset1<Packet>(1.0f))) != 0.0f;
+}
+
+// Natural logarithm which, contrary to plog_float, does not clamp denormal
+// inputs to the smallest normalized float.
+template <typename Packet>
+EIGEN_STRONG_INLINE Packet plog_denorm_float(const Packet& x) {
+  const Packet cst_min_norm_pos = pset1frombits<Packet>(0x00800000u);
+  const Packet cst_2p24         = pset1<Packet>(16777216.0f);
+  const Packet cst_24_ln2       = pset1<Packet>(16.6355323334f);
+  const Packet cst_zero         = pset1<Packet>(0.0f);
+  Packet denorm_mask = pandnot(pcmp_lt(x, cst_min_norm_pos), pcmp_le(x, cst_zero));
+  Packet y = plog(pselect(denorm_mask, pmul(x, cst_2p24), x));
+  return psub(y, pand(denorm_mask, cst_24_ln2));
+}
+
+// Computes sin(pi*x) and cos(pi*x) for x in [-0.5, 0.5] using the Cephes
+// sinf/cosf polynomials on [-pi/4, pi/4]. cos(pi*x) is exactly zero for
+// |x| = 0.5.
+template <typename Packet>
+EIGEN_STRONG_INLINE void psincospi_float(const Packet& x, Packet& s, Packet& c) {
+  const Packet cst_pi       = pset1<Packet>(3.14159265358979323846f);
+  const Packet cst_quarter  = pset1<Packet>(0.25f);
+  const Packet cst_half     = pset1<Packet>(0.5f);
+  const Packet cst_1        = pset1<Packet>(1.0f);
+  const Packet cst_sign     = pset1frombits<Packet>(0x80000000u);
+  const Packet cst_sin_p0   = pset1<Packet>(-1.9515295891E-4f);
+  const Packet cst_sin_p1   = pset1<Packet>( 8.3321608736E-3f);
+  const Packet cst_sin_p2   = pset1<Packet>(-1.6666654611E-1f);
+  const Packet cst_cos_p0   = pset1<Packet>( 2.443315711809948E-005f);
+  const Packet cst_cos_p1   = pset1<Packet>(-1.388731625493765E-003f);
+  const Packet cst_cos_p2   = pset1<Packet>( 4.166664568298827E-002f);
+
+  Packet a = pabs(x);
+  // Use cos(pi*a) = sin(pi*(1/2-a)) for a > 1/4, and vice versa.
+  Packet swap_mask = pcmp_lt(cst_quarter, a);
+  Packet t = pmul(cst_pi, pselect(swap_mask, psub(cst_half, a), a));
+  Packet t2 = pmul(t, t);
+
+  Packet ps = pmadd(cst_sin_p0, t2, cst_sin_p1);
+  ps = pmadd(ps, t2, cst_sin_p2);
+  ps = pmadd(pmul(ps, t2), t, t);
+
+  Packet pc = pmadd(cst_cos_p0, t2, cst_cos_p1);
+  pc = pmadd(pc, t2, cst_cos_p2);
+  pc = pmadd(pmul(pc, t2), t2, psub(cst_1, pmul(cst_half, t2)));
+
+  s = pxor(pselect(swap_mask, pc, ps), pand(x, cst_sign));
+  c = pselect(swap_mask, ps, pc);
+}
+
+// lgamma(x) for x >= 0 (and NaN), following Cephes' lgamf:
+//  - for x >= 6.5, Stirling's formula with a rational correction,
+//  - otherwise, x is shifted into [1.5, 2.5] with the recurrence
+//    Gamma(x+1) = x Gamma(x) and a polynomial for lgamma(x+2) is used.
+// The shifts are performed with a fixed number of masked iterations, and the
+// logarithms of both branches are folded into a single call to plog.
+template <typename Packet>
+EIGEN_STRONG_INLINE Packet plgamma_positive_float(const Packet& x) {
+  const float B[] = {
+     6.055172732649237E-004f,
+    -1.311620815545743E-003f,
+     2.863437556468661E-003f,
+    -7.366775108654962E-003f,
+     2.058355474821512E-002f,
+    -6.735323259371034E-002f,
+     3.224669577325661E-001f,
+     4.227843421859038E-001f
+  };
+  const Packet cst_half       = pset1<Packet>(0.5f);
+  const Packet cst_1          = pset1<Packet>(1.0f);
+  const Packet cst_1_5        = pset1<Packet>(1.5f);
+  const Packet cst_2          = pset1<Packet>(2.0f);
+  const Packet cst_2_5        = pset1<Packet>(2.5f);
+  const Packet cst_6_5        = pset1<Packet>(6.5f);
+  // log(sqrt(2*pi)) - 1/2
+  const Packet cst_ls2pi_half = pset1<Packet>(0.41893853320467274178f);
+  const Packet cst_stirling_0 = pset1<Packet>( 6.789774945028216E-004f);
+  const Packet cst_stirling_1 = pset1<Packet>(-2.769887652139868E-003f);
+  const Packet cst_stirling_2 = pset1<Packet>( 8.333316229807355E-002f);
+
+  Packet small_mask = pcmp_lt(x, cst_6_5);
+
+  // Shift down: t = x - k in [1.5, 2.5], z = (x-1)...(x-k), with k <= 4.
+  // The signed shift n = t - x is tracked separately since t is inexact when
+  // shifting up.
+  Packet t = x;
+  Packet n = pzero(x);
+  Packet z = cst_1;
+  for (int i = 0; i < 4; ++i) {
+    Packet m = pand(small_mask, pcmp_lt(cst_2_5, t));
+    t = psub(t, pand(m, cst_1));
+    n = psub(n, pand(m, cst_1));
+    z = pselect(m, pmul(z, t), z);
+  }
+  // Shift up: t = x + k in [1.5, 2.5), z = x...(x+k-1), with k <= 2.
+  Packet up_mask = pcmp_lt(x, cst_1_5);
+  Packet zu = cst_1;
+  for (int i = 0; i < 2; ++i) {
+    Packet m = pcmp_lt(t, cst_1_5);
+    zu = pselect(m, pmul(zu, t), zu);
+    t = padd(t, pand(m, cst_1));
+    n = padd(n, pand(m, cst_1));
+  }
+
+  Packet logv = plog_denorm_float(pselect(small_mask, pselect(up_mask, zu, z), x));
+
+  // Small arguments. r = t - 2 is computed from x to remain exact close to
+  // the roots at x = 1 and x = 2.
+  Packet r = psub(x, psub(cst_2, n));
+  Packet res_small = pmul(r, ppolevl<Packet, 7>::run(r, B));
+  res_small = padd(res_small, pselect(up_mask, pnegate(logv), logv));
+
+  // Large arguments: (x-1/2)*log(x) - x + log(sqrt(2pi)) + correction, written
+  // so that x = +inf does not produce inf - inf.
+  Packet inv_x = pdiv(cst_1, x);
+  Packet p = pmul(inv_x, inv_x);
+  Packet corr = pmadd(pmadd(cst_stirling_0, p, cst_stirling_1), p, cst_stirling_2);
+  corr = pmul(corr, inv_x);
+  Packet res_large = pmadd(psub(x, cst_half), psub(logv, cst_1), cst_ls2pi_half);
+  res_large = padd(res_large, corr);
+
+  return pselect(small_mask, res_small, res_large);
+}
+
+/** \internal \returns lgamma(\a _x) for a packet of floats.
+  * Negative arguments use the reflection formula
+  *   lgamma(-q) = -log(q*sin(pi*q)/pi) - lgamma(q),
+  * and non-positive integers give +inf. */
+template <typename Packet>
+EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+EIGEN_UNUSED
+Packet plgamma_float(const Packet _x)
+{
+  const Packet cst_zero   = pset1<Packet>(0.0f);
+  const Packet cst_half   = pset1<Packet>(0.5f);
+  const Packet cst_1      = pset1<Packet>(1.0f);
+  const Packet cst_inv_pi = pset1<Packet>(0.318309886183790671538f);
+  const Packet cst_inf    = pset1<Packet>(NumTraits<float>::infinity());
+
+  Packet q = pabs(_x);
+  Packet w = plgamma_positive_float(q);
+
+  Packet neg_mask = pcmp_lt(_x, cst_zero);
+  if (!pany_float(neg_mask)) return w;
+
+  // Reflection for negative arguments.
+  Packet p = pfloor_large_float(q);
+  Packet pole_mask = pcmp_eq(p, q);
+  Packet zf = psub(q, p);
+  zf = pselect(pcmp_lt(cst_half, zf), psub(padd(p, cst_1), q), zf);
+  Packet s, c;
+  psincospi_float(zf, s, c);
+  // log(q) and log(sin(pi*zf)/pi) are taken separately since their product
+  // underflows for tiny q.
+  Packet refl = padd(plog_denorm_float(q), plog_denorm_float(pmul(s, cst_inv_pi)));
+  refl = psub(pnegate(refl), w);
+  refl = pselect(pole_mask, cst_inf, refl);
+
+  return pselect(neg_mask, refl, w);
+}
+
+/** \internal \returns digamma(\a _x) for a packet of floats.
+  * This follows digamma_impl: negative arguments use the reflection formula
+  *   psi(1-x) = psi(x) + pi/tan(pi*x),
+  * the argument is then shifted above 10 using psi(x+1) = psi(x) + 1/x, and
+  * the asymptotic expansion is applied. The sum of 1/x terms is accumulated as
+  * a single fraction so that only one division is needed. */
+template <typename Packet>
+EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+EIGEN_UNUSED
+Packet pdigamma_float(const Packet _x)
+{
+  const float A[] = {
+    -4.16666666666666666667E-3f,
+     3.96825396825396825397E-3f,
+    -8.33333333333333333333E-3f,
+     8.33333333333333333333E-2f
+  };
+  const Packet cst_zero = pset1<Packet>(0.0f);
+  const Packet cst_half = pset1<Packet>(0.5f);
+  const Packet cst_1    = pset1<Packet>(1.0f);
+  const Packet cst_10   = pset1<Packet>(10.0f);
+  const Packet cst_pi   = pset1<Packet>(3.14159265358979323846f);
+  const Packet cst_inf  = pset1<Packet>(NumTraits<float>::infinity());
+
+  Packet x = _x;
+  Packet neg_mask = pcmp_le(x, cst_zero);
+  bool any_neg = pany_float(neg_mask);
+
+  // Reflection term pi/tan(pi*nz), with nz the signed distance of x to the
+  // closest integer. It is exactly zero for half integers.
+  Packet refl = cst_zero;
+  Packet pole_mask = cst_zero;
+  if (any_neg) {
+    Packet p = pfloor_large_float(x);
+    pole_mask = pand(neg_mask, pcmp_eq(p, x));
+    Packet nz = psub(x, p);
+    nz = pselect(pcmp_lt(cst_half, nz), psub(x, padd(p, cst_1)), nz);
+    Packet s, c;
+    psincospi_float(nz, s, c);
+    refl = pdiv(pmul(cst_pi, c), s);
+    x = pselect(neg_mask, psub(cst_1, x), x);
+  }
+
+  // Use the recurrence psi(x+1) = psi(x) + 1/x until x >= 10, with
+  // w = num/den = sum of the 1/x terms.
+  Packet num = cst_zero;
+  Packet den = cst_1;
+  for (int i = 0; i < 10; ++i) {
+    Packet m = pcmp_lt(x, cst_10);
+    num = pselect(m, pmadd(num, x, den), num);
+    den = pselect(m, pmul(den, x), den);
+    x = padd(x, pand(m, cst_1));
+  }
+  Packet w = pdiv(num, den);
+
+  Packet inv_x = pdiv(cst_1, x);
+  Packet z = pmul(inv_x, inv_x);
+  Packet y = pmul(z, ppolevl<Packet, 3>::run(z, A));
+  y = psub(psub(psub(plog(x), pmul(cst_half, inv_x)), y), w);
+  // plog does not handle +inf.
+  y = pselect(pcmp_eq(x, cst_inf), cst_inf, y);
+
+  if (any_neg) {
+    y = pselect(neg_mask, psub(y, refl), y);
+    y = pselect(pole_mask, cst_inf, y);
+  }
+  return y;
+}
+
+/** \internal \returns the exponentially scaled modified Bessel function of
+  * order zero i0e(\a _x), see i0e_impl. Both Chebyshev expansions are
+  * evaluated and the result is selected per coefficient. */
+template <typename Packet>
+EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+EIGEN_UNUSED
+Packet pi0e_float(const Packet _x)
+{
+  const float A[] = {-1.30002500998624804212E-8f, 6.04699502254191894932E-8f,
+                     -2.67079385394061173391E-7f, 1.11738753912010371815E-6f,
+                     -4.41673835845875056359E-6f, 1.64484480707288970893E-5f,
+                     -5.75419501008210370398E-5f, 1.88502885095841655729E-4f,
+                     -5.76375574538582365885E-4f, 1.63947561694133579842E-3f,
+                     -4.32430999505057594430E-3f, 1.05464603945949983183E-2f,
+                     -2.37374148058994688156E-2f, 4.93052842396707084878E-2f,
+                     -9.49010970480476444210E-2f, 1.71620901522208775349E-1f,
+                     -3.04682672343198398683E-1f, 6.76795274409476084995E-1f};
+  const float B[] = {3.39623202570838634515E-9f, 2.26666899049817806459E-8f,
+                     2.04891858946906374183E-7f, 2.89137052083475648297E-6f,
+                     6.88975834691682398426E-5f, 3.36911647825569408990E-3f,
+                     8.04490411014108831608E-1f};
+  const Packet cst_half = pset1<Packet>(0.5f);
+  const Packet cst_2    = pset1<Packet>(2.0f);
+  const Packet cst_8    = pset1<Packet>(8.0f);
+  const Packet cst_32   = pset1<Packet>(32.0f);
+  const Packet cst_inf  = pset1<Packet>(NumTraits<float>::infinity());
+
+  Packet x = pabs(_x);
+  Packet y_small = pchebevl<Packet, 18>::run(pmadd(cst_half, x, pnegate(cst_2)), A);
+  Packet y_large = pchebevl<Packet, 7>::run(psub(pdiv(cst_32, x), cst_2), B);
+  // The fast psqrt implementations return NaN for +inf.
+  y_large = pandnot(pdiv(y_large, psqrt(x)), pcmp_eq(x, cst_inf));
+  return pselect(pcmp_le(x, cst_8), y_small, y_large);
+}
+
+/** \internal \returns the exponentially scaled modified Bessel function of
+  * order one i1e(\a _x), see i1e_impl. */
+template <typename Packet>
+EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+EIGEN_UNUSED
+Packet pi1e_float(const Packet _x)
+{
+  const float A[] = {9.38153738649577178388E-9f, -4.44505912879632808065E-8f,
+                     2.00329475355213526229E-7f, -8.56872026469545474066E-7f,
+                     3.47025130813767847674E-6f, -1.32731636560394358279E-5f,
+                     4.78156510755005422638E-5f, -1.61760815825896745588E-4f,
+                     5.12285956168575772895E-4f, -1.51357245063125314899E-3f,
+                     4.15642294431288815669E-3f, -1.05640848946261981558E-2f,
+                     2.47264490306265168283E-2f, -5.29459812080949914269E-2f,
+                     1.02643658689847095384E-1f, -1.76416518357834055153E-1f,
+                     2.52587186443633654823E-1f};
+  const float B[] = {-3.83538038596423702205E-9f, -2.63146884688951950684E-8f,
+                     -2.51223623787020892529E-7f, -3.88256480887769039346E-6f,
+                     -1.10588938762623716291E-4f, -9.76109749136146840777E-3f,
+                     7.78576235018280120474E-1f};
+  const Packet cst_half = pset1<Packet>(0.5f);
+  const Packet cst_2    = pset1<Packet>(2.0f);
+  const Packet cst_8    = pset1<Packet>(8.0f);
+  const Packet cst_32   = pset1<Packet>(32.0f);
+  const Packet cst_inf  = pset1<Packet>(NumTraits<float>::infinity());
+  const Packet cst_zero = pset1<Packet>(0.0f);
+
+  Packet z = pabs(_x);
+  Packet y_small = pchebevl<Packet, 17>::run(pmadd(cst_half, z, pnegate(cst_2)), A);
+  y_small = pmul(y_small, z);
+  Packet y_large = pchebevl<Packet, 7>::run(psub(pdiv(cst_32, z), cst_2), B);
+  y_large = pandnot(pdiv(y_large, psqrt(z)), pcmp_eq(z, cst_inf));
+  Packet y = pselect(pcmp_le(z, cst_8), y_small, y_large);
+  return pselect(pcmp_lt(_x, cst_zero), pnegate(y), y);
+}
+
+/** \internal \returns i0e(\a _x) for a packet of doubles, see pi0e_float. */
+template <typename Packet>
+EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+EIGEN_UNUSED
+Packet pi0e_double(const Packet _x)
+{
+  const double A[] = {-4.41534164647933937950E-18, 3.33079451882223809783E-17,
+                      -2.43127984654795469359E-16, 1.71539128555513303061E-15,
+                      -1.16853328779934516808E-14, 7.67618549860493561688E-14,
+                      -4.85644678311192946090E-13, 2.95505266312963983461E-12,
+                      -1.72682629144155570723E-11, 9.67580903537323691224E-11,
+                      -5.18979560163526290666E-10, 2.65982372468238665035E-9,
+                      -1.30002500998624804212E-8,  6.04699502254191894932E-8,
+                      -2.67079385394061173391E-7,  1.11738753912010371815E-6,
+                      -4.41673835845875056359E-6,  1.64484480707288970893E-5,
+                      -5.75419501008210370398E-5,  1.88502885095841655729E-4,
+                      -5.76375574538582365885E-4,  1.63947561694133579842E-3,
+                      -4.32430999505057594430E-3,  1.05464603945949983183E-2,
+                      -2.37374148058994688156E-2,  4.93052842396707084878E-2,
+                      -9.49010970480476444210E-2,  1.71620901522208775349E-1,
+                      -3.04682672343198398683E-1,  6.76795274409476084995E-1};
+  const double B[] = {
+      -7.23318048787475395456E-18, -4.83050448594418207126E-18,
+      4.46562142029675999901E-17,  3.46122286769746109310E-17,
+      -2.82762398051658348494E-16, -3.42548561967721913462E-16,
+      1.77256013305652638360E-15,  3.81168066935262242075E-15,
+      -9.55484669882830764870E-15, -4.15056934728722208663E-14,
+      1.54008621752140982691E-14,  3.85277838274214270114E-13,
+      7.18012445138366623367E-13,  -1.79417853150680611778E-12,
+      -1.32158118404477131188E-11, -3.14991652796324136454E-11,
+      1.18891471078464383424E-11,  4.94060238822496958910E-10,
+      3.39623202570838634515E-9,   2.26666899049817806459E-8,
+      2.04891858946906374183E-7,   2.89137052083475648297E-6,
+      6.88975834691682398426E-5,   3.36911647825569408990E-3,
+      8.04490411014108831608E-1};
+  const Packet cst_half = pset1<Packet>(0.5);
+  const Packet cst_2    = pset1<Packet>(2.0);
+  const Packet cst_8    = pset1<Packet>(8.0);
+  const Packet cst_32   = pset1<Packet>(32.0);
+
+  Packet x = pabs(_x);
+  Packet y_small = pchebevl<Packet, 30>::run(pmadd(cst_half, x, pnegate(cst_2)), A);
+  Packet y_large = pchebevl<Packet, 25>::run(psub(pdiv(cst_32, x), cst_2), B);
+  y_large = pdiv(y_large, psqrt(x));
+  return pselect(pcmp_le(x, cst_8), y_small, y_large);
+}
+
+/** \internal \returns i1e(\a _x) for a packet of doubles, see pi1e_float. */
+template <typename Packet>
+EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+EIGEN_UNUSED
+Packet pi1e_double(const Packet _x)
+{
+  const double A[] = {2.77791411276104639959E-18, -2.11142121435816608115E-17,
+                      1.55363195773620046921E-16, -1.10559694773538630805E-15,
+                      7.60068429473540693410E-15, -5.04218550472791168711E-14,
+                      3.22379336594557470981E-13, -1.98397439776494371520E-12,
+                      1.17361862988909016308E-11, -6.66348972350202774223E-11,
+                      3.62559028155211703701E-10, -1.88724975172282928790E-9,
+                      9.38153738649577178388E-9,  -4.44505912879632808065E-8,
+                      2.00329475355213526229E-7,  -8.56872026469545474066E-7,
+                      3.47025130813767847674E-6,  -1.32731636560394358279E-5,
+                      4.78156510755005422638E-5,  -1.61760815825896745588E-4,
+                      5.12285956168575772895E-4,  -1.51357245063125314899E-3,
+                      4.15642294431288815669E-3,  -1.05640848946261981558E-2,
+                      2.47264490306265168283E-2,  -5.29459812080949914269E-2,
+                      1.02643658689847095384E-1,  -1.76416518357834055153E-1,
+                      2.52587186443633654823E-1};
+  const double B[] = {
+      7.51729631084210481353E-18,  4.41434832307170791151E-18,
+      -4.65030536848935832153E-17, -3.20952592199342395980E-17,
+      2.96262899764595013876E-16,  3.30820231092092828324E-16,
+      -1.88035477551078244854E-15, -3.81440307243700780478E-15,
+      1.04202769841288027642E-14,  4.27244001671195135429E-14,
+      -2.10154184277266431302E-14, -4.08355111109219731823E-13,
+      -7.19855177624590851209E-13, 2.03562854414708950722E-12,
+      1.41258074366137813316E-11,  3.25260358301548823856E-11,
+      -1.89749581235054123450E-11, -5.58974346219658380687E-10,
+      -3.83538038596423702205E-9,  -2.63146884688951950684E-8,
+      -2.51223623787020892529E-7,  -3.88256480887769039346E-6,
+      -1.10588938762623716291E-4,  -9.76109749136146840777E-3,
+      7.78576235018280120474E-1};
+  const Packet cst_half = pset1<Packet>(0.5);
+  const Packet cst_2    = pset1<Packet>(2.0);
+  const Packet cst_8    = pset1<Packet>(8.0);
+  const Packet cst_32   = pset1<Packet>(32.0);
+  const Packet cst_zero = pset1<Packet>(0.0);
+
+  Packet z = pabs(_x);
+  Packet y_small = pchebevl<Packet, 29>::run(pmadd(cst_half, z, pnegate(cst_2)), A);
+  y_small = pmul(y_small, z);
+  Packet y_large = pchebevl<Packet, 25>::run(psub(pdiv(cst_32, z), cst_2), B);
+  y_large = pdiv(y_large, psqrt(z));
+  Packet y = pselect(pcmp_le(z, cst_8), y_small, y_large);
+  return pselect(pcmp_lt(_x, cst_zero), pnegate(y), y);
+}
+
+} // end namespace internal
+} // end namespace Eigen
+
+#endif // EIGEN_GENERIC_SPECIALFUNCTIONS_H
@@ -107,8 +107,77 @@ void test_central()
     VERIFY_IS_APPROX(jac, actual_jac);
 }
 
+// Broyden tridiagonal function: f_i depends on x_{i-1}, x_i and x_{i+1}
+template<typename _JacobianType>
+struct tridiagonal_functor : Functor<double>
+{
+    typedef _JacobianType JacobianType;
+    tridiagonal_functor(int n = 50): Functor<double>(n,n) {}
+    int operator()(const VectorXd &x, VectorXd &fvec) const
+    {
+        const int n = values();
+        for (int i = 0; i < n; i++)
+            fvec[i] = (3.-2.*x[i])*x[i] - (i>0 ? x[i-1] : 0.) - 2.*(i<n-1 ? x[i+1] : 0.) + 1.;
+        return 0;
+    }
+
+    void actual_df(const VectorXd &x, MatrixXd &fjac) const
+    {
+        const int n = values();
+        fjac.setZero(n,n);
+        for (int i = 0; i < n; i++)
+        {
+            fjac(i,i) = 3.-4.*x[i];
+            if (i>0) fjac(i,i-1) = -1.;
+            if (i<n-1) fjac(i,i+1) = -2.;
+        }
+    }
+
+    SparseMatrix<double> pattern() const
+    {
+        MatrixXd jac;
+        actual_df(VectorXd::Zero(values()), jac);
+        return jac.sparseView();
+    }
+};
+
+template<typename JacobianType, NumericalDiffMode mode>
+void test_colored(bool parallel)
+{
+    typedef tridiagonal_functor<JacobianType> FunctorType;
+    FunctorType functor;
+    VectorXd x = VectorXd::Random(functor.inputs());
+    MatrixXd actual_jac;
+    functor.actual_df(x, actual_jac);
+
+    NumericalDiff<FunctorType,mode> numDiff(functor);
+    numDiff.setSparsityPattern(functor.pattern());
+    numDiff.setParallel(parallel);
+    // columns j, j+3, j+6... do not share any row
+    VERIFY_IS_EQUAL(numDiff.colors(), 3);
+
+    JacobianType jac(functor.values(), functor.inputs());
+    int nfev = numDiff.df(x, jac);
+    VERIFY_IS_EQUAL(nfev, mode==Forward ? 4 : 6);
+    VERIFY_IS_APPROX(MatrixXd(jac), actual_jac);
+
+    // without pattern, one group per column
+    numDiff.setSparsityPattern(SparseMatrix<double>());
+    VERIFY_IS_EQUAL(numDiff.colors(), 0);
+    MatrixXd dense_jac(functor.values(), functor.inputs());
+    NumericalDiff<tridiagonal_functor<MatrixXd>,mode> denseDiff;
+    denseDiff.setParallel(parallel);
+    nfev = denseDiff.df(x, dense_jac);
+    VERIFY_IS_EQUAL(nfev, mode==Forward ? functor.inputs()+1 : 2*functor.inputs());
+    VERIFY_IS_APPROX(dense_jac, actual_jac);
+}
+
 EIGEN_DECLARE_TEST(NumericalDiff)
 {
     CALL_SUBTEST(test_forward());
     CALL_SUBTEST(test_central());
+    CALL_SUBTEST(( test_colored<MatrixXd,Forward>(false) ));
+    CALL_SUBTEST(( test_colored<MatrixXd,Central>(true) ));
+    CALL_SUBTEST(( test_colored<SparseMatrix<double>,Forward>(true) ));
+    CALL_SUBTEST(( test_colored<SparseMatrix<double>,Central>(false) ));
 }
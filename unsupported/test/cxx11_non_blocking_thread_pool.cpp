@@ -167,6 +167,216 @@ static void test_pool_partitions() {
   phase = 2;
 }
 
+static void test_statistics()
+{
+  const int kThreads = 4;
+  const int kTasks = 1000;
+  ThreadPool tp(kThreads);
+  VERIFY(!tp.StatisticsEnabled());
+
+  // Nothing is counted while statistics are disabled.
+  {
+    Barrier barrier(kTasks);
+    for (int i = 0; i < kTasks; ++i) tp.Schedule([&]() { barrier.Notify(); });
+    barrier.Wait();
+  }
+  ThreadPool::Statistics stats = tp.GetStatistics();
+  VERIFY_IS_EQUAL(stats.workers.size(), static_cast<size_t>(kThreads));
+  VERIFY_IS_EQUAL(stats.Total().tasks_executed, 0u);
+  VERIFY_IS_EQUAL(stats.Total().queue_high_water_mark, 0u);
+
+  tp.EnableStatistics(true);
+  VERIFY(tp.StatisticsEnabled());
+  // Tasks scheduled from the workers themselves, to exercise the local queues.
+  {
+    Barrier barrier(2 * kTasks);
+    for (int i = 0; i < kTasks; ++i) {
+      tp.Schedule([&]() {
+        tp.Schedule([&]() { barrier.Notify(); });
+        barrier.Notify();
+      });
+    }
+    barrier.Wait();
+  }
+  // Let the workers go idle and park.
+  EIGEN_SLEEP(100);
+  stats = tp.GetStatistics();
+  ThreadPool::WorkerStatistics total = stats.Total();
+  VERIFY_IS_EQUAL(total.tasks_executed + stats.tasks_run_inline,
+                  static_cast<uint64_t>(2 * kTasks));
+  VERIFY_GE(total.queue_high_water_mark, 1u);
+  VERIFY_LE(total.queue_high_water_mark, 1024u);
+  VERIFY_GE(total.parks, 1u);
+  VERIFY_GE(total.park_seconds, 0.);
+  VERIFY_LE(total.local_steals + total.global_steals, total.tasks_executed);
+
+  tp.ResetStatistics();
+  stats = tp.GetStatistics();
+  total = stats.Total();
+  VERIFY_IS_EQUAL(total.tasks_executed, 0u);
+  VERIFY_IS_EQUAL(total.local_steals, 0u);
+  VERIFY_IS_EQUAL(total.global_steals, 0u);
+  VERIFY_IS_EQUAL(total.queue_high_water_mark, 0u);
+  VERIFY_IS_EQUAL(stats.tasks_run_inline, 0u);
+
+  {
+    Barrier barrier(10);
+    for (int i = 0; i < 10; ++i) tp.Schedule([&]() { barrier.Notify(); });
+    barrier.Wait();
+  }
+  // A task is counted before it runs, hence before the barrier is notified.
+  VERIFY_IS_EQUAL(tp.GetStatistics().Total().tasks_executed, 10u);
+}
+static void test_spin_policies()
+{
+  const int kThreads = 4;
+  const int kTasks = 500;
+  ThreadPool tp(kThreads);
+  VERIFY_IS_EQUAL(tp.GetSpinPolicy(), ThreadPool::kFixedSpinning);
+  VERIFY_IS_EQUAL(ThreadPool(1, false).GetSpinPolicy(), ThreadPool::kNoSpinning);
+  tp.EnableStatistics(true);
+
+  const ThreadPool::SpinPolicy policies[] = {
+      ThreadPool::kNoSpinning, ThreadPool::kFixedSpinning,
+      ThreadPool::kAdaptiveSpinning};
+  for (ThreadPool::SpinPolicy policy : policies) {
+    tp.SetSpinPolicy(policy);
+    VERIFY_IS_EQUAL(tp.GetSpinPolicy(), policy);
+    tp.ResetStatistics();
+    // Bursts of tasks, separated by idle periods.
+    for (int burst = 0; burst < 4; ++burst) {
+      Barrier barrier(kTasks);
+      for (int i = 0; i < kTasks; ++i) tp.Schedule([&]() { barrier.Notify(); });
+      barrier.Wait();
+      EIGEN_SLEEP(5);
+    }
+    ThreadPool::WorkerStatistics total = tp.GetStatistics().Total();
+    VERIFY_IS_EQUAL(total.tasks_executed + tp.GetStatistics().tasks_run_inline,
+                    static_cast<uint64_t>(4 * kTasks));
+    if (policy == ThreadPool::kNoSpinning) {
+      VERIFY_IS_EQUAL(total.spin_iterations, 0u);
+    } else {
+      VERIFY_GE(total.spin_iterations, 1u);
+    }
+  }
+
+  // A quiesced pool runs its tasks but never spins.
+  tp.Quiesce();
+  VERIFY(tp.Quiesced());
+  tp.ResetStatistics();
+  {
+    Barrier barrier(kTasks);
+    for (int i = 0; i < kTasks; ++i) tp.Schedule([&]() { barrier.Notify(); });
+    barrier.Wait();
+  }
+  EIGEN_SLEEP(20);
+  VERIFY_IS_EQUAL(tp.GetStatistics().Total().spin_iterations, 0u);
+
+  tp.Wake();
+  VERIFY(!tp.Quiesced());
+  {
+    Barrier barrier(kTasks);
+    for (int i = 0; i < kTasks; ++i) tp.Schedule([&]() { barrier.Notify(); });
+    barrier.Wait();
+  }
+}
+static void test_priorities()
+{
+  // A single worker, blocked while the tasks are queued, makes the execution
+  // order deterministic.
+  ThreadPool tp(1);
+  std::atomic<bool> release(false);
+  std::mutex mutex;
+  std::vector<int> order;
+  Barrier started(1);
+  tp.Schedule([&]() {
+    started.Notify();
+    while (!release) {
+    }
+  });
+  started.Wait();
+
+  const int kNormal = 10;
+  const int kHigh = 40;
+  Barrier barrier(kNormal + kHigh);
+  for (int i = 0; i < kNormal; ++i) {
+    tp.Schedule([&, i]() {
+      { std::lock_guard<std::mutex> lock(mutex); order.push_back(i); }
+      barrier.Notify();
+    });
+  }
+  for (int i = 0; i < kHigh; ++i) {
+    tp.ScheduleWithPriority([&, i]() {
+      { std::lock_guard<std::mutex> lock(mutex); order.push_back(kNormal + i); }
+      barrier.Notify();
+    }, ThreadPool::kHighPriority);
+  }
+  release = true;
+  barrier.Wait();
+
+  VERIFY_IS_EQUAL(order.size(), static_cast<size_t>(kNormal + kHigh));
+  // High priority tasks run first, but a normal priority task is run after
+  // each streak of 16 high priority tasks.
+  for (int k = 0; k < 16; ++k) VERIFY_GE(order[k], kNormal);
+  VERIFY_IS_EQUAL(order[16], 0);
+  for (int k = 17; k < 33; ++k) VERIFY_GE(order[k], kNormal);
+  VERIFY_IS_EQUAL(order[33], 1);
+  // Tasks of the same priority run in submission order.
+  int last_normal = -1, last_high = -1;
+  for (int id : order) {
+    int& last = id < kNormal ? last_normal : last_high;
+    VERIFY_GE(id, last);
+    last = id;
+  }
+}
+
+// Records the priorities of the tasks it forwards to a ThreadPool.
+class PriorityRecordingPool : public ThreadPoolInterface {
+ public:
+  explicit PriorityRecordingPool(int num_threads)
+      : pool_(num_threads), normal_(0), high_(0) {}
+
+  void Schedule(std::function<void()> fn) override {
+    normal_++;
+    pool_.Schedule(std::move(fn));
+  }
+  void ScheduleWithPriority(std::function<void()> fn, Priority priority) override {
+    (priority == kHighPriority ? high_ : normal_)++;
+    pool_.ScheduleWithPriority(std::move(fn), priority);
+  }
+  int NumThreads() const override { return pool_.NumThreads(); }
+  int CurrentThreadId() const override { return pool_.CurrentThreadId(); }
+
+  ThreadPool pool_;
+  std::atomic<int> normal_;
+  std::atomic<int> high_;
+};
+
+static void test_device_priority()
+{
+  PriorityRecordingPool pool(4);
+  Eigen::ThreadPoolDevice device(&pool, 4);
+  VERIFY_IS_EQUAL(device.priority(), ThreadPoolInterface::kNormalPriority);
+  Eigen::ThreadPoolDevice high_device(&pool, 4, NULL, ThreadPoolInterface::kHighPriority);
+  VERIFY_IS_EQUAL(high_device.priority(), ThreadPoolInterface::kHighPriority);
+
+  const Index n = 1 << 16;
+  std::vector<float> data(n, 0.f);
+  const auto work = [&](Index first, Index last) {
+    for (Index i = first; i < last; ++i) data[i] += 1.f;
+  };
+  high_device.parallelFor(n, TensorOpCost(4, 4, 100), work);
+  VERIFY_GE(pool.high_.load(), 1);
+  VERIFY_IS_EQUAL(pool.normal_.load(), 0);
+  device.parallelFor(n, TensorOpCost(4, 4, 100), work);
+  VERIFY_GE(pool.normal_.load(), 1);
+  for (Index i = 0; i < n; ++i) VERIFY_IS_EQUAL(data[i], 2.f);
+
+  Eigen::Tensor<float, 1> a(n), b(n);
+  a.setRandom();
+  b.device(high_device) = a * 2.f;
+  for (Index i = 0; i < n; ++i) VERIFY_IS_EQUAL(b(i), a(i) * 2.f);
+}
 
 EIGEN_DECLARE_TEST(cxx11_non_blocking_thread_pool)
 {
@@ -175,4 +385,8 @@ EIGEN_DECLARE_TEST(cxx11_non_blocking_thread_pool)
   CALL_SUBTEST(test_parallelism(false));
   CALL_SUBTEST(test_cancel());
   CALL_SUBTEST(test_pool_partitions());
+  CALL_SUBTEST(test_statistics());
+  CALL_SUBTEST(test_spin_policies());
+  CALL_SUBTEST(test_priorities());
+  CALL_SUBTEST(test_device_priority());
 }
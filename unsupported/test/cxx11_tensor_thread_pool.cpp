@@ -444,6 +444,47 @@ void test_multithreaded_reductions() {
   VERIFY_IS_APPROX(full_redux(), full_redux_tp());
 }
 
+// In deterministic mode, full reductions are bitwise identical whatever the
+// number of threads.
+template<int DataLayout>
+void test_deterministic_reductions() {
+  const int size = internal::random<int>(100000, 300000);
+  Tensor<float, 1, DataLayout> t(size);
+  t.setRandom();
+  Tensor<float, 0, DataLayout> single_threaded;
+  single_threaded = t.sum();
+
+  Tensor<float, 0, DataLayout> reference, sum, maximum, reference_maximum;
+  for (int num_threads = 1; num_threads <= 6; ++num_threads) {
+    ThreadPool thread_pool(num_threads);
+    Eigen::ThreadPoolDevice device(&thread_pool, num_threads);
+    VERIFY(!device.deterministic());
+    device.setDeterministic(true);
+    VERIFY(device.deterministic());
+    sum.device(device) = t.sum();
+    maximum.device(device) = t.maximum();
+    if (num_threads == 1) {
+      reference = sum;
+      reference_maximum = maximum;
+    }
+    VERIFY_IS_EQUAL(sum(), reference());
+    VERIFY_IS_EQUAL(maximum(), reference_maximum());
+    VERIFY_IS_APPROX(sum(), single_threaded());
+  }
+
+  // an empty tensor and a tensor smaller than a block
+  Tensor<float, 1, DataLayout> small(100);
+  small.setRandom();
+  ThreadPool thread_pool(2);
+  Eigen::ThreadPoolDevice device(&thread_pool, 2);
+  device.setDeterministic(true);
+  sum.device(device) = small.sum();
+  Tensor<float, 0, DataLayout> small_sum = small.sum();
+  VERIFY_IS_EQUAL(sum(), small_sum());
+  Tensor<float, 1, DataLayout> empty(0);
+  sum.device(device) = empty.sum();
+  VERIFY_IS_EQUAL(sum(), 0.f);
+}
 
 void test_memcpy() {
 
@@ -513,6 +554,129 @@ void test_threadpool_allocate(TestAllocator* allocator)
   VERIFY_IS_EQUAL(allocator->dealloc_count(), num_allocs);
 }
 
+// A sequence of evaluations with temporaries: forced evaluations, contractions
+// and reductions.
+template <typename Device>
+void evaluate_planned_expressions(const Device& device, const Tensor<float, 2>& a,
+                                  const Tensor<float, 2>& b, const Tensor<float, 2>& c,
+                                  Tensor<float, 2>& product, Tensor<float, 1>& sums) {
+  typedef Tensor<float, 1>::DimensionPair DimPair;
+  Eigen::array<DimPair, 1> dims = {{DimPair(1, 0)}};
+  Eigen::array<int, 1> reduced_dims = {{0}};
+  product.device(device) = (a.contract(b, dims).eval() + 1.f).contract(c, dims);
+  sums.device(device) = (product * 2.f).eval().sum(reduced_dims) + a.contract(b, dims).contract(c, dims).sum(reduced_dims);
+}
+
+template <int NumDims>
+void verify_tensors_approx(const Tensor<float, NumDims>& a, const Tensor<float, NumDims>& b) {
+  VERIFY_IS_APPROX(Map<const VectorXf>(a.data(), a.size()), Map<const VectorXf>(b.data(), b.size()));
+}
+
+void test_memory_planner()
+{
+  const int num_threads = internal::random<int>(2, 6);
+  ThreadPool threads(num_threads);
+  TensorMemoryPlanner planner;
+  Eigen::ThreadPoolDevice device(&threads, num_threads, &planner);
+
+  Tensor<float, 2> a(40, 150), b(150, 120), c(120, 50);
+  a.setRandom();
+  b.setRandom();
+  c.setRandom();
+  Tensor<float, 2> expected_product(40, 50), product(40, 50);
+  Tensor<float, 1> expected_sums(50), sums(50);
+  evaluate_planned_expressions(DefaultDevice(), a, b, c, expected_product, expected_sums);
+
+  planner.startPlanning();
+  evaluate_planned_expressions(device, a, b, c, product, sums);
+  planner.finishPlanning();
+  verify_tensors_approx(product, expected_product);
+
+  // buffers whose lifetimes overlap do not share memory
+  std::vector<TensorMemoryPlanner::Buffer> buffers = planner.buffers();
+  VERIFY(buffers.size() >= 4);
+  size_t total_size = 0;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    total_size += buffers[i].size;
+    VERIFY(buffers[i].first_use < buffers[i].last_use);
+    VERIFY(buffers[i].offset + buffers[i].size <= planner.arenaSize());
+    VERIFY_IS_EQUAL(buffers[i].offset % EIGEN_MAX_ALIGN_BYTES, size_t(0));
+    for (size_t j = 0; j < i; ++j) {
+      const bool alive_together = buffers[i].first_use <= buffers[j].last_use &&
+                                  buffers[j].first_use <= buffers[i].last_use;
+      const bool share_memory = buffers[i].offset < buffers[j].offset + buffers[j].size &&
+                                buffers[j].offset < buffers[i].offset + buffers[i].size;
+      VERIFY(!(alive_together && share_memory));
+    }
+  }
+  VERIFY(planner.arenaSize() < total_size + buffers.size() * 64);
+
+  void* arena = internal::aligned_malloc(planner.arenaSize());
+  planner.setArena(arena);
+  for (int repeat = 0; repeat < 3; ++repeat) {
+    product.setZero();
+    sums.setZero();
+    evaluate_planned_expressions(device, a, b, c, product, sums);
+    VERIFY_IS_EQUAL(planner.heapAllocations(), 0);
+    verify_tensors_approx(product, expected_product);
+    verify_tensors_approx(sums, expected_sums);
+  }
+
+  // the temporaries of another expression fall back to the heap
+  Tensor<float, 2> a2(30, 150), product2(30, 50), expected_product2(30, 50);
+  Tensor<float, 1> sums2(50), expected_sums2(50);
+  a2.setRandom();
+  evaluate_planned_expressions(DefaultDevice(), a2, b, c, expected_product2, expected_sums2);
+  evaluate_planned_expressions(device, a2, b, c, product2, sums2);
+  VERIFY(planner.heapAllocations() > 0);
+  verify_tensors_approx(product2, expected_product2);
+  verify_tensors_approx(sums2, expected_sums2);
+
+  planner.setArena(NULL);
+  internal::aligned_free(arena);
+}
+
+// Tensor expressions evaluated on a ThreadPoolDevice from inside tasks of the
+// same pool: every worker of the pool waits for nested parallel work.
+void test_nested_parallelism()
+{
+  const int num_threads = internal::random<int>(2, 4);
+  ThreadPool threads(num_threads);
+  Eigen::ThreadPoolDevice device(&threads, num_threads);
+
+  typedef Tensor<float, 1>::DimensionPair DimPair;
+  Tensor<float, 2> a(200, 300), b(300, 250);
+  a.setRandom();
+  b.setRandom();
+  Eigen::array<DimPair, 1> dims = {{DimPair(1, 0)}};
+  Tensor<float, 2> expected = a.contract(b, dims);
+
+  const int num_tasks = 2 * num_threads;
+  std::vector<Tensor<float, 2> > products(num_tasks);
+  std::vector<Tensor<float, 1> > vectors(num_tasks);
+  std::vector<Tensor<float, 0> > sums(num_tasks);
+  Barrier done(num_tasks);
+  for (int i = 0; i < num_tasks; ++i) {
+    threads.Schedule([&, i]() {
+      Tensor<float, 1>& v = vectors[i];
+      v.resize(1 << 20);
+      v.device(device) = v.constant(1.0f) * static_cast<float>(i);
+      sums[i].device(device) = v.sum();
+      products[i].resize(200, 250);
+      products[i].device(device) = a.contract(b, dims);
+      done.Notify();
+    });
+  }
+  done.Wait();
+
+  for (int i = 0; i < num_tasks; ++i) {
+    VERIFY_IS_APPROX(sums[i](), static_cast<float>(i) * (1 << 20));
+    for (Index k = 0; k < expected.size(); ++k) {
+      VERIFY_IS_APPROX(products[i].data()[k], expected.data()[k]);
+    }
+  }
+}
+
 EIGEN_DECLARE_TEST(cxx11_tensor_thread_pool)
 {
   CALL_SUBTEST_1(test_multithread_elementwise());
@@ -540,6 +704,8 @@ EIGEN_DECLARE_TEST(cxx11_tensor_thread_pool)
 
   CALL_SUBTEST_7(test_multithreaded_reductions<ColMajor>());
   CALL_SUBTEST_7(test_multithreaded_reductions<RowMajor>());
+  CALL_SUBTEST_7(test_deterministic_reductions<ColMajor>());
+  CALL_SUBTEST_7(test_deterministic_reductions<RowMajor>());
 
   CALL_SUBTEST_7(test_memcpy());
   CALL_SUBTEST_7(test_multithread_random());
@@ -548,4 +714,6 @@ EIGEN_DECLARE_TEST(cxx11_tensor_thread_pool)
   CALL_SUBTEST_7(test_multithread_shuffle<ColMajor>(NULL));
   CALL_SUBTEST_7(test_multithread_shuffle<RowMajor>(&test_allocator));
   CALL_SUBTEST_7(test_threadpool_allocate(&test_allocator));
+  CALL_SUBTEST_7(test_nested_parallelism());
+  CALL_SUBTEST_7(test_memory_planner());
 }
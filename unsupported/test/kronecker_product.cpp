@@ -229,6 +229,20 @@ EIGEN_DECLARE_TEST(kronecker_product)
     sC2 = kroneckerProduct(2*sA,sB);
     dC = kroneckerProduct(2*dA,dB);
     VERIFY_IS_APPROX(MatrixXf(sC2),dC);
+
+    // products with dense matrices, without forming the Kronecker product
+    int nrhs = Eigen::internal::random<int>(1,4);
+    MatrixXf x = MatrixXf::Random(ca*cb, nrhs), y;
+    dC = kroneckerProduct(dA,dB);
+    y = kroneckerProduct(dA,dB) * x;
+    VERIFY_IS_APPROX(y, dC * x);
+    y = kroneckerProduct(sA,sB) * x;
+    VERIFY_IS_APPROX(y, dC * x);
+    y = kroneckerProduct(dA,sB) * x.col(0);
+    VERIFY_IS_APPROX(y, dC * x.col(0));
+    dC = kroneckerProduct(2*dA,dB.transpose());
+    y = kroneckerProduct(2*sA,sB.transpose()) * MatrixXf::Ones(ca*rb, nrhs);
+    VERIFY_IS_APPROX(y, dC * MatrixXf::Ones(ca*rb, nrhs));
   }
 }
 
@@ -239,6 +253,8 @@ EIGEN_DECLARE_TEST(kronecker_product)
 // simply check that for a dense kronecker product, sparse module is not needed
 #include "main.h"
 #include <Eigen/KroneckerProduct>
+#include <Eigen/Cholesky>
+#include <Eigen/LU>
 
 EIGEN_DECLARE_TEST(kronecker_product)
 {
@@ -247,6 +263,33 @@ EIGEN_DECLARE_TEST(kronecker_product)
   b.setRandom();
   c = kroneckerProduct(a,b);
   VERIFY_IS_APPROX(c.block(3,3,3,3), a(1,1)*b);
+
+  for(int i = 0; i < g_repeat; i++)
+  {
+    int na = internal::random<int>(1,20);
+    int nb = internal::random<int>(1,20);
+    int nrhs = internal::random<int>(1,3);
+    MatrixXd A = MatrixXd::Random(na,na), B = MatrixXd::Random(nb,nb);
+    MatrixXd rhs = MatrixXd::Random(na*nb, nrhs);
+    MatrixXd AB = kroneckerProduct(A,B);
+
+    // general factors
+    KroneckerProductSolver<PartialPivLU<MatrixXd> > lu(A, B);
+    VERIFY_IS_EQUAL(lu.rows(), na*nb);
+    MatrixXd x = lu.solve(rhs);
+    VERIFY_IS_APPROX(AB * x, rhs);
+    VERIFY_IS_APPROX(MatrixXd(kroneckerProduct(A,B) * x), rhs);
+
+    // symmetric positive definite factors, with different decompositions
+    A = A * A.transpose() + MatrixXd::Identity(na,na);
+    B = B * B.transpose() + MatrixXd::Identity(nb,nb);
+    AB = kroneckerProduct(A,B);
+    KroneckerProductSolver<LLT<MatrixXd>, LDLT<MatrixXd> > llt;
+    llt.compute(A, B);
+    x = llt.solve(rhs);
+    VERIFY_IS_APPROX(x, AB.llt().solve(rhs));
+    VERIFY_IS_APPROX(llt.decompositionA().reconstructedMatrix(), A);
+  }
 }
 
 #endif
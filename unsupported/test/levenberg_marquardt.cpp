@@ -1445,6 +1445,117 @@ void testNistEckerle4(void)
   VERIFY_IS_APPROX(x[2], 4.5154121844E+02);
 }
 
+// Independent exponential decays y = a_k exp(-b_k t) + c sharing a common offset c,
+// in residual blocks of 5 rows depending on (a_k, b_k, c). An extra parameter, never
+// used by the residuals, makes the jacobian rank deficient when withUnused is set.
+struct sparse_exp_functor : SparseFunctor<double,int>
+{
+    enum { SamplesPerCurve = 20, RowsPerBlock = 5 };
+    sparse_exp_functor(int curves, bool withUnused, bool useBlocks)
+      : SparseFunctor<double,int>(2*curves+1+withUnused, curves*SamplesPerCurve),
+        curves(curves), useBlocks(useBlocks), blocks(values(), inputs())
+    {
+        for (int k = 0; k < curves; ++k)
+            for (int i = 0; i < SamplesPerCurve; i += RowsPerBlock)
+                blocks.addResidualBlock(k*SamplesPerCurve+i, RowsPerBlock, 2*k, 2, 2*curves, 1);
+    }
+    static double t(int i) { return 0.1*i; }
+    double y(int k, int i) const { return (1.+0.1*(k%7))*std::exp(-(0.5+0.01*(k%11))*t(i)) + 0.3; }
+
+    int operator()(const VectorXd &x, VectorXd &fvec) const
+    {
+        for (int k = 0; k < curves; ++k)
+            for (int i = 0; i < SamplesPerCurve; ++i)
+                fvec[k*SamplesPerCurve+i] = x[2*k]*std::exp(-x[2*k+1]*t(i)) + x[2*curves] - y(k,i);
+        return 0;
+    }
+
+    struct block_functor
+    {
+        block_functor(const sparse_exp_functor &f, const VectorXd &x) : f(f), x(x) {}
+        int operator()(Index b, MatrixXd &jac) const
+        {
+            const int k = int(b) / (SamplesPerCurve/RowsPerBlock);
+            const int i0 = (int(b) % (SamplesPerCurve/RowsPerBlock)) * RowsPerBlock;
+            for (int r = 0; r < RowsPerBlock; ++r)
+            {
+                double e = std::exp(-x[2*k+1]*t(i0+r));
+                jac(r,0) = e;
+                jac(r,1) = -x[2*k]*t(i0+r)*e;
+                jac(r,2) = 1.;
+            }
+            return 0;
+        }
+        const sparse_exp_functor &f;
+        const VectorXd &x;
+    };
+
+    int df(const VectorXd &x, JacobianType &fjac)
+    {
+        if (useBlocks)
+        {
+            block_functor func(*this, x);
+            return blocks.assemble(func, fjac);
+        }
+        std::vector<Triplet<double> > triplets;
+        for (int k = 0; k < curves; ++k)
+            for (int i = 0; i < SamplesPerCurve; ++i)
+            {
+                double e = std::exp(-x[2*k+1]*t(i));
+                triplets.push_back(Triplet<double>(k*SamplesPerCurve+i, 2*k, e));
+                triplets.push_back(Triplet<double>(k*SamplesPerCurve+i, 2*k+1, -x[2*k]*t(i)*e));
+                triplets.push_back(Triplet<double>(k*SamplesPerCurve+i, 2*curves, 1.));
+            }
+        fjac.resize(values(), inputs());
+        fjac.setFromTriplets(triplets.begin(), triplets.end());
+        fjac.makeCompressed();
+        return 0;
+    }
+
+    int curves;
+    bool useBlocks;
+    SparseBlockJacobian<double,int> blocks;
+};
+
+struct sparse_exp_normal_functor : sparse_exp_functor
+{
+    typedef SimplicialLDLT<JacobianType> QRSolver;
+    sparse_exp_normal_functor(int curves, bool withUnused, bool useBlocks)
+      : sparse_exp_functor(curves, withUnused, useBlocks) {}
+};
+
+template<typename Functor>
+void testSparseExp(int curves, bool withUnused, bool useBlocks)
+{
+  Functor functor(curves, withUnused, useBlocks);
+  VectorXd x = VectorXd::Ones(functor.inputs());
+  LevenbergMarquardt<Functor> lm(functor);
+  lm.minimize(x);
+
+  VERIFY_IS_EQUAL(lm.info(), Success);
+  VERIFY(lm.fvec().norm() < 1e-10);
+  for (int k = 0; k < curves; ++k)
+  {
+    VERIFY_IS_APPROX(x[2*k], 1.+0.1*(k%7));
+    VERIFY_IS_APPROX(x[2*k+1], 0.5+0.01*(k%11));
+  }
+  VERIFY_IS_APPROX(x[2*curves], 0.3);
+}
+
+void testSparseBlockJacobian()
+{
+  sparse_exp_functor functor(10, false, false);
+  VectorXd x = VectorXd::Random(functor.inputs());
+  sparse_exp_functor::JacobianType ref, fjac;
+  functor.df(x, ref);
+  functor.useBlocks = true;
+  // twice, to check that the second call reuses the pattern
+  VERIFY_IS_EQUAL(functor.df(x, fjac), 0);
+  VERIFY_IS_EQUAL(functor.df(x, fjac), 0);
+  VERIFY_IS_EQUAL(fjac.nonZeros(), ref.nonZeros());
+  VERIFY_IS_APPROX(MatrixXd(fjac), MatrixXd(ref));
+}
+
 EIGEN_DECLARE_TEST(levenberg_marquardt)
 {
     // Tests using the examples provided by (c)minpack
@@ -1455,6 +1566,14 @@ EIGEN_DECLARE_TEST(levenberg_marquardt)
 //     CALL_SUBTEST(testLmstr());
     CALL_SUBTEST(testLmdif());
 
+    // Sparse jacobians, factorized by QR or through the normal equations
+    CALL_SUBTEST(testSparseBlockJacobian());
+    CALL_SUBTEST(testSparseExp<sparse_exp_functor>(20, false, false));
+    CALL_SUBTEST(testSparseExp<sparse_exp_functor>(20, false, true));
+    CALL_SUBTEST(testSparseExp<sparse_exp_normal_functor>(200, false, false));
+    CALL_SUBTEST(testSparseExp<sparse_exp_normal_functor>(200, false, true));
+    CALL_SUBTEST(testSparseExp<sparse_exp_normal_functor>(200, true, true));
+
     // NIST tests, level of difficulty = "Lower"
     CALL_SUBTEST(testNistMisra1a());
     CALL_SUBTEST(testNistChwirut2());
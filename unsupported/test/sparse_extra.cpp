@@ -158,6 +158,199 @@ void check_marketio()
   VERIFY_IS_EQUAL(DenseMatrix(m1),DenseMatrix(m2));
 }
 
+template<typename Scalar, int Options, int BlockSize>
+void check_block_sparse(Index blockSize)
+{
+  typedef Matrix<Scalar, Dynamic, Dynamic> DenseMatrix;
+  typedef SparseMatrix<Scalar, Options> SpMat;
+  typedef BlockSparseMatrix<Scalar, BlockSize, Options> BlockMat;
+  const Index brows = internal::random<Index>(1,30);
+  const Index bcols = internal::random<Index>(1,30);
+  const Index rows = brows*blockSize, cols = bcols*blockSize;
+
+  DenseMatrix dm = DenseMatrix::Zero(rows, cols);
+  SpMat sm(rows, cols);
+  initSparse<Scalar>(0.1, dm, sm);
+
+  // conversions
+  BlockMat bm(brows, bcols);
+  bm.setBlockSize(blockSize);
+  bm = sm;
+  VERIFY_IS_EQUAL(bm.rows(), rows);
+  VERIFY_IS_EQUAL(bm.cols(), cols);
+  SpMat sm2 = bm.toSparseMatrix();
+  VERIFY(sm2.nonZeros() >= sm.nonZeros());
+  VERIFY_IS_EQUAL(DenseMatrix(sm2), dm);
+  BlockMat bm2(bm);
+  VERIFY_IS_EQUAL(DenseMatrix(bm2.toSparseMatrix()), dm);
+
+  // SpMV and SpMM
+  Matrix<Scalar,Dynamic,1> x = Matrix<Scalar,Dynamic,1>::Random(cols);
+  Matrix<Scalar,Dynamic,1> y = bm * x;
+  VERIFY_IS_APPROX(y, dm * x);
+  const Index nrhs = internal::random<Index>(1,9);
+  DenseMatrix X = DenseMatrix::Random(cols, nrhs);
+  DenseMatrix Y = bm * X;
+  VERIFY_IS_APPROX(Y, dm * X);
+  DenseMatrix Y2 = DenseMatrix::Random(rows, nrhs);
+  DenseMatrix refY2 = Y2 + Scalar(2) * dm * X;
+  (bm * X).scaleAndAddTo(Y2, Scalar(2));
+  VERIFY_IS_APPROX(Y2, refY2);
+}
+
+template<typename Scalar, int Options>
+void check_variable_block_sparse()
+{
+  typedef Matrix<Scalar, Dynamic, Dynamic> DenseMatrix;
+  typedef BlockSparseMatrix<Scalar, Dynamic, Options> BlockMat;
+  const Index brows = internal::random<Index>(1,10);
+  const Index bcols = internal::random<Index>(1,10);
+  VectorXi rowBlocks(brows), colBlocks(bcols);
+  for(Index bi = 0; bi < brows; ++bi) rowBlocks(bi) = internal::random<int>(1,4);
+  for(Index bj = 0; bj < bcols; ++bj) colBlocks(bj) = internal::random<int>(1,4);
+  const Index rows = rowBlocks.sum(), cols = colBlocks.sum();
+
+  // one block per block column, and one per block row
+  std::vector<Triplet<DenseMatrix> > triplets;
+  DenseMatrix dm = DenseMatrix::Zero(rows, cols);
+  for(Index bi = 0; bi < brows; ++bi)
+    for(Index bj = 0; bj < bcols; ++bj)
+      if(bi % bcols == bj || bj % brows == bi)
+      {
+        DenseMatrix block = DenseMatrix::Random(rowBlocks(bi), colBlocks(bj));
+        triplets.push_back(Triplet<DenseMatrix>(bi, bj, block));
+        dm.block(rowBlocks.head(bi).sum(), colBlocks.head(bj).sum(), rowBlocks(bi), colBlocks(bj)) = block;
+      }
+  BlockMat bm(brows, bcols);
+  bm.setFromTriplets(triplets.begin(), triplets.end());
+  VERIFY_IS_EQUAL(bm.rows(), rows);
+  VERIFY_IS_EQUAL(bm.cols(), cols);
+  VERIFY_IS_EQUAL(DenseMatrix(bm.toSparseMatrix()), dm);
+
+  DenseMatrix X = DenseMatrix::Random(cols, internal::random<Index>(1,5));
+  DenseMatrix Y = bm * X;
+  VERIFY_IS_APPROX(Y, dm * X);
+}
+
+template<typename Scalar, int Options>
+void check_concurrent_builder()
+{
+  typedef SparseMatrix<Scalar,Options> SparseMatrixType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  const Index rows = internal::random<Index>(1,200);
+  const Index cols = internal::random<Index>(1,200);
+  const Index slots = internal::random<Index>(1,4);
+  const int n = internal::random<int>(0,int(rows*cols));
+  DenseMatrix ref = DenseMatrix::Zero(rows,cols);
+
+  // explicit slots, duplicates across and within slots
+  ConcurrentSparseBuilder<SparseMatrixType> builder(rows, cols, slots);
+  for (int k=0; k<n; ++k)
+  {
+    Index i = internal::random<Index>(0,rows-1);
+    Index j = internal::random<Index>(0,cols-1);
+    Scalar v = internal::random<Scalar>();
+    builder.coeffRef(i, j, internal::random<Index>(0,slots-1)) += v;
+    ref(i,j) += v;
+  }
+  VERIFY(builder.nonZeros() <= n);
+  SparseMatrixType m;
+  builder.finalize(m);
+  VERIFY(m.isCompressed());
+  VERIFY_IS_APPROX(DenseMatrix(m), ref);
+  VERIFY_IS_EQUAL(builder.nonZeros(), 0);
+
+  // concurrent assembly, every coefficient is added once per row block
+  ConcurrentSparseBuilder<SparseMatrixType> parallelBuilder(rows, cols);
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for
+#endif
+  for (int i=0; i<int(rows); ++i)
+    for (Index j=i%3; j<cols; j+=3)
+    {
+      parallelBuilder.add(i, j, Scalar(i+1));
+      parallelBuilder.add(rows-1-i, j, Scalar(j+1));
+    }
+  ref.setZero();
+  for (Index i=0; i<rows; ++i)
+    for (Index j=i%3; j<cols; j+=3)
+    {
+      ref(i,j) += Scalar(i+1);
+      ref(rows-1-i,j) += Scalar(j+1);
+    }
+  parallelBuilder.finalize(m);
+  VERIFY_IS_APPROX(DenseMatrix(m), ref);
+}
+
+// element matrices of a 1D chain of elements with 3 nodes each, overlapping on their end nodes
+template<typename Scalar>
+struct chain_element_functor
+{
+  template<typename ElementMatrixType>
+  void operator()(Index e, ElementMatrixType& local) const
+  {
+    local.resize(3,3);
+    for (Index j=0; j<3; ++j)
+      for (Index i=0; i<3; ++i)
+        local(i,j) = Scalar(Scalar(e+1) + Scalar(3*j+i));
+  }
+};
+
+template<typename Scalar, int Options>
+void check_scatter_map()
+{
+  typedef SparseMatrix<Scalar,Options> SparseMatrixType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  const Index nbElements = internal::random<Index>(1,50);
+  const Index n = 2*nbElements+1;
+  std::vector<std::vector<int> > dofs(nbElements);
+  std::vector<Triplet<Scalar> > pattern;
+  for (Index e=0; e<nbElements; ++e)
+  {
+    for (int k=0; k<3; ++k)
+      dofs[e].push_back(int(2*e+k));
+    std::swap(dofs[e][0], dofs[e][internal::random<int>(0,2)]);
+    for (int i=0; i<3; ++i)
+      for (int j=0; j<3; ++j)
+        pattern.push_back(Triplet<Scalar>(dofs[e][i], dofs[e][j], 0));
+  }
+  SparseMatrixType A(n,n);
+  A.setFromTriplets(pattern.begin(), pattern.end());
+  const Index nnz = A.nonZeros();
+
+  SparseScatterMap<SparseMatrixType> map(A);
+  for (Index e=0; e<nbElements; ++e)
+    VERIFY_IS_EQUAL(map.addElement(dofs[e], dofs[e]), e);
+  VERIFY_IS_EQUAL(map.elements(), nbElements);
+
+  chain_element_functor<Scalar> func;
+  DenseMatrix ref = DenseMatrix::Zero(n,n);
+  typename SparseScatterMap<SparseMatrixType>::ElementMatrixType local;
+  for (Index e=0; e<nbElements; ++e)
+  {
+    func(e, local);
+    for (Index i=0; i<3; ++i)
+      for (Index j=0; j<3; ++j)
+        ref(dofs[e][i], dofs[e][j]) += local(i,j);
+    map.scatterAdd(e, local, A);
+  }
+  VERIFY_IS_APPROX(DenseMatrix(A), ref);
+
+  // consecutive elements share a node, so two colors are enough
+  map.computeColoring();
+  VERIFY_IS_EQUAL(map.colors(), nbElements>1 ? 2 : 1);
+  Index count = 0;
+  for (Index c=0; c<map.colors(); ++c)
+    count += static_cast<Index>(map.elementsOfColor(c).size());
+  VERIFY_IS_EQUAL(count, nbElements);
+
+  // re-assembly resets the values and keeps the pattern
+  A.coeffs().setRandom();
+  map.assemble(A, func);
+  VERIFY_IS_EQUAL(A.nonZeros(), nnz);
+  VERIFY_IS_APPROX(DenseMatrix(A), ref);
+}
+
 EIGEN_DECLARE_TEST(sparse_extra)
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -181,6 +374,21 @@ EIGEN_DECLARE_TEST(sparse_extra)
     CALL_SUBTEST_4( (check_marketio<SparseMatrix<double,ColMajor,long int> >()) );
     CALL_SUBTEST_4( (check_marketio<SparseMatrix<std::complex<float>,ColMajor,long int> >()) );
     CALL_SUBTEST_4( (check_marketio<SparseMatrix<std::complex<double>,ColMajor,long int> >()) );
+
+    CALL_SUBTEST_5( (check_block_sparse<double,ColMajor,3>(3)) );
+    CALL_SUBTEST_5( (check_block_sparse<double,RowMajor,4>(4)) );
+    CALL_SUBTEST_5( (check_block_sparse<double,RowMajor,Dynamic>(internal::random<int>(1,9))) );
+    CALL_SUBTEST_5( (check_block_sparse<double,ColMajor,Dynamic>(internal::random<int>(1,9))) );
+    CALL_SUBTEST_5( (check_block_sparse<std::complex<double>,RowMajor,Dynamic>(2)) );
+    CALL_SUBTEST_5( (check_variable_block_sparse<double,ColMajor>()) );
+    CALL_SUBTEST_5( (check_variable_block_sparse<double,RowMajor>()) );
+
+    CALL_SUBTEST_6( (check_concurrent_builder<double,ColMajor>()) );
+    CALL_SUBTEST_6( (check_concurrent_builder<double,RowMajor>()) );
+    CALL_SUBTEST_6( (check_concurrent_builder<std::complex<double>,ColMajor>()) );
+
+    CALL_SUBTEST_7( (check_scatter_map<double,ColMajor>()) );
+    CALL_SUBTEST_7( (check_scatter_map<float,RowMajor>()) );
     TEST_SET_BUT_UNUSED_VARIABLE(s);
   }
 }
@@ -24,6 +24,62 @@ void verify_component_wise(const X& x, const Y& y)
   }
 }
 
+// Checks that the vectorized implementations agree with the scalar ones, using
+// an absolute error bound where the result is close to zero.
+template<typename X, typename Y>
+void verify_close_to_scalar(const X& x, const Y& y)
+{
+  typedef typename X::Scalar Scalar;
+  const Scalar tol = NumTraits<Scalar>::dummy_precision();
+  for(Index i=0; i<x.size(); ++i)
+  {
+    if((numext::isfinite)(y(i)))
+      VERIFY(numext::abs(x(i) - y(i)) <= tol * numext::maxi(Scalar(1), numext::abs(y(i))));
+    else if((numext::isnan)(y(i)))
+      VERIFY((numext::isnan)(x(i)));
+    else
+      VERIFY_IS_EQUAL( x(i), y(i) );
+  }
+}
+
+template<typename ArrayType> void packet_special_functions()
+{
+  typedef typename ArrayType::Scalar Scalar;
+
+  Scalar plusinf = std::numeric_limits<Scalar>::infinity();
+  Scalar nan = std::numeric_limits<Scalar>::quiet_NaN();
+
+  // Random values of both signs spanning many orders of magnitude, followed by
+  // special values exercising the poles and the branches of the packet code.
+  const Index n = 1024;
+  ArrayType x(n+16);
+  for(Index i=0; i<n; ++i)
+    x(i) = internal::random<Scalar>(-1,1) * std::pow(Scalar(10), internal::random<Scalar>(-6,6));
+  x.tail(16) << Scalar(0), Scalar(-0.), Scalar(1), Scalar(2), Scalar(-1), Scalar(-2.5),
+                Scalar(0.5), Scalar(6.5), Scalar(10), Scalar(-1e-30), Scalar(1e-30),
+                (std::numeric_limits<Scalar>::min)() / Scalar(8), plusinf, -plusinf, nan,
+                Scalar(-1e6);
+
+  ArrayType res(x.size()), ref(x.size());
+#if EIGEN_HAS_C99_MATH
+  res = x.lgamma();
+  for(Index i=0; i<x.size(); ++i) ref(i) = numext::lgamma(x(i));
+  CALL_SUBTEST(verify_close_to_scalar(res, ref));
+
+  res = x.digamma();
+  for(Index i=0; i<x.size(); ++i) ref(i) = numext::digamma(x(i));
+  CALL_SUBTEST(verify_close_to_scalar(res, ref));
+#endif  // EIGEN_HAS_C99_MATH
+
+  res = i0e(x);
+  for(Index i=0; i<x.size(); ++i) ref(i) = numext::i0e(x(i));
+  CALL_SUBTEST(verify_close_to_scalar(res, ref));
+
+  res = i1e(x);
+  for(Index i=0; i<x.size(); ++i) ref(i) = numext::i1e(x(i));
+  CALL_SUBTEST(verify_close_to_scalar(res, ref));
+}
+
 template<typename ArrayType> void array_special_functions()
 {
   using std::abs;
@@ -476,4 +532,6 @@ EIGEN_DECLARE_TEST(special_functions)
 {
   CALL_SUBTEST_1(array_special_functions<ArrayXf>());
   CALL_SUBTEST_2(array_special_functions<ArrayXd>());
+  CALL_SUBTEST_1(packet_special_functions<ArrayXf>());
+  CALL_SUBTEST_2(packet_special_functions<ArrayXd>());
 }